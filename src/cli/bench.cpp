@@ -0,0 +1,667 @@
+/**
+ * benchmark suite
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#include "lib/trackgen.h"
+#include "lib/trackdb.h"
+#include "lib/map.h"
+#include "lib/calc.h"
+#include "common/types.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <numbers>
+#include <numeric>
+#include <algorithm>
+#include <optional>
+
+
+namespace fs = std::filesystem;
+
+using t_track = SingleTrack<t_real, t_size>;
+using t_tracks = MultipleTracks<t_real, t_size>;
+using t_map = Map<t_real_map, t_size_map>;
+using t_clk = std::chrono::steady_clock;
+
+
+
+/**
+ * timings of one benchmark
+ */
+struct BenchResult
+{
+	std::string name{};
+	std::string unit{};               // what is counted as an item
+	t_size items{};                   // items processed per iteration
+	std::vector<t_real> times{};      // durations of the iterations [s]
+	bool skipped{false};
+};
+
+
+
+/**
+ * benchmark configuration and collected results
+ */
+class Bench
+{
+public:
+	Bench(t_size iterations, t_size warmup, const std::string& filter)
+		: m_iterations{std::max<t_size>(iterations, 1)}, m_warmup{warmup}, m_filter{filter}
+	{}
+
+
+
+	bool IsSelected(const std::string& name) const
+	{
+		return m_filter == "" || name.find(m_filter) != std::string::npos;
+	}
+
+
+
+	/**
+	 * time a function processing the given number of items per call,
+	 * the function returns false in case of an error
+	 */
+	void Run(const std::string& name, const std::string& unit, t_size items,
+		const std::function<bool()>& func, std::optional<t_size> iterations = std::nullopt)
+	{
+		if(!IsSelected(name))
+			return;
+
+		std::cerr << "Running " << name << "..." << std::flush;
+
+		BenchResult result{ .name = name, .unit = unit, .items = items };
+		const t_size num_iterations = iterations ? std::max<t_size>(*iterations, 1) : m_iterations;
+		result.times.reserve(num_iterations);
+
+		for(t_size iter = 0; iter < m_warmup + num_iterations; ++iter)
+		{
+			auto start = t_clk::now();
+			bool ok = func();
+			auto stop = t_clk::now();
+
+			if(!ok)
+			{
+				result.skipped = true;
+				result.times.clear();
+				break;
+			}
+
+			if(iter >= m_warmup)
+				result.times.push_back(std::chrono::duration<t_real>(stop - start).count());
+		}
+
+		std::cerr << (result.skipped ? " skipped." : " done.") << std::endl;
+		m_results.emplace_back(std::move(result));
+	}
+
+
+
+	/**
+	 * the given setting will be written to the results
+	 */
+	void AddConfig(const std::string& key, const std::string& val)
+	{
+		m_config.emplace_back(std::make_pair(key, val));
+	}
+
+
+
+	/**
+	 * write the results as json
+	 */
+	void WriteJson(std::ostream& ostr) const
+	{
+		ostr.precision(9);
+		ostr << "{\n\t\"config\": {";
+
+		for(t_size idx = 0; idx < m_config.size(); ++idx)
+		{
+			ostr << (idx ? "," : "") << "\n\t\t\"" << m_config[idx].first
+				<< "\": \"" << m_config[idx].second << "\"";
+		}
+
+		ostr << "\n\t},\n\t\"benchmarks\": [";
+
+		for(t_size idx = 0; idx < m_results.size(); ++idx)
+		{
+			const BenchResult& result = m_results[idx];
+
+			ostr << (idx ? "," : "") << "\n\t\t{\n"
+				<< "\t\t\t\"name\": \"" << result.name << "\",\n"
+				<< "\t\t\t\"unit\": \"" << result.unit << "\",\n"
+				<< "\t\t\t\"items_per_iteration\": " << result.items << ",\n"
+				<< "\t\t\t\"skipped\": " << (result.skipped ? "true" : "false");
+
+			if(!result.skipped && result.times.size())
+			{
+				std::vector<t_real> times = result.times;
+				std::sort(times.begin(), times.end());
+
+				const t_real total = std::accumulate(times.begin(), times.end(), t_real(0));
+				const t_real mean = total / t_real(times.size());
+
+				ostr << ",\n"
+					<< "\t\t\t\"iterations\": " << times.size() << ",\n"
+					<< "\t\t\t\"throughput\": " << t_real(result.items) / mean << ",\n"
+					<< "\t\t\t\"latency_s\": {\n"
+					<< "\t\t\t\t\"min\": " << times.front() << ",\n"
+					<< "\t\t\t\t\"mean\": " << mean << ",\n"
+					<< "\t\t\t\t\"p50\": " << GetPercentile(times, 0.5) << ",\n"
+					<< "\t\t\t\t\"p90\": " << GetPercentile(times, 0.9) << ",\n"
+					<< "\t\t\t\t\"p99\": " << GetPercentile(times, 0.99) << ",\n"
+					<< "\t\t\t\t\"max\": " << times.back() << "\n"
+					<< "\t\t\t}";
+			}
+
+			ostr << "\n\t\t}";
+		}
+
+		ostr << "\n\t]\n}" << std::endl;
+	}
+
+
+
+protected:
+	/**
+	 * percentile of sorted values, interpolating between neighbours
+	 */
+	static t_real GetPercentile(const std::vector<t_real>& sorted, t_real frac)
+	{
+		if(sorted.size() == 0)
+			return 0.;
+
+		const t_real pos = frac * t_real(sorted.size() - 1);
+		const t_size idx = static_cast<t_size>(pos);
+		if(idx + 1 >= sorted.size())
+			return sorted.back();
+
+		return std::lerp(sorted[idx], sorted[idx + 1], pos - t_real(idx));
+	}
+
+
+
+private:
+	t_size m_iterations{10};
+	t_size m_warmup{1};
+	std::string m_filter{};
+
+	std::vector<std::pair<std::string, std::string>> m_config{};
+	std::vector<BenchResult> m_results{};
+};
+
+
+
+/**
+ * write an osm file with a grid of streets and buildings around the given position [deg]
+ */
+static bool write_synthetic_map(const fs::path& file, t_real lon, t_real lat, t_size grid)
+{
+	namespace num = std::numbers;
+
+	std::ofstream ofstr{file};
+	if(!ofstr)
+		return false;
+
+	// spacing of the street grid [deg]
+	const t_real step_lat = 100. / earth_radius<t_real>(lat / 180. * num::pi) / num::pi * 180.;
+	const t_real step_lon = step_lat / std::cos(lat / 180. * num::pi);
+	const t_real lon0 = lon - t_real(grid) * step_lon * 0.5;
+	const t_real lat0 = lat - t_real(grid) * step_lat * 0.5;
+
+	ofstr.precision(10);
+	ofstr << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		<< "<osm version=\"0.6\" generator=\"tracks_bench\">\n";
+
+	t_size node_id = 1, way_id = 1;
+	auto write_node = [&ofstr, &node_id](t_real node_lon, t_real node_lat) -> t_size
+	{
+		ofstr << "\t<node id=\"" << node_id << "\" lat=\"" << node_lat
+			<< "\" lon=\"" << node_lon << "\"/>\n";
+		return node_id++;
+	};
+
+	// street crossings
+	std::vector<t_size> crossings;
+	crossings.reserve(grid * grid);
+	for(t_size y = 0; y < grid; ++y)
+		for(t_size x = 0; x < grid; ++x)
+			crossings.push_back(write_node(lon0 + t_real(x)*step_lon, lat0 + t_real(y)*step_lat));
+
+	// building corners inside the blocks
+	std::vector<std::vector<t_size>> buildings;
+	for(t_size y = 0; y + 1 < grid; ++y)
+	{
+		for(t_size x = 0; x + 1 < grid; ++x)
+		{
+			const t_real bx = lon0 + (t_real(x) + 0.3) * step_lon;
+			const t_real by = lat0 + (t_real(y) + 0.3) * step_lat;
+			const t_real bw = 0.4 * step_lon, bh = 0.4 * step_lat;
+
+			t_size first = write_node(bx, by);
+			write_node(bx + bw, by);
+			write_node(bx + bw, by + bh);
+			write_node(bx, by + bh);
+			buildings.emplace_back(std::vector<t_size>{ first, first + 1, first + 2, first + 3, first });
+		}
+	}
+
+	auto write_way = [&ofstr, &way_id](const std::vector<t_size>& nodes,
+		const std::string& key, const std::string& val)
+	{
+		ofstr << "\t<way id=\"" << way_id++ << "\">\n";
+		for(t_size node : nodes)
+			ofstr << "\t\t<nd ref=\"" << node << "\"/>\n";
+		ofstr << "\t\t<tag k=\"" << key << "\" v=\"" << val << "\"/>\n\t</way>\n";
+	};
+
+	// streets along both grid directions
+	for(t_size line = 0; line < grid; ++line)
+	{
+		std::vector<t_size> row, col;
+		for(t_size pos = 0; pos < grid; ++pos)
+		{
+			row.push_back(crossings[line*grid + pos]);
+			col.push_back(crossings[pos*grid + line]);
+		}
+
+		const std::string type = line % 10 == 0 ? "primary" : "residential";
+		write_way(row, "highway", type);
+		write_way(col, "highway", type);
+	}
+
+	for(t_size idx = 0; idx < buildings.size(); ++idx)
+		write_way(buildings[idx], idx % 7 == 0 ? "landuse" : "building", idx % 7 == 0 ? "grass" : "yes");
+
+	ofstr << "</osm>\n";
+	return static_cast<bool>(ofstr);
+}
+
+
+
+int main(int argc, char **argv)
+{
+	namespace num = std::numbers;
+
+	t_size num_tracks = 50, num_points = 3600;
+	t_size iterations = 10, warmup = 1, map_grid = 100;
+	std::uint64_t seed = 1;
+	std::string filter, map_file, out_file;
+	unsigned int num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string arg{argv[i]};
+
+		if(arg == "--tracks" && i + 1 < argc)
+			num_tracks = std::max<t_size>(std::stoul(argv[++i]), 1);
+		else if(arg == "--points" && i + 1 < argc)
+			num_points = std::stoul(argv[++i]);
+		else if(arg == "--iterations" && i + 1 < argc)
+			iterations = std::stoul(argv[++i]);
+		else if(arg == "--warmup" && i + 1 < argc)
+			warmup = std::stoul(argv[++i]);
+		else if(arg == "--threads" && i + 1 < argc)
+			num_threads = std::max(static_cast<unsigned int>(std::stoul(argv[++i])), 1u);
+		else if(arg == "--seed" && i + 1 < argc)
+			seed = std::stoull(argv[++i]);
+		else if(arg == "--filter" && i + 1 < argc)
+			filter = argv[++i];
+		else if(arg == "--map" && i + 1 < argc)
+			map_file = argv[++i];
+		else if(arg == "--map-grid" && i + 1 < argc)
+			map_grid = std::max<t_size>(std::stoul(argv[++i]), 2);
+		else if(arg == "--out" && i + 1 < argc)
+			out_file = argv[++i];
+		else
+		{
+			std::cerr << "Unknown argument \"" << arg << "\".\n"
+				<< "Options:\n"
+				<< "\t--tracks 50       \tnumber of synthetic tracks\n"
+				<< "\t--points 3600     \tmean number of points per track\n"
+				<< "\t--iterations 10   \tnumber of timed iterations\n"
+				<< "\t--warmup 1        \tnumber of untimed iterations\n"
+				<< "\t--threads <n>     \tnumber of threads\n"
+				<< "\t--seed 1          \tseed for the random number generator\n"
+				<< "\t--filter <name>   \tonly run benchmarks containing this name\n"
+				<< "\t--map <file>      \tosm or pbf map to use instead of a synthetic one\n"
+				<< "\t--map-grid 100    \tnumber of streets of the synthetic map\n"
+				<< "\t--out <file>      \twrite json results to a file instead of stdout\n"
+				<< std::endl;
+			return -1;
+		}
+	}
+
+	const t_real lon = 11.5, lat = 48.1;
+
+	Bench bench{iterations, warmup, filter};
+	bench.AddConfig("tracks", std::to_string(num_tracks));
+	bench.AddConfig("points", std::to_string(num_points));
+	bench.AddConfig("threads", std::to_string(num_threads));
+	bench.AddConfig("seed", std::to_string(seed));
+	bench.AddConfig("map", map_file == "" ? "synthetic " + std::to_string(map_grid) : map_file);
+
+	// directory for temporary files
+	const fs::path tmp_dir = fs::temp_directory_path()
+		/ ("tracks_bench_" + std::to_string(std::random_device{}()));
+
+	try
+	{
+		fs::create_directories(tmp_dir);
+
+		// ---------------------------------------------------------------------
+		// input data
+		// ---------------------------------------------------------------------
+		std::cerr << "Generating input data..." << std::endl;
+
+		TrackGenerator<t_real, t_size> gen;
+		gen.SetSeed(seed);
+		gen.SetArea(lon / 180. * num::pi, lat / 180. * num::pi, 5000.);
+		gen.SetPointsPerTrack(num_points);
+		gen.SetNumRoutes(std::max<t_size>(num_tracks / 5, 1));
+
+		t_tracks tracks;
+		tracks.SetNumThreads(num_threads);
+		t_size total_points = 0;
+		for(t_size trackidx = 0; trackidx < num_tracks; ++trackidx)
+		{
+			t_track track = gen.Generate(trackidx);
+			total_points += track.GetPoints().size();
+			tracks.EmplaceTrack(std::move(track));
+		}
+
+		const t_track& track = *tracks.GetTrack(0);
+		const t_size track_points = track.GetPoints().size();
+
+		const fs::path gpx_file = tmp_dir / track.GetFileName();
+		if(!track.ExportGpx(gpx_file.string()))
+			throw std::runtime_error("Could not write " + gpx_file.string() + ".");
+
+		// random coordinate pairs [rad]
+		const t_size num_pairs = 100000;
+		std::vector<std::array<t_real, 6>> pairs;
+		pairs.reserve(num_pairs);
+		{
+			std::mt19937_64 rng{seed};
+			std::uniform_real_distribution<t_real> coord{-0.01, 0.01};
+			std::uniform_real_distribution<t_real> elev{0., 1000.};
+
+			for(t_size idx = 0; idx < num_pairs; ++idx)
+			{
+				const t_real lat1 = lat / 180. * num::pi + coord(rng);
+				const t_real lon1 = lon / 180. * num::pi + coord(rng);
+				pairs.emplace_back(std::array<t_real, 6>{
+					lat1, lat1 + coord(rng)*0.01, lon1, lon1 + coord(rng)*0.01, elev(rng), elev(rng) });
+			}
+		}
+
+		// the sum of all results keeps the compiler from removing the calculations
+		volatile t_real sink = 0.;
+
+		// ---------------------------------------------------------------------
+		// distance calculations
+		// ---------------------------------------------------------------------
+		auto bench_dist = [&bench, &pairs, &sink](const std::string& name,
+			std::tuple<t_real, t_real> (*dist_func)(t_real, t_real, t_real, t_real, t_real, t_real))
+		{
+			bench.Run(name, "calls", pairs.size(), [&pairs, &sink, dist_func]() -> bool
+			{
+				t_real sum = 0.;
+				for(const auto& pair : pairs)
+					sum += std::get<0>(dist_func(pair[0], pair[1], pair[2], pair[3], pair[4], pair[5]));
+				sink = sink + sum;
+				return true;
+			});
+		};
+
+		bench_dist("geo_dist", &geo_dist<t_real>);
+		bench_dist("geo_dist_2/haversine", &geo_dist_2<t_real, 0>);
+		bench_dist("geo_dist_2/thomas", &geo_dist_2<t_real, 1>);
+		bench_dist("geo_dist_2/vincenty", &geo_dist_2<t_real, 2>);
+#if BOOST_VERSION > 107400
+		bench_dist("geo_dist_2/karney", &geo_dist_2<t_real, 3>);
+#endif
+
+		// ---------------------------------------------------------------------
+		// smoothing
+		// ---------------------------------------------------------------------
+		{
+			std::vector<t_real> elevations;
+			elevations.reserve(track_points);
+			for(const auto& pt : track.GetPoints())
+				elevations.push_back(pt.elevation);
+
+			for(int N : { 1, 8 })
+			{
+				bench.Run("smooth_data/N=" + std::to_string(N), "points", elevations.size(),
+					[&elevations, &sink, N]() -> bool
+				{
+					std::vector<t_real> smoothed = smooth_data(elevations, N);
+					sink = sink + smoothed.back();
+					return true;
+				});
+			}
+		}
+
+		// ---------------------------------------------------------------------
+		// single track
+		// ---------------------------------------------------------------------
+		bench.Run("SingleTrack::Import", "points", track_points, [&gpx_file]() -> bool
+		{
+			t_track imported;
+			return imported.Import(gpx_file.string());
+		});
+
+		{
+			t_track calc_track = track;
+			bench.Run("SingleTrack::Calculate", "points", track_points, [&calc_track]() -> bool
+			{
+				calc_track.Calculate();
+				return true;
+			});
+		}
+
+		{
+			// query positions near the track
+			const t_size num_queries = 1000;
+			std::vector<std::pair<t_real, t_real>> queries;
+			queries.reserve(num_queries);
+
+			std::mt19937_64 rng{seed};
+			std::uniform_int_distribution<t_size> idx_dist{0, track_points - 1};
+			std::normal_distribution<t_real> offs{0., 0.00001};
+			for(t_size idx = 0; idx < num_queries; ++idx)
+			{
+				const auto& pt = track.GetPoints()[idx_dist(rng)];
+				queries.emplace_back(std::make_pair(pt.longitude + offs(rng), pt.latitude + offs(rng)));
+			}
+
+			bench.Run("SingleTrack::GetClosestPoint", "queries", num_queries, [&track, &queries, &sink]() -> bool
+			{
+				t_real sum = 0.;
+				for(const auto& [ query_lon, query_lat ] : queries)
+				{
+					if(const auto *pt = track.GetClosestPoint(query_lon, query_lat))
+						sum += pt->elevation;
+				}
+				sink = sink + sum;
+				return true;
+			});
+		}
+
+		bench.Run("SingleTrack::GetTimePerDistance", "points", track_points, [&track, &sink]() -> bool
+		{
+			auto [ times, dists ] = track.GetTimePerDistance(100.);
+			sink = sink + t_real(times.size());
+			return true;
+		});
+
+		// ---------------------------------------------------------------------
+		// track database
+		// ---------------------------------------------------------------------
+		const fs::path db_file = tmp_dir / "bench.tracks";
+
+		bench.Run("MultipleTracks::Save", "points", total_points, [&tracks, &db_file]() -> bool
+		{
+			return tracks.Save(db_file.string());
+		});
+
+		if(!fs::exists(db_file) && !tracks.Save(db_file.string()))
+			throw std::runtime_error("Could not write " + db_file.string() + ".");
+
+		bench.Run("MultipleTracks::Load", "points", total_points, [&db_file, num_threads]() -> bool
+		{
+			t_tracks loaded;
+			loaded.SetNumThreads(num_threads);
+			return loaded.Load(db_file.string());
+		});
+
+		bench.Run("MultipleTracks::GetDistancePerPeriod", "tracks", num_tracks, [&tracks, &sink]() -> bool
+		{
+			auto dists = tracks.GetDistancePerPeriod();
+			sink = sink + t_real(dists.size());
+			return true;
+		});
+
+		// ---------------------------------------------------------------------
+		// map
+		// ---------------------------------------------------------------------
+		if(map_file == "")
+		{
+			const fs::path synth_map = tmp_dir / "bench.osm";
+			if(!write_synthetic_map(synth_map, lon, lat, map_grid))
+				throw std::runtime_error("Could not write " + synth_map.string() + ".");
+			map_file = synth_map.string();
+		}
+
+		const t_size map_bytes = fs::file_size(map_file);
+		const bool is_xml = fs::path{map_file}.extension() == ".osm";
+
+		if(is_xml)
+		{
+			bench.Run("Map::ImportXml", "bytes", map_bytes, [&map_file]() -> bool
+			{
+				t_map map;
+				return map.ImportXml(map_file);
+			});
+		}
+
+		bench.Run("Map::Import", "bytes", map_bytes, [&map_file, num_threads]() -> bool
+		{
+			t_map map;
+			map.SetNumThreads(num_threads);
+			return map.Import(map_file, -180., 180., -90., 90.);
+		});
+
+		bench.Run("Map::Import two-pass", "bytes", map_bytes, [&map_file, num_threads]() -> bool
+		{
+			t_map map;
+			map.SetNumThreads(num_threads);
+			map.SetTwoPassImport(true);
+			return map.Import(map_file, -180., 180., -90., 90.);
+		});
+
+		{
+			t_map map;
+			map.SetNumThreads(num_threads);
+			bool map_ok = is_xml
+				? map.ImportXml(map_file)
+				: map.Import(map_file, -180., 180., -90., 90.);
+
+			bench.Run("Map::ExportSvg", "bytes", map_bytes, [&map, &sink, map_ok]() -> bool
+			{
+				if(!map_ok)
+					return false;
+
+				std::ostringstream ostr;
+				if(!map.ExportSvg(ostr))
+					return false;
+				sink = sink + t_real(ostr.tellp());
+				return true;
+			});
+
+			bench.Run("Map::ExportSvg viewport", "bytes", map_bytes, [&map, &sink, map_ok]() -> bool
+			{
+				if(!map_ok)
+					return false;
+
+				// central tenth of the map in each direction
+				auto [ min_lon, max_lon, min_lat, max_lat ] = map.GetBounds();
+				const t_real lon = (min_lon + max_lon) / 2., lat = (min_lat + max_lat) / 2.;
+				const t_real lon_range = (max_lon - min_lon) / 20., lat_range = (max_lat - min_lat) / 20.;
+
+				std::ostringstream ostr;
+				if(!map.ExportSvg(ostr, 1., lon - lon_range, lon + lon_range, lat - lat_range, lat + lat_range))
+					return false;
+				sink = sink + t_real(ostr.tellp());
+				return true;
+			});
+
+			const fs::path flat_file = tmp_dir / "bench.trackmap";
+			bench.Run("Map::Save", "bytes", map_bytes, [&map, &flat_file, map_ok]() -> bool
+			{
+				return map_ok && map.Save(flat_file.string());
+			});
+
+			bench.Run("Map::Load", "bytes", map_bytes, [&flat_file, map_ok]() -> bool
+			{
+				t_map loaded;
+				return map_ok && loaded.Load(flat_file.string());
+			});
+
+			const fs::path tile_dir = tmp_dir / "tiles";
+			bench.Run("Map::SaveTiles", "bytes", map_bytes, [&map, &tile_dir, map_ok]() -> bool
+			{
+				return map_ok && map.SaveTiles(tile_dir.string());
+			});
+
+			bench.Run("Map::LoadTiles", "bytes", map_bytes, [&map, &tile_dir, map_ok]() -> bool
+			{
+				if(!map_ok)
+					return false;
+
+				auto [ min_lon, max_lon, min_lat, max_lat ] = map.GetBounds();
+
+				t_map tiles;
+				return tiles.LoadTiles(tile_dir.string(), min_lon, max_lon, min_lat, max_lat);
+			});
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		fs::remove_all(tmp_dir);
+		return -1;
+	}
+
+	fs::remove_all(tmp_dir);
+
+	// results
+	if(out_file == "")
+	{
+		bench.WriteJson(std::cout);
+	}
+	else
+	{
+		std::ofstream ofstr{out_file};
+		if(!ofstr)
+		{
+			std::cerr << "Could not write " << out_file << "." << std::endl;
+			return -1;
+		}
+
+		bench.WriteJson(ofstr);
+	}
+
+	return 0;
+}
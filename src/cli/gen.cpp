@@ -0,0 +1,194 @@
+/**
+ * synthetic track database generator
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#include "lib/trackgen.h"
+#include "lib/trackdb.h"
+#include "lib/profile.h"
+#include "common/types.h"
+
+#include <boost/asio.hpp>
+
+#include <optional>
+#include <numbers>
+#include <cmath>
+
+
+namespace fs = std::filesystem;
+
+
+int main(int argc, char **argv)
+{
+	if(argc <= 1)
+	{
+		std::cerr << "Please give a .tracks output file or a gpx output directory.\n"
+			<< "Options:\n"
+			<< "\t--db <file>       \twrite a .tracks database\n"
+			<< "\t--gpx <dir>       \twrite .gpx files into a directory\n"
+			<< "\t--tracks 100      \tnumber of tracks\n"
+			<< "\t--points 3600     \tmean number of points per track\n"
+			<< "\t--dt 1            \ttime between points [s]\n"
+			<< "\t--speed 3         \tmean speed [m/s]\n"
+			<< "\t--noise 3         \tposition noise [m]\n"
+			<< "\t--reuse 0.8       \tfraction of tracks running on a previous route\n"
+			<< "\t--area 11.5 48.1 5\tcentre longitude and latitude [deg] and radius [km]\n"
+			<< "\t--seed 1          \tseed for the random number generator\n"
+			<< "\t--profile         \tprint the timings of the processing stages\n"
+			<< "\t--trace <file>    \twrite a chrome trace of the processing stages\n"
+			<< std::endl;
+		return -1;
+	}
+
+	namespace num = std::numbers;
+
+	std::optional<fs::path> db_file, gpx_dir;
+	t_size num_tracks = 100, num_points = 3600;
+	t_real dt = 1., speed = 3., noise = 3., reuse = 0.8;
+	t_real lon = 11.5, lat = 48.1, radius = 5.;
+	std::uint64_t seed = 1;
+	bool do_profile = false;
+	std::optional<fs::path> trace_file;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string arg{argv[i]};
+
+		if(arg == "--db" && i + 1 < argc)
+			db_file = argv[++i];
+		else if(arg == "--gpx" && i + 1 < argc)
+			gpx_dir = argv[++i];
+		else if(arg == "--tracks" && i + 1 < argc)
+			num_tracks = std::stoul(argv[++i]);
+		else if(arg == "--points" && i + 1 < argc)
+			num_points = std::stoul(argv[++i]);
+		else if(arg == "--dt" && i + 1 < argc)
+			dt = std::stod(argv[++i]);
+		else if(arg == "--speed" && i + 1 < argc)
+			speed = std::stod(argv[++i]);
+		else if(arg == "--noise" && i + 1 < argc)
+			noise = std::stod(argv[++i]);
+		else if(arg == "--reuse" && i + 1 < argc)
+			reuse = std::clamp(std::stod(argv[++i]), 0., 1.);
+		else if(arg == "--seed" && i + 1 < argc)
+			seed = std::stoull(argv[++i]);
+		else if(arg == "--profile")
+			do_profile = true;
+		else if(arg == "--trace" && i + 1 < argc)
+			trace_file = argv[++i];
+		else if(arg == "--area" && i + 3 < argc)
+		{
+			lon = std::stod(argv[i+1]);
+			lat = std::stod(argv[i+2]);
+			radius = std::stod(argv[i+3]);
+			i += 3;
+		}
+		else if(fs::path{arg}.extension() == ".tracks")
+			db_file = arg;
+		else
+			gpx_dir = arg;
+	}
+
+	Profiler::SetEnabled(do_profile);
+	Profiler::SetTracing(trace_file.has_value());
+
+	if(gpx_dir && !fs::exists(*gpx_dir) && !fs::create_directories(*gpx_dir))
+	{
+		std::cerr << "Could not create directory " << *gpx_dir << "." << std::endl;
+		return -1;
+	}
+
+	TrackGenerator<t_real, t_size> gen;
+	gen.SetSeed(seed);
+	gen.SetArea(lon / 180. * num::pi, lat / 180. * num::pi, radius * 1000.);
+	gen.SetPointsPerTrack(num_points);
+	gen.SetSamplingInterval(dt);
+	gen.SetSpeed(speed);
+	gen.SetNoise(noise, noise / 3.);
+	gen.SetNumRoutes(std::max<t_size>(static_cast<t_size>(
+		std::ceil(t_real(num_tracks) * (1. - reuse))), 1));
+
+	try
+	{
+		std::ofstream ofstr;
+		std::optional<TrackDBWriter<SingleTrack<t_real, t_size>, t_size>> writer;
+		if(db_file)
+		{
+			ofstr.open(db_file->string(), std::ios::binary);
+			if(!ofstr)
+			{
+				std::cerr << "Could not write " << *db_file << "." << std::endl;
+				return -1;
+			}
+
+			writer.emplace(ofstr, num_tracks);
+		}
+
+		// generate batches of tracks in parallel and write them in order
+		const unsigned int num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+		const t_size batch_size = num_threads * 4;
+		std::vector<SingleTrack<t_real, t_size>> batch;
+		t_size total_points = 0;
+
+		for(t_size batch_start = 0; batch_start < num_tracks; batch_start += batch_size)
+		{
+			const t_size batch_end = std::min(batch_start + batch_size, num_tracks);
+			batch.clear();
+			batch.resize(batch_end - batch_start);
+
+			boost::asio::thread_pool tp{num_threads};
+			for(t_size trackidx = batch_start; trackidx < batch_end; ++trackidx)
+			{
+				boost::asio::post(tp, [&gen, &batch, &gpx_dir, trackidx, batch_start]() -> void
+				{
+					TRACKS_PROFILE_SCOPE("TrackGenerator::Generate");
+					auto& track = batch[trackidx - batch_start];
+					track = gen.Generate(trackidx);
+
+					if(gpx_dir)
+						track.ExportGpx((*gpx_dir / track.GetFileName()).string());
+				});
+			}
+			tp.join();
+
+			for(const auto& track : batch)
+			{
+				total_points += track.GetPoints().size();
+
+				if(writer && !writer->Write(track))
+				{
+					std::cerr << "Could not write " << *db_file << "." << std::endl;
+					return -1;
+				}
+			}
+
+			std::cout << "\rGenerated " << batch_end << " / " << num_tracks << " tracks." << std::flush;
+		}
+
+		if(writer && !writer->Finish())
+		{
+			std::cerr << "\nCould not write " << *db_file << "." << std::endl;
+			return -1;
+		}
+
+		std::cout << "\nGenerated " << total_points << " track points." << std::endl;
+
+		if(do_profile)
+			Profiler::Print(std::cerr);
+
+		if(trace_file && !Profiler::WriteTrace(trace_file->string()))
+		{
+			std::cerr << "Could not write " << *trace_file << "." << std::endl;
+			return -1;
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -7,6 +7,7 @@
 
 #include "common/types.h"
 #include "lib/map.h"
+#include "lib/profile.h"
 
 #include <sstream>
 
@@ -19,12 +20,24 @@ int main(int argc, char **argv)
 			<< "Options:\n"
 			<< "\t--xml    \t\tuse internal xml loader\n"
 			<< "\t--scale 1\t\tsvg scaling factor\n"
+			<< "\t--threads <num>\t\tnumber of threads for the import\n"
+			<< "\t--two-pass\t\tonly keep the nodes referenced by ways and relations\n"
+			<< "\t--node-index <file>\tkeep the node id index in a memory-mapped scratch file\n"
+			<< "\t--profile\t\tprint the timings of the processing stages\n"
+			<< "\t--memory\t\tprint the memory used by the map\n"
+			<< "\t--trace <file>\t\twrite a chrome trace of the processing stages\n"
 			<< std::endl;
 		return -1;
 	}
 
 	bool use_xml_loader = false;
+	bool two_pass = false;
+	bool do_profile = false;
+	bool do_memory = false;
+	std::string trace_file;
+	std::string node_index_file;
 	t_real svg_scale = 1.;
+	unsigned int num_threads = Map<t_real, t_size>::GetDefaultNumThreads();
 	t_real min_lon = -10., max_lon = 10.;
 	t_real min_lat = -10., max_lat = 10.;
 
@@ -34,13 +47,31 @@ int main(int argc, char **argv)
 			use_xml_loader = true;
 		else if(std::string(argv[i]) == "--scale" && i + 1 < argc)
 			std::istringstream{argv[i+1]} >> svg_scale;
+		else if(std::string(argv[i]) == "--threads" && i + 1 < argc)
+			std::istringstream{argv[++i]} >> num_threads;
+		else if(std::string(argv[i]) == "--two-pass")
+			two_pass = true;
+		else if(std::string(argv[i]) == "--node-index" && i + 1 < argc)
+			node_index_file = argv[++i];
+		else if(std::string(argv[i]) == "--profile")
+			do_profile = true;
+		else if(std::string(argv[i]) == "--memory")
+			do_memory = true;
+		else if(std::string(argv[i]) == "--trace" && i + 1 < argc)
+			trace_file = argv[++i];
 	}
 
+	Profiler::SetEnabled(do_profile);
+	Profiler::SetTracing(trace_file != "");
+
 	try
 	{
 		Map<t_real, t_size> map;
 		map.SetSkipBuildings(false);
 		map.SetSkipLabels(true);
+		map.SetNumThreads(num_threads);
+		map.SetTwoPassImport(two_pass);
+		map.SetNodeIndexFile(node_index_file);
 
 		if(use_xml_loader && !map.ImportXml(argv[1]))
 		{
@@ -59,6 +90,18 @@ int main(int argc, char **argv)
 			std::cerr << "Could not write \"" << argv[2] << "\"." << std::endl;
 			return -1;
 		}
+
+		if(do_memory)
+			map.MemoryUsage().Print(std::cout);
+
+		if(do_profile)
+			Profiler::Print(std::cerr);
+
+		if(trace_file != "" && !Profiler::WriteTrace(trace_file))
+		{
+			std::cerr << "Could not write \"" << trace_file << "\"." << std::endl;
+			return -1;
+		}
 	}
 	catch(const std::exception& ex)
 	{
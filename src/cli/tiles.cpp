@@ -0,0 +1,116 @@
+/**
+ * cuts a map into tiles
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#include "common/types.h"
+#include "lib/map.h"
+#include "lib/profile.h"
+
+#include <sstream>
+
+
+int main(int argc, char **argv)
+{
+	if(argc <= 2)
+	{
+		std::cerr << "Please give an osm input file and a tile output directory.\n"
+			<< "Options:\n"
+			<< "\t--xml    \t\tuse internal xml loader\n"
+			<< "\t--zoom " << MAP_TILE_ZOOM << "\t\tzoom level of the tiles\n"
+			<< "\t--threads <num>\t\tnumber of threads for the import\n"
+			<< "\t--two-pass\t\tonly keep the nodes referenced by ways and relations\n"
+			<< "\t--node-index <file>\tkeep the node id index in a memory-mapped scratch file\n"
+			<< "\t--skip-buildings\tdo not include buildings\n"
+			<< "\t--skip-labels\t\tdo not include place labels\n"
+			<< "\t--profile\t\tprint the timings of the processing stages\n"
+			<< "The whole input file is imported before it is cut into tiles,\n"
+			<< "for large files use --two-pass and --node-index to reduce the memory needed.\n"
+			<< std::endl;
+		return -1;
+	}
+
+	bool use_xml_loader = false;
+	bool two_pass = false;
+	bool skip_buildings = false;
+	bool skip_labels = false;
+	bool do_profile = false;
+	std::string node_index_file;
+	unsigned int zoom = MAP_TILE_ZOOM;
+	unsigned int num_threads = Map<t_real, t_size>::GetDefaultNumThreads();
+
+	for(int i = 1; i < argc; ++i)
+	{
+		if(std::string(argv[i]) == "--xml")
+			use_xml_loader = true;
+		else if(std::string(argv[i]) == "--zoom" && i + 1 < argc)
+			std::istringstream{argv[++i]} >> zoom;
+		else if(std::string(argv[i]) == "--threads" && i + 1 < argc)
+			std::istringstream{argv[++i]} >> num_threads;
+		else if(std::string(argv[i]) == "--two-pass")
+			two_pass = true;
+		else if(std::string(argv[i]) == "--node-index" && i + 1 < argc)
+			node_index_file = argv[++i];
+		else if(std::string(argv[i]) == "--skip-buildings")
+			skip_buildings = true;
+		else if(std::string(argv[i]) == "--skip-labels")
+			skip_labels = true;
+		else if(std::string(argv[i]) == "--profile")
+			do_profile = true;
+	}
+
+	if(zoom > 20)
+	{
+		std::cerr << "Invalid zoom level " << zoom << "." << std::endl;
+		return -1;
+	}
+
+	Profiler::SetEnabled(do_profile);
+
+	try
+	{
+		Map<t_real, t_size> map;
+		map.SetSkipBuildings(skip_buildings);
+		map.SetSkipLabels(skip_labels);
+		map.SetNumThreads(num_threads);
+		map.SetTwoPassImport(two_pass);
+		map.SetNodeIndexFile(node_index_file);
+
+		if(use_xml_loader && !map.ImportXml(argv[1]))
+		{
+			std::cerr << "Could not read \"" << argv[1] << "\"." << std::endl;
+			return -1;
+		}
+
+		if(!use_xml_loader && !map.Import(argv[1]))
+		{
+			std::cerr << "Could not read \"" << argv[1] << "\"." << std::endl;
+			return -1;
+		}
+
+		std::function<bool(t_size, t_size)> progress = [](t_size tile, t_size num_tiles) -> bool
+		{
+			if(tile == num_tiles)
+				std::cout << "Wrote " << num_tiles << " tiles." << std::endl;
+			return true;
+		};
+
+		if(!map.SaveTiles(argv[2], zoom, &progress))
+		{
+			std::cerr << "Could not write tiles to \"" << argv[2] << "\"." << std::endl;
+			return -1;
+		}
+
+		if(do_profile)
+			Profiler::Print(std::cerr);
+	}
+	catch(const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -6,6 +6,8 @@
  */
 
 #include "lib/trackdb.h"
+#include "lib/heatmap.h"
+#include "lib/profile.h"
 #include "common/types.h"
 
 
@@ -48,6 +50,184 @@ static bool load_tracks(const fs::path& file, const std::optional<t_size>& track
 }
 
 
+/**
+ * list the tracks passing near the given coordinates [deg] within a radius [m]
+ */
+static bool find_tracks(const fs::path& file, t_real lon, t_real lat, t_real radius)
+{
+	namespace num = std::numbers;
+
+	try
+	{
+		MultipleTracks<t_real> tracks;
+		if(!tracks.Load(file.string()))
+		{
+			std::cerr << "Could not read " << file << "." << std::endl;
+			return false;
+		}
+
+		auto matches = tracks.GetTracksNear(
+			lon / t_real(180) * num::pi_v<t_real>,
+			lat / t_real(180) * num::pi_v<t_real>,
+			radius);
+
+		for(const auto& match : matches)
+		{
+			const auto* track = tracks.GetTrack(match.track_idx);
+			std::cout << std::left << std::setw(6) << match.track_idx + 1 << " "
+				<< std::left << std::setw(45) << track->GetFileName() << " ";
+
+			// distance along the track at entry and exit
+			for(const auto& [ entry, exit ] : match.passes)
+			{
+				std::cout << "[" << track->GetPoints()[entry].distance_total / 1000.
+					<< ", " << track->GetPoints()[exit].distance_total / 1000. << "] km ";
+			}
+			std::cout << "\n";
+		}
+
+		std::cout << matches.size() << " matching track(s)." << std::endl;
+	}
+	catch(const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * list groups of tracks following the same route
+ */
+static bool find_routes(const fs::path& file, t_real max_dist)
+{
+	try
+	{
+		MultipleTracks<t_real> tracks;
+		if(!tracks.Load(file.string()))
+		{
+			std::cerr << "Could not read " << file << "." << std::endl;
+			return false;
+		}
+
+		auto clusters = tracks.GetRouteClusters(max_dist);
+
+		for(t_size clusteridx = 0; clusteridx < clusters.size(); ++clusteridx)
+		{
+			const auto& cluster = clusters[clusteridx];
+			const auto* first_track = tracks.GetTrack(cluster[0]);
+
+			std::cout << "Route " << clusteridx + 1 << ": "
+				<< cluster.size() << " track(s), "
+				<< first_track->GetTotalDistance(false) / 1000. << " km\n";
+
+			for(t_size trackidx : cluster)
+			{
+				const auto* track = tracks.GetTrack(trackidx);
+				std::cout << "\t" << std::left << std::setw(6) << trackidx + 1 << " "
+					<< track->GetFileName() << "\n";
+			}
+		}
+
+		std::cout << clusters.size() << " route(s)." << std::endl;
+	}
+	catch(const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * rasterise all tracks into a heat map image
+ */
+static bool write_heatmap(const fs::path& file, const fs::path& img_file,
+	std::optional<unsigned int> zoom)
+{
+	try
+	{
+		MultipleTracks<t_real> tracks;
+		if(!tracks.Load(file.string()))
+		{
+			std::cerr << "Could not read " << file << "." << std::endl;
+			return false;
+		}
+
+		// coordinate range of all tracks
+		t_real min_lon = std::numeric_limits<t_real>::max(), max_lon = -min_lon;
+		t_real min_lat = std::numeric_limits<t_real>::max(), max_lat = -min_lat;
+		for(const auto *track : tracks.GetTracks())
+		{
+			if(track->GetPoints().size() == 0)
+				continue;
+
+			auto [ track_min_lon, track_max_lon ] = track->GetLongitudeRange();
+			auto [ track_min_lat, track_max_lat ] = track->GetLatitudeRange();
+			min_lon = std::min(min_lon, track_min_lon);
+			max_lon = std::max(max_lon, track_max_lon);
+			min_lat = std::min(min_lat, track_min_lat);
+			max_lat = std::max(max_lat, track_max_lat);
+		}
+
+		if(min_lon > max_lon || min_lat > max_lat)
+		{
+			std::cerr << "No track points available." << std::endl;
+			return false;
+		}
+
+		// without a given zoom, choose the largest level up to 16 for which the image is not too large
+		using t_heatmap = Heatmap<t_real>;
+		t_heatmap heatmap;
+		heatmap.SetNumThreads(std::max<unsigned int>(std::thread::hardware_concurrency(), 1));
+		for(unsigned int new_zoom = zoom ? *zoom : 16; ; --new_zoom)
+		{
+			heatmap.SetZoom(new_zoom);
+			if(zoom || new_zoom == 0 || heatmap.GetRect(min_lon, max_lon, min_lat, max_lat).IsExportable())
+				break;
+		}
+
+		if(auto rect = heatmap.GetRect(min_lon, max_lon, min_lat, max_lat); !rect.IsExportable())
+		{
+			std::cerr << "The " << rect.GetWidth() << " x " << rect.GetHeight()
+				<< " pixel heat map at zoom " << heatmap.GetZoom()
+				<< " exceeds the maximum size of " << t_heatmap::MAX_IMAGE_SIZE
+				<< " pixels, please choose a lower zoom." << std::endl;
+			return false;
+		}
+
+		heatmap.AddTracks(tracks.GetTracks());
+		const auto& bounds = heatmap.GetBounds();
+		if(bounds.IsEmpty())
+		{
+			std::cerr << "No track points available." << std::endl;
+			return false;
+		}
+
+		if(!heatmap.Export(img_file.string()))
+		{
+			std::cerr << "Could not write " << img_file << "." << std::endl;
+			return false;
+		}
+
+		std::cout << "Wrote " << bounds.GetWidth() << " x " << bounds.GetHeight()
+			<< " pixel heat map at zoom " << heatmap.GetZoom() << " with " << heatmap.GetTileCount() << " tile(s) to "
+			<< img_file << "." << std::endl;
+	}
+	catch(const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+
 /**
  * fix shifted track names due to delete bug in gui
  */
@@ -92,6 +272,39 @@ static bool fix_track_names(const fs::path& file, t_size start_idx = 0)
 }
 
 
+/**
+ * print the memory used by the loaded tracks and their spatial index
+ */
+static bool print_memory(const fs::path& file)
+{
+	try
+	{
+		MultipleTracks<t_real> tracks;
+		if(!tracks.Load(file.string()))
+		{
+			std::cerr << "Could not read " << file << "." << std::endl;
+			return false;
+		}
+
+		std::cout << "Loaded tracks:\n";
+		tracks.MemoryUsage().Print(std::cout);
+
+		// building the spatial index
+		tracks.GetTracksNear(0., 0., 0.);
+
+		std::cout << "\nIncluding the spatial index:\n";
+		tracks.MemoryUsage().Print(std::cout);
+	}
+	catch(const std::exception& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+
 static bool load_gpx(const fs::path& file)
 {
 	try
@@ -115,20 +328,95 @@ static bool load_gpx(const fs::path& file)
 }
 
 
+static void print_usage()
+{
+	std::cerr << "Please give a .tracks or a .gpx track file.\n"
+		<< "Options:\n"
+		<< "\t--profile               \tprint the timings of the processing stages\n"
+		<< "\t--trace <file>          \twrite a chrome trace of the processing stages\n"
+		<< "Options for .tracks files:\n"
+		<< "\t<number>                \tshow the track with the given number\n"
+		<< "\t--near <lon> <lat> <rad>\tlist tracks passing within <rad> m of a point\n"
+		<< "\t--routes [<dist>]       \tgroup tracks following the same route within <dist> m\n"
+		<< "\t--heatmap <img> [<zoom>]\twrite a heat map of all tracks (.png or .pgm)\n"
+		<< "\t--memory                \tprint the memory used by the tracks\n"
+		<< std::endl;
+}
+
+
 int main(int argc, char **argv)
 {
 	if(argc <= 1)
 	{
-		std::cerr << "Please give a .tracks or a .gpx track file." << std::endl;
+		print_usage();
 		return -1;
 	}
 
-	bool do_fix = false;
-
-	// was a track index given as second argument?
+	bool do_fix = false, do_profile = false, do_memory = false;
 	std::optional<t_size> track_idx;
-	if(argc > 2)
-		track_idx = std::stoul(argv[2]) - 1;
+	std::optional<std::tuple<t_real, t_real, t_real>> near;
+	std::optional<t_real> routes;
+	std::optional<std::pair<fs::path, std::optional<unsigned int>>> heatmap;
+	std::optional<fs::path> trace_file;
+
+	auto is_number = [](const char *arg) -> bool
+	{
+		return std::isdigit(static_cast<unsigned char>(arg[0]));
+	};
+
+	try
+	{
+		for(int i = 2; i < argc; ++i)
+		{
+			if(std::string(argv[i]) == "--near" && i + 3 < argc)
+			{
+				near = std::make_tuple(std::stod(argv[i+1]), std::stod(argv[i+2]), std::stod(argv[i+3]));
+				i += 3;
+			}
+			else if(std::string(argv[i]) == "--routes")
+			{
+				routes = 100.;
+				if(i + 1 < argc && is_number(argv[i+1]))
+					routes = std::stod(argv[++i]);
+			}
+			else if(std::string(argv[i]) == "--heatmap" && i + 1 < argc)
+			{
+				heatmap = std::make_pair(fs::path{argv[++i]}, std::nullopt);
+				if(i + 1 < argc && is_number(argv[i+1]))
+					heatmap->second = static_cast<unsigned int>(std::stoul(argv[++i]));
+			}
+			else if(std::string(argv[i]) == "--profile")
+			{
+				do_profile = true;
+			}
+			else if(std::string(argv[i]) == "--memory")
+			{
+				do_memory = true;
+			}
+			else if(std::string(argv[i]) == "--trace" && i + 1 < argc)
+			{
+				trace_file = argv[++i];
+			}
+			else if(is_number(argv[i]))
+			{
+				// a track index
+				track_idx = std::stoul(argv[i]) - 1;
+			}
+			else
+			{
+				std::cerr << "Unknown option \"" << argv[i] << "\"." << std::endl;
+				print_usage();
+				return -1;
+			}
+		}
+	}
+	catch(const std::logic_error&)
+	{
+		// invalid or out-of-range numbers
+		std::cerr << "Invalid arguments." << std::endl;
+		print_usage();
+		return -1;
+	}
 
 	// file name as first argument
 	std::filesystem::path file{argv[1]};
@@ -138,10 +426,21 @@ int main(int argc, char **argv)
 		return -1;
 	}
 
+	Profiler::SetEnabled(do_profile);
+	Profiler::SetTracing(trace_file.has_value());
+
 	if(file.extension() == ".tracks")
 	{
 		if(do_fix)
 			fix_track_names(file, *track_idx);
+		else if(near)
+			find_tracks(file, std::get<0>(*near), std::get<1>(*near), std::get<2>(*near));
+		else if(routes)
+			find_routes(file, *routes);
+		else if(heatmap)
+			write_heatmap(file, heatmap->first, heatmap->second);
+		else if(do_memory)
+			print_memory(file);
 		else
 			load_tracks(file, track_idx);
 	}
@@ -155,5 +454,14 @@ int main(int argc, char **argv)
 		return -1;
 	}
 
+	if(do_profile)
+		Profiler::Print(std::cerr);
+
+	if(trace_file && !Profiler::WriteTrace(trace_file->string()))
+	{
+		std::cerr << "Could not write " << *trace_file << "." << std::endl;
+		return -1;
+	}
+
 	return 0;
 }
@@ -0,0 +1,267 @@
+/**
+ * diagnostics showing the timings of the processing stages
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#include "diagnostics.h"
+#include "lib/profile.h"
+#include "../tableitems.h"
+
+#include <QtCore/QSettings>
+#include <QtCore/QByteArray>
+#include <QtCore/QFileInfo>
+#include <QtWidgets/QGridLayout>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+
+
+// table columns
+#define TAB_NAME         0
+#define TAB_CALLS        1
+#define TAB_TOTAL        2
+#define TAB_MEAN         3
+#define TAB_MIN          4
+#define TAB_MAX          5
+#define TAB_COUNT        6
+#define TAB_NUM_COLS     7
+
+
+DiagnosticsDlg::DiagnosticsDlg(QWidget* parent)
+	: QDialog(parent)
+{
+	setWindowTitle("Diagnostics");
+	setSizeGripEnabled(true);
+
+	// profiling table
+	m_table = std::make_shared<QTableWidget>(this);
+	m_table->setShowGrid(true);
+	m_table->setSortingEnabled(true);
+	m_table->setSelectionBehavior(QTableWidget::SelectRows);
+	m_table->setSelectionMode(QTableWidget::SingleSelection);
+	m_table->setAlternatingRowColors(true);
+
+	m_table->setColumnCount(TAB_NUM_COLS);
+	m_table->setHorizontalHeaderItem(TAB_NAME, new QTableWidgetItem{"Stage"});
+	m_table->setHorizontalHeaderItem(TAB_CALLS, new QTableWidgetItem{"Calls"});
+	m_table->setHorizontalHeaderItem(TAB_TOTAL, new QTableWidgetItem{"Total Time"});
+	m_table->setHorizontalHeaderItem(TAB_MEAN, new QTableWidgetItem{"Mean Time"});
+	m_table->setHorizontalHeaderItem(TAB_MIN, new QTableWidgetItem{"Min. Time"});
+	m_table->setHorizontalHeaderItem(TAB_MAX, new QTableWidgetItem{"Max. Time"});
+	m_table->setHorizontalHeaderItem(TAB_COUNT, new QTableWidgetItem{"Count"});
+
+	m_table->horizontalHeader()->setDefaultSectionSize(100);
+	m_table->verticalHeader()->setDefaultSectionSize(24);
+	m_table->verticalHeader()->setVisible(false);
+	m_table->setColumnWidth(TAB_NAME, 250);
+
+	// enable profiling
+	m_enabled = std::make_shared<QCheckBox>("Record timings", this);
+	m_enabled->setToolTip("Record the timings of the processing stages.");
+	m_enabled->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+	connect(m_enabled.get(), &QCheckBox::toggled, this, &DiagnosticsDlg::SetProfilingEnabled);
+
+	// enable trace events
+	m_tracing = std::make_shared<QCheckBox>("Record trace", this);
+	m_tracing->setToolTip("Record the processing stages of all threads as trace events.");
+	m_tracing->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+	connect(m_tracing.get(), &QCheckBox::toggled, this, &DiagnosticsDlg::SetTracingEnabled);
+
+	// button box
+	m_buttonbox = std::make_shared<QDialogButtonBox>(this);
+	m_buttonbox->setStandardButtons(QDialogButtonBox::Ok);
+	m_buttonbox->button(QDialogButtonBox::Ok)->setDefault(true);
+	m_buttonbox->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+
+	QPushButton *refresh = new QPushButton("Refresh", this);
+	refresh->setToolTip("Show the current timings.");
+	QPushButton *reset = new QPushButton("Reset", this);
+	reset->setToolTip("Clear the recorded timings.");
+	QPushButton *save_trace = new QPushButton("Save Trace...", this);
+	save_trace->setToolTip("Save the trace events for chrome://tracing or ui.perfetto.dev.");
+	m_buttonbox->addButton(refresh, QDialogButtonBox::ActionRole);
+	m_buttonbox->addButton(reset, QDialogButtonBox::ActionRole);
+	m_buttonbox->addButton(save_trace, QDialogButtonBox::ActionRole);
+
+	connect(m_buttonbox.get(), &QDialogButtonBox::clicked,
+		[this, refresh, reset, save_trace](QAbstractButton *btn) -> void
+	{
+		// get button role
+		QDialogButtonBox::ButtonRole role = m_buttonbox->buttonRole(btn);
+
+		if(role == QDialogButtonBox::AcceptRole)
+			this->accept();
+		else if(role == QDialogButtonBox::RejectRole)
+			this->reject();
+		else if(btn == static_cast<QAbstractButton*>(refresh))
+			this->FillTable();
+		else if(btn == static_cast<QAbstractButton*>(reset))
+			this->ResetProfiling();
+		else if(btn == static_cast<QAbstractButton*>(save_trace))
+			this->SaveTrace();
+	});
+
+	// main grid
+	QGridLayout *main_layout = new QGridLayout(this);
+	main_layout->setContentsMargins(8, 8, 8, 8);
+	main_layout->setVerticalSpacing(4);
+	main_layout->setHorizontalSpacing(4);
+	main_layout->addWidget(m_table.get(), 0, 0, 1, 3);
+	main_layout->addWidget(m_enabled.get(), 1, 0, 1, 1);
+	main_layout->addWidget(m_tracing.get(), 1, 1, 1, 1);
+	main_layout->addWidget(m_buttonbox.get(), 1, 2, 1, 1);
+
+	// restore settings
+	QSettings settings{this};
+
+	if(settings.contains("dlg_diagnostics/wnd_geo"))
+	{
+		QByteArray arr{settings.value("dlg_diagnostics/wnd_geo").toByteArray()};
+		this->restoreGeometry(arr);
+	}
+	else
+	{
+		this->resize(800, 480);
+	}
+
+	m_enabled->setChecked(Profiler::IsEnabled());
+	m_tracing->setChecked(Profiler::IsTracing());
+}
+
+
+DiagnosticsDlg::~DiagnosticsDlg()
+{
+}
+
+
+/**
+ * show the merged profiling results of all threads
+ */
+void DiagnosticsDlg::FillTable()
+{
+	if(!m_table)
+		return;
+
+	const auto results = Profiler::GetResults();
+
+	m_table->setSortingEnabled(false);
+	m_table->clearContents();
+	m_table->setRowCount(static_cast<int>(results.size()));
+
+	for(std::size_t idx = 0; idx < results.size(); ++idx)
+	{
+		const auto& entry = results[idx];
+		const t_real mean = entry.calls ? entry.total / t_real(entry.calls) : 0.;
+
+		const int row = static_cast<int>(idx);
+		m_table->setItem(row, TAB_NAME, new QTableWidgetItem{entry.name.c_str()});
+		m_table->setItem(row, TAB_CALLS,
+			new NumericTableWidgetItem<t_real>(t_real(entry.calls), 12));
+		m_table->setItem(row, TAB_TOTAL,
+			new NumericTableWidgetItem<t_real>(entry.total * 1000., g_prec_gui, " ms"));
+		m_table->setItem(row, TAB_MEAN,
+			new NumericTableWidgetItem<t_real>(mean * 1000., g_prec_gui, " ms"));
+		m_table->setItem(row, TAB_MIN,
+			new NumericTableWidgetItem<t_real>(entry.min * 1000., g_prec_gui, " ms"));
+		m_table->setItem(row, TAB_MAX,
+			new NumericTableWidgetItem<t_real>(entry.max * 1000., g_prec_gui, " ms"));
+		m_table->setItem(row, TAB_COUNT,
+			new NumericTableWidgetItem<t_real>(t_real(entry.count), 12));
+
+		// set all items read-only
+		for(int col = 0; col < TAB_NUM_COLS; ++col)
+		{
+			m_table->item(row, col)->setFlags(
+				m_table->item(row, col)->flags() & ~Qt::ItemIsEditable);
+		}
+	}
+
+	m_table->setSortingEnabled(true);
+}
+
+
+void DiagnosticsDlg::SetProfilingEnabled(bool enabled)
+{
+	Profiler::SetEnabled(enabled);
+}
+
+
+/**
+ * tracing also enables the profiler
+ */
+void DiagnosticsDlg::SetTracingEnabled(bool enabled)
+{
+	Profiler::SetTracing(enabled);
+
+	if(enabled && m_enabled)
+		m_enabled->setChecked(true);
+}
+
+
+void DiagnosticsDlg::ResetProfiling()
+{
+	Profiler::Reset();
+	FillTable();
+}
+
+
+/**
+ * save the recorded trace events in the chrome trace format
+ */
+void DiagnosticsDlg::SaveTrace()
+{
+	QSettings settings{this};
+	QString dir = settings.value("dlg_diagnostics/trace_dir", "").toString();
+
+	auto filedlg = std::make_shared<QFileDialog>(
+		this, "Save Trace", dir,
+		"Trace Files (*.json)");
+	filedlg->setAcceptMode(QFileDialog::AcceptSave);
+	filedlg->setDefaultSuffix("json");
+	filedlg->selectFile("trace.json");
+	filedlg->setFileMode(QFileDialog::AnyFile);
+
+	if(!filedlg->exec())
+		return;
+
+	QStringList files = filedlg->selectedFiles();
+	if(files.size() == 0 || files[0] == "")
+		return;
+
+	if(!Profiler::WriteTrace(files[0].toStdString()))
+	{
+		QMessageBox::critical(this, "Error",
+			QString("File \"%1\" could not be saved.").arg(files[0]));
+		return;
+	}
+
+	settings.setValue("dlg_diagnostics/trace_dir", QFileInfo{files[0]}.path());
+}
+
+
+void DiagnosticsDlg::showEvent(QShowEvent *evt)
+{
+	FillTable();
+	QDialog::showEvent(evt);
+}
+
+
+void DiagnosticsDlg::accept()
+{
+	// save settings
+	QSettings settings{this};
+
+	QByteArray geo{this->saveGeometry()};
+	settings.setValue("dlg_diagnostics/wnd_geo", geo);
+
+	QDialog::accept();
+}
+
+
+void DiagnosticsDlg::reject()
+{
+	QDialog::reject();
+}
@@ -0,0 +1,55 @@
+/**
+ * diagnostics showing the timings of the processing stages
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_DIAGNOSTICS_H__
+#define __TRACKS_DIAGNOSTICS_H__
+
+#include <QtWidgets/QDialog>
+#include <QtWidgets/QTableWidget>
+#include <QtWidgets/QCheckBox>
+#include <QtWidgets/QDialogButtonBox>
+
+#include <memory>
+
+#include "../globals.h"
+
+
+/**
+ * dialog listing the profiling results
+ */
+class DiagnosticsDlg : public QDialog
+{ Q_OBJECT
+public:
+	DiagnosticsDlg(QWidget *parent = nullptr);
+	virtual ~DiagnosticsDlg();
+
+	DiagnosticsDlg(const DiagnosticsDlg&) = delete;
+	DiagnosticsDlg& operator=(const DiagnosticsDlg&) = delete;
+
+	void FillTable();
+
+
+protected:
+	virtual void accept() override;
+	virtual void reject() override;
+	virtual void showEvent(QShowEvent *evt) override;
+
+	void SetProfilingEnabled(bool enabled);
+	void SetTracingEnabled(bool enabled);
+	void ResetProfiling();
+	void SaveTrace();
+
+
+private:
+	std::shared_ptr<QTableWidget> m_table{};
+	std::shared_ptr<QCheckBox> m_enabled{};
+	std::shared_ptr<QCheckBox> m_tracing{};
+	std::shared_ptr<QDialogButtonBox> m_buttonbox{};
+};
+
+
+#endif
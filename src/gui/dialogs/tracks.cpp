@@ -198,36 +198,32 @@ void TracksDlg::FillTable()
 	m_table->clearContents();
 	m_table->setRowCount(m_trackdb->GetTrackCount());
 
-	// iterate all tracks
+	// iterate all track summaries
+	const auto summaries = m_trackdb->GetSummaries();
 	t_real distance_sum{};
-	for(t_size _track_idx = 0; _track_idx < m_trackdb->GetTrackCount(); ++_track_idx)
+	for(t_size _track_idx = 0; _track_idx < summaries.size(); ++_track_idx)
 	{
-		const t_size track_idx = m_trackdb->GetTrackCount() - _track_idx - 1;
-		const t_track *track = m_trackdb->GetTrack(track_idx);
+		const t_size track_idx = summaries.size() - _track_idx - 1;
+		const auto& summary = summaries[track_idx];
 
-		const std::optional<typename t_track::t_timept> start_time = track->GetStartTime();
 		std::optional<t_real> sincelasttrack;
-		if(track_idx < m_trackdb->GetTrackCount() - 1)
+		if(track_idx < summaries.size() - 1)
 		{
-			const t_track *last_track = m_trackdb->GetTrack(track_idx + 1);
-			const std::optional<typename t_track::t_timept> last_time
-				= last_track->GetEndTime();
-			sincelasttrack = std::chrono::duration_cast<typename t_track::t_sec>(
-				*start_time - *last_time).count() / 60. / 60. / 24.;
+			const auto& last_summary = summaries[track_idx + 1];
+			sincelasttrack = (summary.start_time - last_summary.end_time) / 60. / 60. / 24.;
 		}
-		const t_real epoch = start_time ? std::chrono::duration_cast<typename t_track::t_sec>(
-			start_time->time_since_epoch()).count() : 0.;
-		const t_real duration = track->GetTotalTime() / 60.;
+		const t_real epoch = summary.start_time;
+		const t_real duration = summary.total_time / 60.;
 
-		const t_real distance = track->GetTotalDistance() / 1000.;
+		const t_real distance = summary.distance / 1000.;
 		distance_sum += distance;
 
-		const auto [ climb, climb_down ] = track->GetAscentDescent();
-		const auto [ min_elev, max_elev ] = track->GetElevationRange();
-		const t_real height = max_elev - min_elev;
+		const t_real climb = summary.ascent;
+		const t_real height = summary.max_elev - summary.min_elev;
 
 		const int row = static_cast<int>(track_idx);
-		m_table->setItem(row, TAB_NAME, new QTableWidgetItem{track->GetFileName().c_str()});
+		m_table->setItem(row, TAB_NAME, new QTableWidgetItem{
+			m_trackdb->GetTrack(track_idx)->GetFileName().c_str()});
 		m_table->setItem(row, TAB_DATE, new DateTimeTableWidgetItem<
 			typename t_track::t_clk, typename t_track::t_timept, t_real>(epoch));
 		m_table->setItem(row, TAB_DURATION,
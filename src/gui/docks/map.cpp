@@ -42,18 +42,19 @@ bool MapPlotter::Plot(std::shared_ptr<QCustomPlot> plot) const
 			continue;
 
 		// get vertices
+		std::span<const t_size> vertex_ids = GetIds(seg.vertex_ids);
 		QVector<t_real> lons, lats;
-		lons.reserve(seg.vertex_ids.size());
-		lats.reserve(seg.vertex_ids.size());
+		lons.reserve(vertex_ids.size());
+		lats.reserve(vertex_ids.size());
 
-		for(const t_size vert_id : seg.vertex_ids)
+		for(const t_size vert_id : vertex_ids)
 		{
-			auto iter = m_vertices.find(vert_id);
-			if(iter == m_vertices.end())
+			const t_vertex *vertex = m_vertices.Find(vert_id);
+			if(!vertex)
 				continue;
 
-			t_real lon = iter->second.longitude;
-			t_real lat = iter->second.latitude;
+			t_real lon = vertex->longitude;
+			t_real lat = vertex->latitude;
 
 			// only consider vertices within the given bounding rectangle
 			if(lon < m_minmax_plot_longitude[0] || lon > m_minmax_plot_longitude[1])
@@ -70,15 +71,15 @@ bool MapPlotter::Plot(std::shared_ptr<QCustomPlot> plot) const
 		t_real line_width = 1.;
 		bool found_width = false, found_col = false;
 
-		for(const auto& [ tag_key, tag_val ] : seg.tags)
+		for(const t_tag& tag : seg.tags)
 		{
 			if(!found_width)
 				std::tie(found_width, line_width) =
-					GetRoadWidth(tag_key, tag_val, 1.);
+					GetRoadWidth(tag, 1.);
 
 			if(!found_col)
 				std::tie(found_col, r, g, b) =
-					GetSurfaceColour(tag_key, tag_val);
+					GetSurfaceColour(tag);
 
 			if(found_width && found_col)
 				break;
@@ -7,6 +7,8 @@
 
 #include "track_infos.h"
 #include "lib/calc.h"
+#include "lib/heatmap.h"
+#include "lib/profile.h"
 #include "common/version.h"
 #include "../helpers.h"
 namespace fs = __map_fs;
@@ -230,6 +232,10 @@ TrackInfos::TrackInfos(QWidget* parent) : QWidget{parent}
 	QAction *actionSaveSvg = new QAction(iconSaveSvg, "Save Image...", m_map_context.get());
 	connect(actionSaveSvg, &QAction::triggered, this, &TrackInfos::SaveMapSvg);
 	m_map_context->addAction(actionSaveSvg);
+	QIcon iconHeatmap = QIcon::fromTheme("weather-clear");
+	QAction *actionHeatmap = new QAction(iconHeatmap, "Show Heat Map of All Tracks", m_map_context.get());
+	connect(actionHeatmap, &QAction::triggered, this, &TrackInfos::PlotHeatmap);
+	m_map_context->addAction(actionHeatmap);
 
 	m_mapfile = std::make_shared<QLineEdit>(map_panel);
 	m_mapfile->setPlaceholderText("Directory with Map Files (.osm.pbf).");
@@ -716,6 +722,8 @@ void TrackInfos::PlotMap(bool load_cached)
 	if(!m_map)
 		return;
 
+	TRACKS_PROFILE_SCOPE("TrackInfos::PlotMap");
+
 	// clear map
 	m_map_image.clear();
 	m_map->load(m_map_image);
@@ -735,9 +743,22 @@ void TrackInfos::PlotMap(bool load_cached)
 	t_real lon_range = m_max_long_plot - m_min_long_plot;
 	t_real lat_range = m_max_lat_plot - m_min_lat_plot;
 
+	// area of the map, with some margins around the actual data area
+	const typename t_map_cache::t_bounds map_bounds
+	{
+		static_cast<t_real_map>(m_min_long_plot - lon_range*g_map_overdraw),
+		static_cast<t_real_map>(m_max_long_plot + lon_range*g_map_overdraw),
+		static_cast<t_real_map>(m_min_lat_plot - lat_range*g_map_overdraw),
+		static_cast<t_real_map>(m_max_lat_plot + lat_range*g_map_overdraw),
+	};
+	const auto [ map_min_lon, map_max_lon, map_min_lat, map_max_lat ] = map_bounds;
+
+	// cached maps are shared by all tracks in their area
+	t_map_cache map_cache;
+	map_cache.SetDirectory(g_temp_dir.toStdString());
+
 	// track
 	std::vector<typename t_map::t_vertex> thetrack;
-	std::optional<std::string> cached_map_name;
 	if(m_track)
 	{
 		thetrack.reserve(m_track->GetPoints().size());
@@ -751,16 +772,6 @@ void TrackInfos::PlotMap(bool load_cached)
 
 			thetrack.emplace_back(std::move(vert));
 		}
-
-		t_size track_hash = m_track->GetHash();
-		std::ostringstream ostr_cached;
-		if(g_temp_dir != "")
-		{
-			ostr_cached << g_temp_dir.toStdString();
-			ostr_cached << QString{QDir::separator()}.toStdString();
-		}
-		ostr_cached << std::hex << track_hash << ".trackmap";
-		cached_map_name = ostr_cached.str();
 	}
 
 	// map loading progress
@@ -785,29 +796,53 @@ void TrackInfos::PlotMap(bool load_cached)
 	t_map map;
 	map.SetSkipBuildings(!g_map_show_buildings);
 	map.SetSkipLabels(!g_map_show_labels);
+	map.SetNumThreads(static_cast<unsigned int>(g_num_threads));
+	// only the nodes within the small region around the track are kept anyway, the id set
+	// of the nodes referenced in the whole map file, which a second pass needs, costs more
+	map.SetTwoPassImport(g_map_two_pass);
 	map.SetTrack(std::move(thetrack));
 
 	bool map_loaded = false;
+	const std::string mapdir = m_mapfile->text().toStdString();
+
+	// assemble the map from pre-cut tiles if the map directory contains them
+	if(t_map::GetTileZoom(mapdir))
+	{
+		map_loaded = map.LoadTiles(mapdir,
+			map_min_lon, map_max_lon, map_min_lat, map_max_lat, &progress);
 
-	// try to load a cached map
-	if(load_cached)
-		map_loaded = map.Load(*cached_map_name);
+		// the tiles were cut with all objects, only show the selected ones
+		map.SetSkipBuildings(!g_map_show_buildings);
+		map.SetSkipLabels(!g_map_show_labels);
+	}
+
+	// try to load a cached map covering the area and crop it
+	else if(load_cached)
+	{
+		if(std::optional<std::string> cached_map_name = map_cache.Find(map_bounds); cached_map_name)
+		{
+			map_loaded = map.Load(*cached_map_name);
+			if(map_loaded)
+				map.Crop(map_min_lon, map_max_lon, map_min_lat, map_max_lat);
+		}
+	}
 
 	// else generate a new map
 	else if(!load_cached && !map_loaded)
 	{
-		// cut out a map that has some margins around the actual data area
-		map_loaded = map.ImportDir(m_mapfile->text().toStdString(),
-			static_cast<t_real_map>(m_min_long_plot - lon_range*g_map_overdraw),
-			static_cast<t_real_map>(m_max_long_plot + lon_range*g_map_overdraw),
-			static_cast<t_real_map>(m_min_lat_plot - lat_range*g_map_overdraw),
-			static_cast<t_real_map>(m_max_lat_plot + lat_range*g_map_overdraw),
+		// cut out the area widened to the cache grid, so that it can be cached
+		const auto [ cache_min_lon, cache_max_lon, cache_min_lat, cache_max_lat ]
+			= map_cache.Quantise(map_bounds);
+		map_loaded = map.ImportDir(mapdir,
+			cache_min_lon, cache_max_lon, cache_min_lat, cache_max_lat,
 			&progress);
 
-		if(map_loaded && cached_map_name)
+		if(map_loaded)
 		{
-			// cache generated map
-			map.Save(*cached_map_name);
+			map.Save(map_cache.GetFilename(map_bounds));
+
+			// only keep the data area with its margins, as for a cached map
+			map.Crop(map_min_lon, map_max_lon, map_min_lat, map_max_lat);
 		}
 
 		if(!map_loaded)
@@ -821,16 +856,15 @@ void TrackInfos::PlotMap(bool load_cached)
 
 	if(map_loaded)
 	{
-		// plot the map data area as svg image
-		std::ostringstream ostr;
-		map.ExportSvg(ostr, static_cast<t_real_map>(g_map_scale),
+		// plot the map data area as svg image, reusing the buffer of the previous one
+		map.ExportSvgToBuffer(m_map_svg, static_cast<t_real_map>(g_map_scale),
 			static_cast<t_real_map>(m_min_long_plot - lon_range*g_map_overdraw/2.),
 			static_cast<t_real_map>(m_max_long_plot + lon_range*g_map_overdraw/2.),
 			static_cast<t_real_map>(m_min_lat_plot - lat_range*g_map_overdraw/2.),
 			static_cast<t_real_map>(m_max_lat_plot + lat_range*g_map_overdraw/2.));
 
 		// load the generated svg image
-		m_map_image = QByteArray{ostr.str().c_str(), static_cast<int>(ostr.str().size())};
+		m_map_image = QByteArray{m_map_svg.data(), static_cast<int>(m_map_svg.size())};
 		m_map->load(m_map_image);
 	}
 
@@ -857,6 +891,83 @@ void TrackInfos::PlotMap(bool load_cached)
 }
 
 
+/**
+ * render a heat map of all tracks as map image
+ */
+void TrackInfos::PlotHeatmap()
+{
+	if(!m_map)
+		return;
+
+	if(!m_trackdb || m_trackdb->GetTrackCount() == 0)
+	{
+		QMessageBox::warning(this, "Warning", "No tracks are loaded.");
+		return;
+	}
+
+	std::vector<const t_track*> tracks = m_trackdb->GetTracks();
+
+	// coordinate range of all tracks
+	t_real min_lon = std::numeric_limits<t_real>::max(), max_lon = -min_lon;
+	t_real min_lat = std::numeric_limits<t_real>::max(), max_lat = -min_lat;
+	for(const t_track *track : tracks)
+	{
+		if(track->GetPoints().size() == 0)
+			continue;
+
+		auto [ track_min_lon, track_max_lon ] = track->GetLongitudeRange();
+		auto [ track_min_lat, track_max_lat ] = track->GetLatitudeRange();
+		min_lon = std::min(min_lon, track_min_lon);
+		max_lon = std::max(max_lon, track_max_lon);
+		min_lat = std::min(min_lat, track_min_lat);
+		max_lat = std::max(max_lat, track_max_lat);
+	}
+
+	if(min_lon > max_lon || min_lat > max_lat)
+		return;
+
+	// choose the largest zoom level for which the image is not too large
+	using t_heatmap = Heatmap<t_real, t_size>;
+	const t_real max_pixels = std::min<t_real>(2048. * g_map_scale, t_heatmap::MAX_IMAGE_SIZE);
+	t_heatmap heatmap;
+	heatmap.SetNumThreads(static_cast<unsigned int>(g_num_threads));
+	for(unsigned int zoom = 18; zoom > 0; --zoom)
+	{
+		heatmap.SetZoom(zoom);
+		auto rect = heatmap.GetRect(min_lon, max_lon, min_lat, max_lat);
+		if(rect.GetWidth() <= max_pixels && rect.GetHeight() <= max_pixels)
+			break;
+	}
+
+	heatmap.AddTracks(tracks);
+	const auto& bounds = heatmap.GetBounds();
+
+	std::ostringstream ostr_png;
+	if(!heatmap.ExportPng(ostr_png, bounds))
+	{
+		emit StatusMessageChanged("Error: No heat map could be generated.");
+		return;
+	}
+
+	// embed the png image into an svg image
+	QByteArray png{ostr_png.str().c_str(), static_cast<int>(ostr_png.str().size())};
+	std::ostringstream ostr;
+	ostr << "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\""
+		<< " width=\"" << bounds.GetWidth() << "\" height=\"" << bounds.GetHeight() << "\""
+		<< " viewBox=\"0 0 " << bounds.GetWidth() << " " << bounds.GetHeight() << "\">\n"
+		<< "<rect width=\"100%\" height=\"100%\" fill=\"#202020\"/>\n"
+		<< "<image width=\"" << bounds.GetWidth() << "\" height=\"" << bounds.GetHeight() << "\""
+		<< " xlink:href=\"data:image/png;base64," << png.toBase64().toStdString() << "\"/>\n"
+		<< "</svg>\n";
+
+	m_map_image = QByteArray{ostr.str().c_str(), static_cast<int>(ostr.str().size())};
+	m_map->load(m_map_image);
+
+	emit StatusMessageChanged(QString("Heat map of %1 tracks at zoom level %2.")
+		.arg(tracks.size()).arg(heatmap.GetZoom()));
+}
+
+
 /**
  * save a plot as a pdf image
  */
@@ -935,6 +1046,12 @@ void TrackInfos::SaveMapSvg()
 }
 
 
+void TrackInfos::SetTrackDB(const t_tracks *trackdb)
+{
+	m_trackdb = trackdb;
+}
+
+
 void TrackInfos::Clear()
 {
 	m_track = nullptr;
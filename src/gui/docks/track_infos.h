@@ -51,6 +51,7 @@ public:
 
 	void Clear();
 	void ShowTrack(t_track *track);
+	void SetTrackDB(const t_tracks *trackdb);
 
 
 protected:
@@ -71,6 +72,7 @@ protected:
 	void MapMouseClick(QMouseEvent *evt);
 	void SelectMap();
 	void PlotMap(bool load_cached = false);
+	void PlotHeatmap();
 	void SaveMapSvg();
 
 	void PacePlotMouseMove(QMouseEvent *evt);
@@ -120,6 +122,7 @@ private:
 
 	// svg image of the map
 	QByteArray m_map_image{};
+	std::string m_map_svg{};
 
 	// track coordinate ranges
 	t_real m_min_long{}, m_max_long{};
@@ -140,6 +143,9 @@ private:
 	// currently selected track
 	t_track *m_track{};
 
+	// all tracks, for the heat map
+	const t_tracks *m_trackdb{};
+
 	// directory with recently used map files
 	std::string m_mapdir{};
 
@@ -51,6 +51,7 @@ t_real g_map_scale = 1.;
 t_real g_map_overdraw = 0.1;
 bool g_map_show_buildings = false;
 bool g_map_show_labels = false;
+bool g_map_two_pass = false;
 
 
 // directory for temporary files
@@ -12,6 +12,7 @@
 #include "common/types.h"
 #include "lib/trackdb.h"
 #include "lib/map.h"
+#include "lib/mapcache.h"
 
 #include <QtCore/QString>
 
@@ -24,6 +25,7 @@ using t_track_pt = typename t_track::t_trackpt;
 
 // map types
 using t_map = Map<t_real_map, t_size_map>;
+using t_map_cache = MapCache<t_real_map>;
 
 
 // epsilon and precision values
@@ -61,6 +63,7 @@ extern t_real g_map_scale;
 extern t_real g_map_overdraw;
 extern bool g_map_show_buildings;
 extern bool g_map_show_labels;
+extern bool g_map_two_pass;
 
 
 // directory for temporary files
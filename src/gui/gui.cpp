@@ -19,6 +19,7 @@
 #include <QtWidgets/QStatusBar>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QProgressDialog>
 #include <QtWidgets/QStyleFactory>
 #include <QtSvg/QSvgGenerator>
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -27,6 +28,8 @@
 	#include <QtWidgets/QActionGroup>
 #endif
 
+#include <utility>
+
 #include "helpers.h"
 #include "common/version.h"
 
@@ -77,6 +80,7 @@ void TracksWnd::SetupGUI()
 	m_track->setObjectName("TrackInfos");
 	//setCentralWidget(m_track.get());
 	addDockWidget(Qt::RightDockWidgetArea, m_track.get());
+	m_track->GetWidget()->SetTrackDB(&m_trackdb);
 
 	m_tracks = std::make_shared<DockWidgetWrapper<TrackBrowser>>(this);
 	m_tracks->setWindowTitle("Track Browser");
@@ -102,6 +106,7 @@ void TracksWnd::SetupGUI()
 	});
 	connect(m_track->GetWidget(), &TrackInfos::TrackChanged, [this]()
 	{
+		m_trackdb.TrackModified(m_tracks->GetWidget()->GetCurrentTrackIndex());
 		SetWindowModified(true);
 	});
 
@@ -184,19 +189,8 @@ void TracksWnd::SetupGUI()
 	QAction *actionRecalc = new QAction{iconRecalc, "Recalculate", this};
 	connect(actionRecalc, &QAction::triggered, [this]()
 	{
-		m_trackdb.Calculate();
-		if(m_statistics)
-			m_statistics->PlotSpeeds();
-		if(m_reports)
-			m_reports->CalcDistances();
-		if(m_summary)
-			m_summary->FillTable();
-
-		// refresh selected track
-		if(m_tracks)
-			NewTrackSelected(m_tracks->GetWidget()->GetCurrentTrackIndex());
-
-		SetStatusMessage("Recalculated all values.");
+		// recalculate everything if no settings have changed
+		RecalculateTracks(m_trackdb.GetDirtyTrackCount() > 0);
 	});
 
 	QIcon iconResort = QIcon::fromTheme("view-sort-descending");
@@ -387,6 +381,12 @@ void TracksWnd::SetupGUI()
 	actionAbout->setMenuRole(QAction::AboutRole);
 	connect(actionAbout, &QAction::triggered, this, &TracksWnd::ShowAbout);
 
+	QIcon iconDiagnostics = QIcon::fromTheme("utilities-system-monitor");
+	QAction *actionDiagnostics = new QAction{iconDiagnostics, "Diagnostics...", this};
+	connect(actionDiagnostics, &QAction::triggered, this, &TracksWnd::ShowDiagnostics);
+
+	menuHelp->addAction(actionDiagnostics);
+	menuHelp->addSeparator();
 	menuHelp->addAction(actionAbout);
 	// ------------------------------------------------------------------------
 
@@ -538,7 +538,7 @@ void TracksWnd::PopulateTrackList(bool resort)
 
 	for(t_size trackidx = 0; trackidx < m_trackdb.GetTrackCount(); ++trackidx)
 	{
-		const t_track *track = m_trackdb.GetTrack(trackidx);
+		const t_track *track = std::as_const(m_trackdb).GetTrack(trackidx);
 		if(!track)
 			continue;
 
@@ -588,6 +588,7 @@ void TracksWnd::TrackNameChanged(t_size idx, const std::string& name)
 	if(t_track *track = GetTrack(idx); track)
 	{
 		track->SetFileName(name);
+		m_trackdb.TrackModified(idx);
 		SetWindowModified(true);
 	}
 }
@@ -788,14 +789,6 @@ bool TracksWnd::FileImport()
 	fs::path file{files[0].toStdString()};
 	m_recent.SetRecentImportDir(file.parent_path().string().c_str());
 
-	if(QMessageBox::question(this, "Sort Tracks?",
-		"New tracks have been inserted to the end of the list. "
-		"Re-sort the track list?") == QMessageBox::Yes)
-	{
-		PopulateTrackList(true);
-		SetStatusMessage(QString("%1 track(s) imported and sorted.").arg(files.size()));
-	}
-
 	SetWindowModified(true);
 	return true;
 }
@@ -841,26 +834,57 @@ bool TracksWnd::LoadFile(const QString& filename)
  */
 bool TracksWnd::ImportFiles(const QStringList& filenames)
 {
+	std::vector<std::string> files;
+	files.reserve(filenames.size());
 	for(const QString& filename : filenames)
+		files.push_back(filename.toStdString());
+
+	// import progress
+	QProgressDialog progress_dlg{this};
+	progress_dlg.setMinimumDuration(500);
+	progress_dlg.setAutoClose(true);
+	progress_dlg.setWindowModality(Qt::WindowModal);
+	progress_dlg.setWindowTitle(TRACKS_TITLE);
+	progress_dlg.setLabelText("Importing tracks...");
+
+	// import progress callback
+	std::function<bool(t_size, t_size)> progress = [&progress_dlg](
+		t_size num_done, t_size num_total) -> bool
 	{
-		t_track track{};
-		track.SetDistanceFunction(g_dist_func);
-		track.SetAscentEpsilon(g_asc_eps);
-		track.SetSmoothRadius(g_smooth_rad);
+		progress_dlg.setRange(0, static_cast<int>(num_total));
+		progress_dlg.setValue(static_cast<int>(num_done));
 
-		if(!track.Import(filename.toStdString(), g_assume_dt))
-		{
-			SetStatusMessage(QString("Error importing file \"%1\".").arg(filename));
-			return false;
-		}
+		return !progress_dlg.wasCanceled();
+	};
 
-		t_real epoch = std::chrono::duration_cast<typename t_track::t_sec>(
-			track.GetStartTime()->time_since_epoch()).count();
-		m_tracks->GetWidget()->AddTrack(track.GetFileName(), m_trackdb.GetTrackCount(), epoch);
-		m_trackdb.EmplaceTrack(std::move(track));
+	// the tracks are parsed in parallel and inserted in time order
+	std::vector<std::string> failed_files;
+	t_size num_imported = m_trackdb.ImportFiles(files, g_assume_dt, &progress, &failed_files);
+
+	if(progress_dlg.wasCanceled())
+	{
+		SetStatusMessage("Track import cancelled.");
+		return false;
 	}
 
-	SetStatusMessage(QString("%1 track(s) imported.").arg(filenames.size()));
+	if(failed_files.size())
+	{
+		QString msg = QString("%1 file(s) could not be imported:").arg(failed_files.size());
+		for(const std::string& filename : failed_files)
+			msg += QString("\n%1").arg(filename.c_str());
+
+		if(num_imported)
+			QMessageBox::warning(this, "Warning", msg);
+		SetStatusMessage(QString("Error importing file \"%1\".").arg(failed_files.begin()->c_str()));
+	}
+
+	if(!num_imported)
+		return false;
+
+	PopulateTrackList(false);
+
+	if(!failed_files.size())
+		SetStatusMessage(QString("%1 track(s) imported.").arg(num_imported));
 	return true;
 }
 
@@ -912,6 +936,8 @@ void TracksWnd::ShowSettings(bool only_create)
 			"Show buildings in map.", g_map_show_buildings);
 		m_settings->AddCheckbox("settings/show_labels",
 			"Show labels in map.", g_map_show_labels);
+		m_settings->AddCheckbox("settings/map_two_pass",
+			"Read map files in two passes (only saves memory for full-extent maps).", g_map_two_pass);
 		m_settings->AddCheckbox("settings/show_icons",
 			"Show icons in text.", g_show_icons);
 
@@ -962,6 +988,8 @@ void TracksWnd::ApplySettings()
 		value<decltype(g_map_show_buildings)>();
 	g_map_show_labels = m_settings->GetValue("settings/show_labels").
 		value<decltype(g_map_show_labels)>();
+	g_map_two_pass = m_settings->GetValue("settings/map_two_pass").
+		value<decltype(g_map_two_pass)>();
 	g_show_icons = m_settings->GetValue("settings/show_icons").
 		value<decltype(g_show_icons)>();
 	g_reload_last = m_settings->GetValue("settings/load_last_file").
@@ -973,10 +1001,37 @@ void TracksWnd::ApplySettings()
 	m_trackdb.SetDistanceFunction(g_dist_func);
 	m_trackdb.SetAscentEpsilon(g_asc_eps);
 	m_trackdb.SetSmoothRadius(g_smooth_rad);
+
+	// only recalculates the values depending on changed settings
+	if(m_trackdb.GetDirtyTrackCount() > 0)
+		RecalculateTracks(true);
+
 	update();
 }
 
 
+/**
+ * recalculate the track values and refresh the views
+ * @param only_dirty only recalculate the values depending on changed settings
+ */
+void TracksWnd::RecalculateTracks(bool only_dirty)
+{
+	t_size num_calculated = m_trackdb.Calculate(only_dirty);
+	if(m_statistics)
+		m_statistics->PlotSpeeds();
+	if(m_reports)
+		m_reports->CalcDistances();
+	if(m_summary)
+		m_summary->FillTable();
+
+	// refresh selected track
+	if(m_tracks)
+		NewTrackSelected(m_tracks->GetWidget()->GetCurrentTrackIndex());
+
+	SetStatusMessage(QString("Recalculated the values of %1 track(s).").arg(num_calculated));
+}
+
+
 void TracksWnd::CreateTempDir()
 {
 	if(g_temp_dir == "")
@@ -1072,6 +1127,18 @@ void TracksWnd::ShowTracksSummary()
 }
 
 
+/**
+ * show profiling results
+ */
+void TracksWnd::ShowDiagnostics()
+{
+	if(!m_diagnostics)
+		m_diagnostics = std::make_shared<DiagnosticsDlg>(this);
+
+	show_dialog(m_diagnostics.get());
+}
+
+
 /**
  * show about dialog
  */
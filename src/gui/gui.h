@@ -32,6 +32,7 @@
 #include "dialogs/distances.h"
 #include "dialogs/tracks.h"
 #include "dialogs/settings.h"
+#include "dialogs/diagnostics.h"
 #include "dialogs/about.h"
 
 // lib
@@ -100,6 +101,7 @@ public:
 	bool SaveFile(const QString& filename) const;
 	bool LoadFile(const QString& filename);
 	bool ImportFiles(const QStringList& filenames);
+	void RecalculateTracks(bool only_dirty = true);
 
 	// dialogs
 	void ShowSettings(bool only_create = false);
@@ -108,6 +110,7 @@ public:
 	void ShowPaceStatistics();
 	void ShowDistanceReports();
 	void ShowTracksSummary();
+	void ShowDiagnostics();
 	void ShowAbout();
 
 	Resources& GetResources() { return m_res; }
@@ -160,6 +163,7 @@ private:
 	std::shared_ptr<PacesDlg> m_statistics{};
 	std::shared_ptr<DistancesDlg> m_reports{};
 	std::shared_ptr<TracksDlg> m_summary{};
+	std::shared_ptr<DiagnosticsDlg> m_diagnostics{};
 
 	t_tracks m_trackdb{};
 
@@ -0,0 +1,255 @@
+/**
+ * storage of objects indexed by dense ids
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_DENSE_STORE_H__
+#define __TRACKS_DENSE_STORE_H__
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <concepts>
+#include <cstddef>
+
+
+
+/**
+ * container for objects with ids handed out sequentially from zero
+ *
+ * The objects are stored in a vector indexed by their id, a bitmap marks
+ * which ids are occupied. Looking up an object is an index operation and
+ * iteration visits the objects in the order of their ids.
+ */
+template<class t_obj, class t_size = std::size_t>
+requires std::integral<t_size>
+class DenseStore
+{
+public:
+	/**
+	 * iterator over the occupied ids, dereferencing gives an (id, object) pair
+	 */
+	template<bool is_const>
+	class Iterator
+	{
+	public:
+		using t_store = std::conditional_t<is_const, const DenseStore, DenseStore>;
+		using t_ref = std::conditional_t<is_const, const t_obj&, t_obj&>;
+
+
+	public:
+		Iterator(t_store *store, t_size idx)
+			: m_store{store}, m_idx{idx}
+		{
+			SkipFree();
+		}
+
+
+		std::pair<t_size, t_ref> operator*() const
+		{
+			return std::pair<t_size, t_ref>{ m_idx, m_store->m_objs[m_idx] };
+		}
+
+
+		Iterator& operator++()
+		{
+			++m_idx;
+			SkipFree();
+			return *this;
+		}
+
+
+		bool operator==(const Iterator& other) const
+		{
+			return m_idx == other.m_idx;
+		}
+
+
+		bool operator!=(const Iterator& other) const
+		{
+			return m_idx != other.m_idx;
+		}
+
+
+	protected:
+		void SkipFree()
+		{
+			while(m_idx < m_store->m_used.size() && !m_store->m_used[m_idx])
+				++m_idx;
+		}
+
+
+	private:
+		t_store *m_store{};
+		t_size m_idx{};
+	};
+
+
+
+public:
+	DenseStore() = default;
+	~DenseStore() = default;
+
+	DenseStore(const DenseStore&) = default;
+	DenseStore& operator=(const DenseStore&) = default;
+	DenseStore(DenseStore&&) = default;
+	DenseStore& operator=(DenseStore&&) = default;
+
+
+
+	/**
+	 * insert an object unless its id is already occupied,
+	 * mirrors std::unordered_map::emplace
+	 */
+	bool emplace(std::pair<t_size, t_obj>&& entry)
+	{
+		return Insert(entry.first, std::move(entry.second));
+	}
+
+
+
+	/**
+	 * insert an object unless its id is already occupied
+	 */
+	bool Insert(t_size id, t_obj&& obj)
+	{
+		if(id >= m_objs.size())
+		{
+			m_objs.resize(id + 1);
+			m_used.resize(id + 1, false);
+		}
+		else if(m_used[id])
+		{
+			return false;
+		}
+
+		m_objs[id] = std::move(obj);
+		m_used[id] = true;
+		++m_size;
+		return true;
+	}
+
+
+
+	/**
+	 * reserve slots for the ids below the given one
+	 */
+	void Reserve(t_size id_range)
+	{
+		m_objs.reserve(id_range);
+		m_used.reserve(id_range);
+	}
+
+
+
+	t_obj* Find(t_size id)
+	{
+		if(id >= m_objs.size() || !m_used[id])
+			return nullptr;
+		return &m_objs[id];
+	}
+
+
+
+	const t_obj* Find(t_size id) const
+	{
+		if(id >= m_objs.size() || !m_used[id])
+			return nullptr;
+		return &m_objs[id];
+	}
+
+
+
+	bool Erase(t_size id)
+	{
+		if(id >= m_objs.size() || !m_used[id])
+			return false;
+
+		m_objs[id] = t_obj{};
+		m_used[id] = false;
+		--m_size;
+		return true;
+	}
+
+
+
+	/**
+	 * remove all objects fulfilling the predicate
+	 */
+	template<class t_pred>
+	t_size EraseIf(t_pred&& pred)
+	{
+		t_size num_erased = 0;
+
+		for(t_size id = 0; id < static_cast<t_size>(m_objs.size()); ++id)
+		{
+			if(!m_used[id] || !pred(m_objs[id]))
+				continue;
+
+			m_objs[id] = t_obj{};
+			m_used[id] = false;
+			++num_erased;
+		}
+
+		m_size -= num_erased;
+		return num_erased;
+	}
+
+
+
+	void Clear()
+	{
+		m_objs.clear();
+		m_used.clear();
+		m_size = 0;
+	}
+
+
+
+	/**
+	 * number of stored objects
+	 */
+	t_size size() const
+	{
+		return m_size;
+	}
+
+
+
+	/**
+	 * one past the highest id that has been occupied
+	 */
+	t_size GetIdRange() const
+	{
+		return static_cast<t_size>(m_objs.size());
+	}
+
+
+
+	/**
+	 * heap memory of the object slots and the bitmap
+	 */
+	std::size_t GetMemory() const
+	{
+		return m_objs.capacity() * sizeof(t_obj) + m_used.capacity() / 8;
+	}
+
+
+
+	Iterator<false> begin() { return Iterator<false>{this, 0}; }
+	Iterator<false> end() { return Iterator<false>{this, static_cast<t_size>(m_objs.size())}; }
+	Iterator<true> begin() const { return Iterator<true>{this, 0}; }
+	Iterator<true> end() const { return Iterator<true>{this, static_cast<t_size>(m_objs.size())}; }
+
+
+
+private:
+	std::vector<t_obj> m_objs{};
+	std::vector<bool> m_used{};
+	t_size m_size{};
+};
+
+
+#endif
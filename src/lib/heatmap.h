@@ -0,0 +1,759 @@
+/**
+ * density heat map of tracks
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACK_HEATMAP_H__
+#define __TRACK_HEATMAP_H__
+
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <algorithm>
+#include <concepts>
+
+#include <boost/asio.hpp>
+
+
+
+/**
+ * rasterises tracks into a tiled density grid in web mercator projection
+ * @see https://en.wikipedia.org/wiki/Web_Mercator_projection
+ * @see https://wiki.openstreetmap.org/wiki/Slippy_map_tilenames
+ */
+template<class t_real = double, class t_size = std::size_t>
+requires std::floating_point<t_real> && std::integral<t_size>
+class Heatmap
+{
+public:
+	using t_count = std::uint32_t;
+	using t_pix = std::uint32_t;
+
+	static constexpr t_pix TILE_BITS = 8;
+	static constexpr t_pix TILE_SIZE = t_pix(1) << TILE_BITS;
+
+	// maximum width and height of exported images
+	static constexpr t_pix MAX_IMAGE_SIZE = 16384;
+
+	using t_tile = std::array<t_count, TILE_SIZE * TILE_SIZE>;
+	using t_tilekey = std::uint64_t;
+	using t_tiles = std::unordered_map<t_tilekey, std::unique_ptr<t_tile>>;
+
+	// pixel rectangle [x0, x1) x [y0, y1)
+	struct Rect
+	{
+		t_pix x0{std::numeric_limits<t_pix>::max()}, y0{std::numeric_limits<t_pix>::max()};
+		t_pix x1{0}, y1{0};
+
+		bool IsEmpty() const { return x1 <= x0 || y1 <= y0; }
+		t_pix GetWidth() const { return IsEmpty() ? 0 : x1 - x0; }
+		t_pix GetHeight() const { return IsEmpty() ? 0 : y1 - y0; }
+		bool IsExportable() const { return !IsEmpty() && GetWidth() <= MAX_IMAGE_SIZE && GetHeight() <= MAX_IMAGE_SIZE; }
+
+		void Add(t_pix x, t_pix y)
+		{
+			x0 = std::min(x0, x); x1 = std::max(x1, x + 1);
+			y0 = std::min(y0, y); y1 = std::max(y1, y + 1);
+		}
+
+		void Add(const Rect& rect)
+		{
+			if(rect.IsEmpty())
+				return;
+			x0 = std::min(x0, rect.x0); x1 = std::max(x1, rect.x1);
+			y0 = std::min(y0, rect.y0); y1 = std::max(y1, rect.y1);
+		}
+	};
+
+
+
+public:
+	Heatmap() = default;
+	~Heatmap() = default;
+
+	Heatmap(const Heatmap&) = delete;
+	Heatmap& operator=(const Heatmap&) = delete;
+
+
+
+	void Clear()
+	{
+		m_tiles.clear();
+		m_bounds = Rect{};
+		m_max_count = 0;
+	}
+
+
+
+	/**
+	 * zoom level, the world is 2^zoom tiles wide
+	 */
+	void SetZoom(unsigned int zoom)
+	{
+		m_zoom = std::clamp(zoom, 0u, 23u);
+		Clear();
+	}
+
+
+
+	unsigned int GetZoom() const
+	{
+		return m_zoom;
+	}
+
+
+
+	void SetNumThreads(unsigned int num)
+	{
+		m_num_threads = std::max(num, 1u);
+	}
+
+
+
+	/**
+	 * global pixel coordinates of a [lon, lat] point [rad]
+	 */
+	std::pair<t_real, t_real> Project(t_real lon, t_real lat) const
+	{
+		namespace num = std::numbers;
+
+		// limit of the projection, ±85.0511°
+		const t_real max_lat = std::atan(std::sinh(num::pi_v<t_real>));
+		lat = std::clamp(lat, -max_lat, max_lat);
+
+		const t_real world = t_real(TILE_SIZE) * std::exp2(t_real(m_zoom));
+		t_real x = (lon + num::pi_v<t_real>) / (t_real(2) * num::pi_v<t_real>) * world;
+		t_real y = (t_real(1) - std::asinh(std::tan(lat)) / num::pi_v<t_real>) / t_real(2) * world;
+
+		return std::make_pair(x, y);
+	}
+
+
+
+	/**
+	 * [lon, lat] point [rad] of global pixel coordinates
+	 */
+	std::pair<t_real, t_real> Unproject(t_real x, t_real y) const
+	{
+		namespace num = std::numbers;
+
+		const t_real world = t_real(TILE_SIZE) * std::exp2(t_real(m_zoom));
+		t_real lon = x / world * t_real(2) * num::pi_v<t_real> - num::pi_v<t_real>;
+		t_real lat = std::atan(std::sinh(num::pi_v<t_real> * (t_real(1) - t_real(2) * y / world)));
+
+		return std::make_pair(lon, lat);
+	}
+
+
+
+	/**
+	 * pixel rectangle covering the given [lon, lat] ranges [rad]
+	 */
+	Rect GetRect(t_real min_lon, t_real max_lon, t_real min_lat, t_real max_lat) const
+	{
+		auto [ x0, y1 ] = Project(min_lon, min_lat);
+		auto [ x1, y0 ] = Project(max_lon, max_lat);
+
+		Rect rect{};
+		rect.x0 = ClampPixel(x0); rect.x1 = ClampPixel(x1) + 1;
+		rect.y0 = ClampPixel(y0); rect.y1 = ClampPixel(y1) + 1;
+		return rect;
+	}
+
+
+
+	/**
+	 * pixel rectangle containing all track points
+	 */
+	const Rect& GetBounds() const
+	{
+		return m_bounds;
+	}
+
+
+
+	t_count GetMaxCount() const
+	{
+		return m_max_count;
+	}
+
+
+
+	t_size GetTileCount() const
+	{
+		return m_tiles.size();
+	}
+
+
+
+	/**
+	 * number of track segments passing through a pixel
+	 */
+	t_count GetCount(t_pix x, t_pix y) const
+	{
+		auto iter = m_tiles.find(GetTileKey(x >> TILE_BITS, y >> TILE_BITS));
+		if(iter == m_tiles.end())
+			return 0;
+
+		return (*iter->second)[GetTileOffset(x, y)];
+	}
+
+
+
+	/**
+	 * accumulate the segments of all given tracks
+	 * each thread rasterises a share of the tracks into its own tiles,
+	 * which are then summed up by key partition without locking
+	 */
+	template<class t_track>
+	bool AddTracks(const std::vector<const t_track*>& tracks,
+		std::function<bool(t_size, t_size)> *progress = nullptr)
+	{
+		const t_size num_tracks = tracks.size();
+		const unsigned int num_threads = static_cast<unsigned int>(
+			std::min<t_size>(m_num_threads, std::max<t_size>(num_tracks, 1)));
+
+		std::vector<t_tiles> thread_tiles(num_threads);
+		std::vector<Rect> thread_bounds(num_threads);
+		std::atomic<t_size> tracks_done{0};
+		std::atomic<bool> stop_request{false};
+
+		// rasterisation
+		{
+			boost::asio::thread_pool tp{num_threads};
+
+			for(unsigned int thread = 0; thread < num_threads; ++thread)
+			{
+				boost::asio::post(tp, [this, thread, num_threads, num_tracks, &tracks,
+					&thread_tiles, &thread_bounds, &tracks_done, &stop_request]() -> void
+				{
+					for(t_size trackidx = thread; trackidx < num_tracks; trackidx += num_threads)
+					{
+						if(stop_request)
+							break;
+						if(tracks[trackidx])
+						{
+							RasteriseTrack(*tracks[trackidx],
+								thread_tiles[thread], thread_bounds[thread]);
+						}
+						++tracks_done;
+					}
+				});
+			}
+
+			// report progress from the calling thread
+			if(progress)
+			{
+				while(tracks_done < num_tracks)
+				{
+					if(!(*progress)(tracks_done, num_tracks))
+					{
+						stop_request = true;
+						break;
+					}
+					std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				}
+			}
+
+			tp.join();
+		}
+
+		if(stop_request)
+			return false;
+
+		// merge the tiles of the threads, each merging task owns a partition of the keys
+		std::vector<t_tiles> merged(num_threads);
+		std::vector<t_count> merged_max(num_threads, 0);
+		{
+			boost::asio::thread_pool tp{num_threads};
+
+			for(unsigned int part = 0; part < num_threads; ++part)
+			{
+				boost::asio::post(tp, [this, part, num_threads,
+					&thread_tiles, &merged, &merged_max]() -> void
+				{
+					t_tiles& dst_tiles = merged[part];
+
+					for(t_tiles& src_tiles : thread_tiles)
+					{
+						for(auto& [ key, src_tile ] : src_tiles)
+						{
+							if(std::hash<t_tilekey>{}(key) % num_threads != part)
+								continue;
+
+							// also add the already existing tiles of this heatmap
+							auto iter = dst_tiles.find(key);
+							if(iter == dst_tiles.end())
+							{
+								auto old_iter = m_tiles.find(key);
+								if(old_iter == m_tiles.end())
+								{
+									dst_tiles.emplace(key, std::move(src_tile));
+									continue;
+								}
+
+								iter = dst_tiles.emplace(key, std::make_unique<t_tile>(*old_iter->second)).first;
+							}
+
+							t_tile& dst = *iter->second;
+							const t_tile& src = *src_tile;
+							for(t_size pix = 0; pix < dst.size(); ++pix)
+								dst[pix] += src[pix];
+						}
+					}
+
+					for(const auto& [ key, tile ] : dst_tiles)
+						merged_max[part] = std::max(merged_max[part], *std::max_element(tile->begin(), tile->end()));
+				});
+			}
+
+			tp.join();
+		}
+
+		for(t_size part = 0; part < merged.size(); ++part)
+		{
+			for(auto& [ key, tile ] : merged[part])
+				m_tiles.insert_or_assign(key, std::move(tile));
+
+			m_max_count = std::max(m_max_count, merged_max[part]);
+		}
+
+		for(const Rect& rect : thread_bounds)
+			m_bounds.Add(rect);
+
+		if(progress)
+			(*progress)(num_tracks, num_tracks);
+		return true;
+	}
+
+
+
+	/**
+	 * get the 8-bit intensities of a pixel rectangle, logarithmically scaled,
+	 * rectangles larger than MAX_IMAGE_SIZE give an empty image
+	 */
+	std::vector<std::uint8_t> GetImage(const Rect& rect) const
+	{
+		if(!rect.IsExportable())
+			return {};
+
+		const t_pix w = rect.GetWidth(), h = rect.GetHeight();
+		std::vector<std::uint8_t> img(std::size_t(w) * std::size_t(h), 0);
+		if(!m_max_count || !w || !h)
+			return img;
+
+		// lookup table for small counts
+		const t_real log_max = std::log1p(t_real(m_max_count));
+		auto intensity = [log_max](t_count count) -> std::uint8_t
+		{
+			if(!count)
+				return 0;
+			t_real val = std::log1p(t_real(count)) / log_max;
+			return static_cast<std::uint8_t>(std::clamp<t_real>(
+				t_real(1) + val * t_real(254), t_real(1), t_real(255)));
+		};
+
+		std::array<std::uint8_t, 256> lut{};
+		for(t_count count = 0; count < lut.size(); ++count)
+			lut[count] = intensity(count);
+
+		// iterate the tiles intersecting the rectangle
+		for(t_pix ty = rect.y0 >> TILE_BITS; ty <= (rect.y1 - 1) >> TILE_BITS; ++ty)
+		{
+			for(t_pix tx = rect.x0 >> TILE_BITS; tx <= (rect.x1 - 1) >> TILE_BITS; ++tx)
+			{
+				auto iter = m_tiles.find(GetTileKey(tx, ty));
+				if(iter == m_tiles.end())
+					continue;
+				const t_tile& tile = *iter->second;
+
+				const t_pix x0 = std::max(rect.x0, tx << TILE_BITS);
+				const t_pix x1 = std::min(rect.x1, (tx + 1) << TILE_BITS);
+				const t_pix y0 = std::max(rect.y0, ty << TILE_BITS);
+				const t_pix y1 = std::min(rect.y1, (ty + 1) << TILE_BITS);
+
+				for(t_pix y = y0; y < y1; ++y)
+				{
+					for(t_pix x = x0; x < x1; ++x)
+					{
+						t_count count = tile[GetTileOffset(x, y)];
+						img[std::size_t(y - rect.y0) * w + (x - rect.x0)] =
+							count < lut.size() ? lut[count] : intensity(count);
+					}
+				}
+			}
+		}
+
+		return img;
+	}
+
+
+
+	/**
+	 * write a greyscale pgm image
+	 * @see https://netpbm.sourceforge.net/doc/pgm.html
+	 */
+	bool ExportPgm(std::ostream& ostr, const Rect& rect) const
+	{
+		if(!rect.IsExportable())
+			return false;
+
+		std::vector<std::uint8_t> img = GetImage(rect);
+		ostr << "P5\n" << rect.GetWidth() << " " << rect.GetHeight() << "\n255\n";
+		ostr.write(reinterpret_cast<const char*>(img.data()), img.size());
+
+		return !!ostr;
+	}
+
+
+
+	/**
+	 * write a png image with a heat colour palette and transparent background
+	 * @see https://www.w3.org/TR/png/
+	 */
+	bool ExportPng(std::ostream& ostr, const Rect& rect) const
+	{
+		if(!rect.IsExportable())
+			return false;
+
+		const t_pix w = rect.GetWidth(), h = rect.GetHeight();
+		std::vector<std::uint8_t> img = GetImage(rect);
+
+		// scanlines, each prefixed by filter type 0
+		std::vector<std::uint8_t> raw;
+		raw.reserve(img.size() + h);
+		for(t_pix y = 0; y < h; ++y)
+		{
+			raw.push_back(0);
+			raw.insert(raw.end(), img.begin() + std::size_t(y) * w,
+				img.begin() + std::size_t(y + 1) * w);
+		}
+
+		// black -> red -> yellow -> white palette
+		std::vector<std::uint8_t> palette;
+		palette.reserve(256 * 3);
+		for(unsigned int idx = 0; idx < 256; ++idx)
+		{
+			t_real t = idx ? t_real(0.25) + t_real(0.75) * t_real(idx) / t_real(255) : t_real(0);
+			palette.push_back(static_cast<std::uint8_t>(std::clamp<t_real>(t*t_real(3), 0, 1) * t_real(255)));
+			palette.push_back(static_cast<std::uint8_t>(std::clamp<t_real>(t*t_real(3) - 1, 0, 1) * t_real(255)));
+			palette.push_back(static_cast<std::uint8_t>(std::clamp<t_real>(t*t_real(3) - 2, 0, 1) * t_real(255)));
+		}
+
+		std::vector<std::uint8_t> header;
+		WriteBE(header, w);
+		WriteBE(header, h);
+		header.push_back(8);  // bit depth
+		header.push_back(3);  // indexed colours
+		header.push_back(0);  // compression
+		header.push_back(0);  // filter
+		header.push_back(0);  // interlace
+
+		static constexpr std::uint8_t sig[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+		ostr.write(reinterpret_cast<const char*>(sig), sizeof(sig));
+
+		WritePngChunk(ostr, "IHDR", header);
+		WritePngChunk(ostr, "PLTE", palette);
+		WritePngChunk(ostr, "tRNS", std::vector<std::uint8_t>{ 0 });  // index 0 is transparent
+		WritePngChunk(ostr, "IDAT", Deflate(raw));
+		WritePngChunk(ostr, "IEND", std::vector<std::uint8_t>{});
+
+		return !!ostr;
+	}
+
+
+
+	/**
+	 * write a png or pgm image, depending on the file extension
+	 */
+	bool Export(const std::string& filename, const std::optional<Rect>& rect = std::nullopt) const
+	{
+		std::ofstream ofstr(filename, std::ios_base::binary);
+		if(!ofstr)
+			return false;
+
+		const Rect& region = rect ? *rect : m_bounds;
+		if(filename.ends_with(".pgm"))
+			return ExportPgm(ofstr, region);
+		return ExportPng(ofstr, region);
+	}
+
+
+
+protected:
+	static t_tilekey GetTileKey(t_pix tx, t_pix ty)
+	{
+		return (t_tilekey(tx) << 32) | t_tilekey(ty);
+	}
+
+
+
+	static t_size GetTileOffset(t_pix x, t_pix y)
+	{
+		return (t_size(y & (TILE_SIZE - 1)) << TILE_BITS) | t_size(x & (TILE_SIZE - 1));
+	}
+
+
+
+	t_pix ClampPixel(t_real coord) const
+	{
+		const t_real world = t_real(TILE_SIZE) * std::exp2(t_real(m_zoom));
+		return static_cast<t_pix>(std::clamp(std::floor(coord), t_real(0), world - t_real(1)));
+	}
+
+
+
+	/**
+	 * draw the segments of a track with bresenham's algorithm,
+	 * the starting pixel of each segment is skipped as it ends the previous one
+	 * @see https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
+	 */
+	template<class t_track>
+	void RasteriseTrack(const t_track& track, t_tiles& tiles, Rect& bounds) const
+	{
+		t_tilekey cur_key = std::numeric_limits<t_tilekey>::max();
+		t_tile *cur_tile = nullptr;
+
+		auto plot = [&tiles, &bounds, &cur_key, &cur_tile](t_pix x, t_pix y) -> void
+		{
+			t_tilekey key = GetTileKey(x >> TILE_BITS, y >> TILE_BITS);
+			if(key != cur_key)
+			{
+				auto& tile = tiles[key];
+				if(!tile)
+					tile = std::make_unique<t_tile>();  // zero-initialised
+				cur_tile = tile.get();
+				cur_key = key;
+			}
+
+			++(*cur_tile)[GetTileOffset(x, y)];
+			bounds.Add(x, y);
+		};
+
+		bool first = true;
+		std::int64_t x_prev = 0, y_prev = 0;
+
+		for(const auto& pt : track.GetPoints())
+		{
+			auto [ x_real, y_real ] = Project(pt.longitude, pt.latitude);
+			std::int64_t x = ClampPixel(x_real);
+			std::int64_t y = ClampPixel(y_real);
+
+			if(first)
+			{
+				plot(t_pix(x), t_pix(y));
+				first = false;
+			}
+			else if(x != x_prev || y != y_prev)
+			{
+				const std::int64_t dx = std::abs(x - x_prev), dy = -std::abs(y - y_prev);
+				const std::int64_t sx = x_prev < x ? 1 : -1, sy = y_prev < y ? 1 : -1;
+				std::int64_t err = dx + dy;
+				std::int64_t cx = x_prev, cy = y_prev;
+
+				while(cx != x || cy != y)
+				{
+					std::int64_t err2 = 2 * err;
+					if(err2 >= dy) { err += dy; cx += sx; }
+					if(err2 <= dx) { err += dx; cy += sy; }
+
+					plot(t_pix(cx), t_pix(cy));
+				}
+			}
+
+			x_prev = x;
+			y_prev = y;
+		}
+	}
+
+
+
+	static void WriteBE(std::vector<std::uint8_t>& data, std::uint32_t val)
+	{
+		for(int shift = 24; shift >= 0; shift -= 8)
+			data.push_back(static_cast<std::uint8_t>(val >> shift));
+	}
+
+
+
+	/**
+	 * @see https://www.w3.org/TR/png/#D-CRCAppendix
+	 */
+	static std::uint32_t Crc32(std::uint32_t crc, const std::uint8_t *data, std::size_t len)
+	{
+		static const std::array<std::uint32_t, 256> table = []() -> std::array<std::uint32_t, 256>
+		{
+			std::array<std::uint32_t, 256> tab{};
+			for(std::uint32_t n = 0; n < tab.size(); ++n)
+			{
+				std::uint32_t c = n;
+				for(int k = 0; k < 8; ++k)
+					c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+				tab[n] = c;
+			}
+			return tab;
+		}();
+
+		crc = ~crc;
+		for(std::size_t i = 0; i < len; ++i)
+			crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		return ~crc;
+	}
+
+
+
+	static void WritePngChunk(std::ostream& ostr, const char *type,
+		const std::vector<std::uint8_t>& data)
+	{
+		std::vector<std::uint8_t> len;
+		WriteBE(len, static_cast<std::uint32_t>(data.size()));
+		ostr.write(reinterpret_cast<const char*>(len.data()), len.size());
+
+		std::uint32_t crc = Crc32(0, reinterpret_cast<const std::uint8_t*>(type), 4);
+		crc = Crc32(crc, data.data(), data.size());
+		ostr.write(type, 4);
+		ostr.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+		std::vector<std::uint8_t> crc_data;
+		WriteBE(crc_data, crc);
+		ostr.write(reinterpret_cast<const char*>(crc_data.data()), crc_data.size());
+	}
+
+
+
+	/**
+	 * zlib stream with a single fixed-huffman deflate block,
+	 * only runs of repeated bytes are compressed (matches at distance 1),
+	 * which suits the mostly empty heat map images
+	 * @see https://www.rfc-editor.org/rfc/rfc1950
+	 * @see https://www.rfc-editor.org/rfc/rfc1951
+	 */
+	static std::vector<std::uint8_t> Deflate(const std::vector<std::uint8_t>& data)
+	{
+		std::vector<std::uint8_t> out{ 0x78, 0x01 };
+
+		std::uint32_t bitbuf = 0;
+		unsigned int bitcnt = 0;
+
+		// write bits, least significant first
+		auto write_bits = [&out, &bitbuf, &bitcnt](std::uint32_t bits, unsigned int num) -> void
+		{
+			bitbuf |= bits << bitcnt;
+			bitcnt += num;
+			while(bitcnt >= 8)
+			{
+				out.push_back(static_cast<std::uint8_t>(bitbuf & 0xff));
+				bitbuf >>= 8;
+				bitcnt -= 8;
+			}
+		};
+
+		// huffman codes are written most significant bit first
+		auto write_code = [&write_bits](std::uint32_t code, unsigned int num) -> void
+		{
+			std::uint32_t rev = 0;
+			for(unsigned int i = 0; i < num; ++i)
+				rev |= ((code >> i) & 1) << (num - i - 1);
+			write_bits(rev, num);
+		};
+
+		auto write_sym = [&write_code](unsigned int sym) -> void
+		{
+			if(sym < 144)
+				write_code(0x30 + sym, 8);
+			else if(sym < 256)
+				write_code(0x190 + sym - 144, 9);
+			else if(sym < 280)
+				write_code(sym - 256, 7);
+			else
+				write_code(0xc0 + sym - 280, 8);
+		};
+
+		static constexpr unsigned int len_base[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13,
+			15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		static constexpr unsigned int len_extra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+			1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+		write_bits(1, 1);  // final block
+		write_bits(1, 2);  // fixed huffman codes
+
+		for(std::size_t pos = 0; pos < data.size();)
+		{
+			// length of the run repeating the previous byte
+			std::size_t run = 0;
+			if(pos > 0)
+			{
+				while(run < 258 && pos + run < data.size() && data[pos + run] == data[pos - 1])
+					++run;
+			}
+
+			if(run >= 3)
+			{
+				unsigned int code = 0;
+				while(code + 1 < std::size(len_base) && len_base[code + 1] <= run)
+					++code;
+
+				write_sym(257 + code);
+				write_bits(static_cast<std::uint32_t>(run - len_base[code]), len_extra[code]);
+				write_code(0, 5);  // distance 1
+
+				pos += run;
+			}
+			else
+			{
+				write_sym(data[pos]);
+				++pos;
+			}
+		}
+
+		write_sym(256);  // end of block
+		if(bitcnt)
+			write_bits(0, 8 - bitcnt);
+
+		// adler-32 checksum
+		std::uint32_t a = 1, b = 0;
+		for(std::size_t block = 0; block < data.size(); block += 5552)
+		{
+			// largest block without overflow before the modulo
+			const std::size_t block_end = std::min<std::size_t>(block + 5552, data.size());
+			for(std::size_t pos = block; pos < block_end; ++pos)
+			{
+				a += data[pos];
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+		WriteBE(out, (b << 16) | a);
+
+		return out;
+	}
+
+
+
+private:
+	unsigned int m_zoom{16};
+	unsigned int m_num_threads{4};
+
+	t_tiles m_tiles{};
+	Rect m_bounds{};
+	t_count m_max_count{0};
+};
+
+
+#endif
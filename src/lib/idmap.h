@@ -0,0 +1,164 @@
+/**
+ * translation of sparse ids
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_ID_MAP_H__
+#define __TRACKS_ID_MAP_H__
+
+#include <unordered_map>
+#include <optional>
+#include <utility>
+#include <algorithm>
+#include <concepts>
+#include <string>
+#include <cstddef>
+
+#include "mmapvector.h"
+#include "memory.h"
+
+
+
+/**
+ * map from sparse ids to values, stored as an array of (id, value) pairs
+ *
+ * Ids that are inserted in ascending order, as the objects in sorted osm
+ * files, are appended to the array and found by binary search. The array
+ * can be moved to a memory-mapped scratch file, other ids are kept in
+ * a hash table.
+ */
+template<class t_id, class t_val>
+requires std::integral<t_id>
+class SparseIdMap
+{
+public:
+	// std::pair is not trivially copyable, so use a plain struct for the entries
+	struct t_entry
+	{
+		t_id id;
+		t_val val;
+	};
+
+
+
+public:
+	SparseIdMap() = default;
+	~SparseIdMap() = default;
+
+	SparseIdMap(const SparseIdMap&) = delete;
+	SparseIdMap& operator=(const SparseIdMap&) = delete;
+
+
+
+	/**
+	 * keep the sorted entries in a scratch file, an empty name keeps them in memory
+	 */
+	void SetFile(const std::string& filename)
+	{
+		Clear();
+		m_sorted.SetFile(filename);
+	}
+
+
+
+	/**
+	 * insert an id unless it is already present
+	 */
+	bool Insert(t_id id, const t_val& val)
+	{
+		if(!m_sorted.size() || m_sorted[m_sorted.size() - 1].id < id)
+		{
+			m_sorted.push_back(t_entry{id, val});
+			return true;
+		}
+
+		if(FindSorted(id))
+			return false;
+
+		return m_unsorted.emplace(std::make_pair(id, val)).second;
+	}
+
+
+
+	std::optional<t_val> Find(t_id id) const
+	{
+		if(std::optional<t_val> val = FindSorted(id); val)
+			return val;
+
+		if(m_unsorted.size())
+		{
+			if(auto iter = m_unsorted.find(id); iter != m_unsorted.end())
+				return iter->second;
+		}
+
+		return std::nullopt;
+	}
+
+
+
+	/**
+	 * visit all (id, value) pairs
+	 */
+	template<class t_func>
+	void ForEach(t_func&& func) const
+	{
+		for(const t_entry& entry : m_sorted)
+			func(entry.id, entry.val);
+
+		for(const auto& [ id, val ] : m_unsorted)
+			func(id, val);
+	}
+
+
+
+	std::size_t size() const
+	{
+		return m_sorted.size() + m_unsorted.size();
+	}
+
+
+
+	void Clear()
+	{
+		m_sorted.Clear();
+		m_unsorted.clear();
+	}
+
+
+
+	/**
+	 * heap memory, a mapped scratch file is not counted
+	 */
+	std::size_t GetMemory() const
+	{
+		return m_sorted.GetMemory() + mem_unordered_map(m_unsorted);
+	}
+
+
+
+protected:
+	std::optional<t_val> FindSorted(t_id id) const
+	{
+		auto iter = std::lower_bound(m_sorted.begin(), m_sorted.end(), id,
+			[](const t_entry& entry, t_id id) -> bool
+		{
+			return entry.id < id;
+		});
+
+		if(iter == m_sorted.end() || iter->id != id)
+			return std::nullopt;
+
+		return iter->val;
+	}
+
+
+
+private:
+	MmapVector<t_entry> m_sorted{};
+	std::unordered_map<t_id, t_val> m_unsorted{};
+};
+
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * sparse set of integer ids
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_ID_SET_H__
+#define __TRACKS_ID_SET_H__
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <concepts>
+#include <cstdint>
+#include <cstddef>
+
+
+
+/**
+ * bitset over a large id range, only allocating the blocks containing ids
+ *
+ * Ids of osm objects are assigned in ascending order, so the ids referenced
+ * by a region cluster in few blocks. Negative ids are kept in their own blocks.
+ */
+template<class t_id = std::int64_t>
+requires std::integral<t_id>
+class SparseIdSet
+{
+public:
+	SparseIdSet() = default;
+	~SparseIdSet() = default;
+
+	SparseIdSet(const SparseIdSet&) = delete;
+	SparseIdSet& operator=(const SparseIdSet&) = delete;
+	SparseIdSet(SparseIdSet&&) = default;
+	SparseIdSet& operator=(SparseIdSet&&) = default;
+
+
+
+	/**
+	 * add an id, returns false if it was already in the set
+	 */
+	bool Insert(t_id id)
+	{
+		auto [ table, idx ] = GetIndex(id);
+		t_blocks& blocks = m_blocks[table];
+		const std::size_t block_idx = idx >> BLOCK_BITS;
+
+		if(block_idx >= blocks.size())
+			blocks.resize(block_idx + 1);
+
+		std::unique_ptr<t_word[]>& block = blocks[block_idx];
+		if(!block)
+		{
+			block = std::make_unique<t_word[]>(BLOCK_WORDS);
+			++m_num_blocks;
+		}
+
+		t_word& word = block[(idx & BLOCK_MASK) / WORD_BITS];
+		const t_word bit = t_word(1) << (idx % WORD_BITS);
+		if(word & bit)
+			return false;
+
+		word |= bit;
+		++m_size;
+		return true;
+	}
+
+
+
+	bool Contains(t_id id) const
+	{
+		auto [ table, idx ] = GetIndex(id);
+		const t_blocks& blocks = m_blocks[table];
+		const std::size_t block_idx = idx >> BLOCK_BITS;
+
+		if(block_idx >= blocks.size() || !blocks[block_idx])
+			return false;
+
+		const t_word word = blocks[block_idx][(idx & BLOCK_MASK) / WORD_BITS];
+		return (word >> (idx % WORD_BITS)) & 1;
+	}
+
+
+
+	/**
+	 * number of ids in the set
+	 */
+	std::size_t size() const
+	{
+		return m_size;
+	}
+
+
+
+	void Clear()
+	{
+		m_blocks[0].clear();
+		m_blocks[1].clear();
+		m_num_blocks = 0;
+		m_size = 0;
+	}
+
+
+
+	/**
+	 * heap memory of the block tables and the allocated blocks
+	 */
+	std::size_t GetMemory() const
+	{
+		return (m_blocks[0].capacity() + m_blocks[1].capacity()) * sizeof(std::unique_ptr<t_word[]>)
+			+ m_num_blocks * BLOCK_WORDS * sizeof(t_word);
+	}
+
+
+
+protected:
+	using t_word = std::uint64_t;
+	using t_blocks = std::vector<std::unique_ptr<t_word[]>>;
+
+	// 2^16 ids per block, 8 kiB
+	static constexpr std::size_t BLOCK_BITS = 16;
+	static constexpr std::size_t BLOCK_MASK = (std::size_t(1) << BLOCK_BITS) - 1;
+	static constexpr std::size_t WORD_BITS = sizeof(t_word) * 8;
+	static constexpr std::size_t BLOCK_WORDS = (std::size_t(1) << BLOCK_BITS) / WORD_BITS;
+
+
+
+	/**
+	 * get the block table and the bit index of an id
+	 */
+	static std::pair<std::size_t, std::uint64_t> GetIndex(t_id id)
+	{
+		if constexpr(std::is_signed_v<t_id>)
+		{
+			if(id < 0)
+				return std::make_pair(1, std::uint64_t(-(id + 1)));
+		}
+
+		return std::make_pair(0, std::uint64_t(id));
+	}
+
+
+
+private:
+	// blocks of the non-negative and of the negative ids
+	t_blocks m_blocks[2]{};
+
+	std::size_t m_num_blocks{};
+	std::size_t m_size{};
+};
+
+
+#endif
@@ -15,15 +15,27 @@
 #include <limits>
 #include <string>
 #include <string_view>
-#include <list>
+#include <span>
 #include <vector>
 #include <tuple>
+#include <array>
 #include <unordered_map>
-#include <unordered_set>
+#include <map>
+#include <deque>
 #include <optional>
 #include <functional>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <algorithm>
 #include <concepts>
 #include <stdexcept>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
 #include <cstdint>
 
 #if __has_include(<filesystem>)
@@ -37,7 +49,11 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
+#include <boost/asio.hpp>
 #include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #if __has_include(<osmium/handler.hpp>) && defined(_TRACKS_CFG_USE_OSMIUM_)
 	#define _TRACKS_USE_OSMIUM_ 1
@@ -48,7 +64,115 @@
 #endif
 
 
+#include "profile.h"
+#include "memory.h"
+#include "densestore.h"
+#include "stringpool.h"
+#include "idset.h"
+#include "idmap.h"
+#include "mapdirindex.h"
+#include "svgwriter.h"
+
+
 #define MAP_MAGIC "TRACKMAP"
+#define MAP_MAGIC_FLAT "TRACKMAP_FLAT_2"
+#define MAP_FLAT_ALIGN 16
+#define MAP_TILE_ZOOM 12
+
+
+
+/**
+ * tags of a map object as pairs of interned key and value ids,
+ * the first few are stored inline without heap allocation
+ */
+template<class t_id = std::uint32_t, std::size_t NUM_INLINE = 3>
+requires std::integral<t_id>
+class MapTags
+{
+public:
+	using t_tag = std::pair<t_id, t_id>;
+
+
+
+public:
+	/**
+	 * add a tag unless its key is already present
+	 */
+	bool Add(t_id key, t_id val)
+	{
+		if(Find(key))
+			return false;
+
+		if(m_size < NUM_INLINE)
+		{
+			m_inline[m_size] = std::make_pair(key, val);
+		}
+		else
+		{
+			// move all tags to the heap once the inline storage is full
+			if(m_size == NUM_INLINE)
+				m_spilled.assign(m_inline.begin(), m_inline.end());
+			m_spilled.emplace_back(std::make_pair(key, val));
+		}
+
+		++m_size;
+		return true;
+	}
+
+
+
+	/**
+	 * get the value id for the given key id
+	 */
+	std::optional<t_id> Find(t_id key) const
+	{
+		for(const t_tag& tag : *this)
+		{
+			if(tag.first == key)
+				return tag.second;
+		}
+
+		return std::nullopt;
+	}
+
+
+
+	std::size_t size() const
+	{
+		return m_size;
+	}
+
+
+
+	const t_tag* begin() const
+	{
+		return m_size <= NUM_INLINE ? m_inline.data() : m_spilled.data();
+	}
+
+
+
+	const t_tag* end() const
+	{
+		return begin() + m_size;
+	}
+
+
+
+	/**
+	 * heap memory of the tags not fitting into the inline storage
+	 */
+	std::size_t GetMemory() const
+	{
+		return mem_vector(m_spilled);
+	}
+
+
+
+private:
+	std::array<t_tag, NUM_INLINE> m_inline{};
+	std::vector<t_tag> m_spilled{};
+	t_id m_size{};
+};
 
 
 
@@ -65,11 +189,24 @@ struct MapVertex
 
 
 
+/**
+ * range in the map's shared buffer of referenced ids
+ */
+template<class t_size = std::size_t>
+requires std::integral<t_size>
+struct MapIdRange
+{
+	t_size begin{};
+	t_size count{};
+};
+
+
+
 template<class t_tags, class t_size = std::size_t>
 requires std::integral<t_size>
 struct MapSegment
 {
-	std::list<t_size> vertex_ids{};
+	MapIdRange<t_size> vertex_ids{};
 	bool is_area{false};
 
 	t_tags tags{};
@@ -82,15 +219,35 @@ template<class t_tags, class t_size = std::size_t>
 requires std::integral<t_size>
 struct MapMultiSegment
 {
-	std::list<t_size> vertex_ids{};
-	std::list<t_size> segment_inner_ids{};
-	std::list<t_size> segment_ids{};
+	MapIdRange<t_size> vertex_ids{};
+	MapIdRange<t_size> segment_inner_ids{};
+	MapIdRange<t_size> segment_ids{};
 
 	t_tags tags{};
 };
 
 
 
+/**
+ * bounds and object ids of one tile of a map
+ */
+template<class t_real = double, class t_size = std::size_t>
+requires std::floating_point<t_real> && std::integral<t_size>
+struct MapTile
+{
+	t_real min_longitude{}, max_longitude{};
+	t_real min_latitude{}, max_latitude{};
+
+	std::vector<t_size> vertex_ids{};
+	std::vector<t_size> label_vertex_ids{};
+	std::vector<t_size> segment_ids{};
+	std::vector<t_size> segment_background_ids{};
+	std::vector<t_size> segment_foreground_ids{};
+	std::vector<t_size> multisegment_ids{};
+};
+
+
+
 enum class MapObjType
 {
 	VERTEX,
@@ -105,20 +262,67 @@ requires std::floating_point<t_real> && std::integral<t_size>
 class Map
 {
 public:
-	using t_tags = std::unordered_map<std::string, std::string>;
+	using t_strid = std::uint32_t;
+	using t_tags = MapTags<t_strid>;
+	using t_tag = typename t_tags::t_tag;
 	using t_widthmap = std::unordered_map<std::string_view, t_real>;
 	using t_colmap = std::unordered_map<std::string_view, std::tuple<int, int, int>>;
 
 	using t_vertex = MapVertex<t_tags, t_real>;
 	using t_segment = MapSegment<t_tags, t_size>;
 	using t_multisegment = MapMultiSegment<t_tags, t_size>;
+	using t_idrange = MapIdRange<t_size>;
+	using t_tile = MapTile<t_real, t_size>;
+
+	// min_lon, max_lon, min_lat, max_lat in radians
+	using t_bounds = std::tuple<t_real, t_real, t_real, t_real>;
 
 	using t_osmid = std::int64_t;
 
+	// r-tree of the bounding boxes of the map objects, [lon, lat] in radians
+	enum class IndexLayer : std::uint8_t
+	{
+		SEGMENT,
+		SEGMENT_BACKGROUND,
+		SEGMENT_FOREGROUND,
+		MULTISEGMENT,
+
+		NUM_LAYERS,
+	};
+
+	using t_index_vert = boost::geometry::model::point<t_real, 2, boost::geometry::cs::cartesian>;
+	using t_index_box = boost::geometry::model::box<t_index_vert>;
+	using t_index_val = std::tuple<t_index_box, IndexLayer, t_size>;
+	using t_index = boost::geometry::index::rtree<t_index_val, boost::geometry::index::rstar<16>>;
+
 
 
 public:
-	Map() = default;
+	Map()
+	{
+		// intern the vocabulary of the styles, so that
+		// the tags of map objects can be resolved by their ids
+		m_id_building = m_strings.Intern("building");
+		m_id_leisure = m_strings.Intern("leisure");
+		m_id_swimming_pool = m_strings.Intern("swimming_pool");
+		m_id_place = m_strings.Intern("place");
+		m_id_name = m_strings.Intern("name");
+
+		for(const auto& [ key, widths ] : m_road_widths)
+		{
+			const t_strid key_id = m_strings.Intern(key);
+			for(const auto& [ val, width ] : widths)
+				m_road_width_ids.emplace(std::make_pair(GetTagId(key_id, m_strings.Intern(val)), width));
+		}
+
+		for(const auto& [ key, colours ] : m_seg_colours)
+		{
+			const t_strid key_id = m_strings.Intern(key);
+			for(const auto& [ val, colour ] : colours)
+				m_seg_colour_ids.emplace(std::make_pair(GetTagId(key_id, m_strings.Intern(val)), colour));
+		}
+	}
+
 	~Map() = default;
 
 
@@ -129,28 +333,18 @@ protected:
 	 */
 	void PruneUnreferenced()
 	{
-		for(auto iter = m_vertices.begin(); iter != m_vertices.end();)
-		{
-			if(iter->second.referenced)
-			{
-				++iter;
-				continue;
-			}
-
-			iter = m_vertices.erase(iter);
-		}
+		TRACKS_PROFILE_SCOPE("Map::PruneUnreferenced");
 
-		for(auto iter = m_segments.begin(); iter != m_segments.end();)
+		m_vertices.EraseIf([](const t_vertex& vertex) -> bool
 		{
-			if(iter->second.referenced || iter->second.tags.size())
-			{
-				++iter;
-				continue;
-			}
+			return !vertex.referenced;
+		});
 
-			// no tags and not referenced by multi-segments -> remove
-			iter = m_segments.erase(iter);
-		}
+		// no tags and not referenced by multi-segments -> remove
+		m_segments.EraseIf([](const t_segment& seg) -> bool
+		{
+			return !seg.referenced && !seg.tags.size();
+		});
 
 		for(auto iter = m_segments_background.begin(); iter != m_segments_background.end();)
 		{
@@ -175,1183 +369,3287 @@ protected:
 			// no tags and not referenced by multi-segments -> remove
 			iter = m_segments_foreground.erase(iter);
 		}
+
+		CompactIds();
 	}
 
 
 
 	/**
-	 * get the corresponding local id for a map object id
+	 * add the numbers of loaded map objects to the profiling counters
 	 */
-	std::optional<t_size> GetLocalId(MapObjType ty, t_osmid id) const
+	void CountObjects() const
+	{
+		TRACKS_PROFILE_COUNT("Map vertices", m_vertices.size() + m_label_vertices.size());
+		TRACKS_PROFILE_COUNT("Map segments", m_segments.size()
+			+ m_segments_background.size() + m_segments_foreground.size());
+		TRACKS_PROFILE_COUNT("Map multi-segments", m_multisegments.size());
+	}
+
+
+
+	/**
+	 * get the bounding box of the given vertices
+	 */
+	std::optional<t_index_box> GetBoundingBox(const t_idrange& vertex_ids) const
 	{
-		const std::unordered_map<t_osmid, t_size> *map = &m_local_vert_ids;
+		t_real min_lon = std::numeric_limits<t_real>::max(), max_lon = -min_lon;
+		t_real min_lat = std::numeric_limits<t_real>::max(), max_lat = -min_lat;
+		bool found = false;
 
-		switch(ty)
+		for(const t_size id : GetIds(vertex_ids))
 		{
-			case MapObjType::VERTEX:
-				map = &m_local_vert_ids;
-				break;
-			case MapObjType::SEGMENT:
-				map = &m_local_seg_ids;
-				break;
-			case MapObjType::MULTISEGMENT:
-				map = &m_local_multiseg_ids;
-				break;
+			const t_vertex *vertex = m_vertices.Find(id);
+			if(!vertex)
+				continue;
+
+			min_lon = std::min(min_lon, vertex->longitude);
+			max_lon = std::max(max_lon, vertex->longitude);
+			min_lat = std::min(min_lat, vertex->latitude);
+			max_lat = std::max(max_lat, vertex->latitude);
+			found = true;
 		}
 
-		auto iter = map->find(id);
-		if(iter == map->end())
+		if(!found)
 			return std::nullopt;
 
-		return iter->second;
+		return t_index_box{ t_index_vert{ min_lon, min_lat }, t_index_vert{ max_lon, max_lat } };
 	}
 
 
 
 	/**
-	 * register a corresponding local id for a map object id
+	 * build the r-tree of the bounding boxes of the segments and multi-segments,
+	 * m_index_mtx has to be locked
+	 * @see https://www.boost.org/doc/libs/1_87_0/libs/geometry/doc/html/geometry/spatial_indexes.html
 	 */
-	std::size_t RegisterLocalId(MapObjType ty, t_osmid id)
+	void BuildIndex() const
 	{
-		std::unordered_map<t_osmid, t_size> *map = &m_local_vert_ids;
-		t_size *local_id = &m_cur_local_vert_id;
+		namespace geo = boost::geometry;
 
-		switch(ty)
+		TRACKS_PROFILE_SCOPE("Map::BuildIndex");
+
+		std::vector<t_index_val> boxes;
+		boxes.reserve(m_segments.size() + m_segments_background.size()
+			+ m_segments_foreground.size() + m_multisegments.size());
+
+		auto add_segments = [this, &boxes](const auto& segs, IndexLayer layer)
 		{
-			case MapObjType::VERTEX:
-				map = &m_local_vert_ids;
-				local_id = &m_cur_local_vert_id;
-				break;
-			case MapObjType::SEGMENT:
-				map = &m_local_seg_ids;
-				local_id = &m_cur_local_seg_id;
-				break;
-			case MapObjType::MULTISEGMENT:
-				map = &m_local_multiseg_ids;
-				local_id = &m_cur_local_multiseg_id;
-				break;
+			for(const auto& [ id, seg ] : segs)
+			{
+				if(std::optional<t_index_box> box = GetBoundingBox(seg.vertex_ids); box)
+					boxes.emplace_back(std::make_tuple(*box, layer, id));
+			}
+		};
+
+		add_segments(m_segments, IndexLayer::SEGMENT);
+		add_segments(m_segments_background, IndexLayer::SEGMENT_BACKGROUND);
+		add_segments(m_segments_foreground, IndexLayer::SEGMENT_FOREGROUND);
+
+		// multi-segments span the boxes of their vertices and segments
+		for(const auto& [ id, multiseg ] : m_multisegments)
+		{
+			std::optional<t_index_box> box = GetBoundingBox(multiseg.vertex_ids);
+
+			for(const t_idrange *seg_ids : { &multiseg.segment_ids, &multiseg.segment_inner_ids })
+			{
+				for(const t_size seg_id : GetIds(*seg_ids))
+				{
+					const t_segment *seg = m_segments.Find(seg_id);
+					if(!seg)
+						continue;
+
+					std::optional<t_index_box> seg_box = GetBoundingBox(seg->vertex_ids);
+					if(!seg_box)
+						continue;
+
+					if(box)
+						geo::expand(*box, *seg_box);
+					else
+						box = seg_box;
+				}
+			}
+
+			if(box)
+				boxes.emplace_back(std::make_tuple(*box, IndexLayer::MULTISEGMENT, id));
 		}
 
-		// id already in map?
-		auto iter = map->find(id);
-		if(iter != map->end())
-			return iter->second;
+		// bulk loading
+		m_index = std::make_unique<t_index>(boxes.begin(), boxes.end());
+	}
+
 
-		// register a new id
-		map->emplace(std::make_pair(id, *local_id));
-		return (*local_id)++;
+
+	/**
+	 * get the sorted ids of the objects of each layer intersecting the given bounds,
+	 * the index is built on first use
+	 */
+	std::array<std::vector<t_size>, std::size_t(IndexLayer::NUM_LAYERS)> QueryIndex(
+		t_real min_longitude, t_real max_longitude,
+		t_real min_latitude, t_real max_latitude) const
+	{
+		namespace geo = boost::geometry;
+		namespace geoidx = boost::geometry::index;
+
+		TRACKS_PROFILE_SCOPE("Map::QueryIndex");
+
+		std::vector<t_index_val> found;
+		{
+			// exports of the same map can run concurrently
+			std::lock_guard lck{m_index_mtx};
+			if(!m_index)
+				BuildIndex();
+
+			m_index->query(geoidx::intersects(t_index_box{
+				t_index_vert{ min_longitude, min_latitude },
+				t_index_vert{ max_longitude, max_latitude } }),
+				std::back_inserter(found));
+		}
+
+		std::array<std::vector<t_size>, std::size_t(IndexLayer::NUM_LAYERS)> ids;
+		for(const auto& [ box, layer, id ] : found)
+			ids[std::size_t(layer)].push_back(id);
+
+		// keep the drawing order of the objects
+		for(std::vector<t_size>& layer_ids : ids)
+			std::sort(layer_ids.begin(), layer_ids.end());
+
+		return ids;
 	}
 
 
 
-	bool HasRoadWidth(const std::string_view& key, const std::string_view& val) const
+	/**
+	 * discard the spatial index after the objects have changed
+	 */
+	void InvalidateIndex()
 	{
-		auto iter_widths = m_road_widths.find(key);
-		if(iter_widths == m_road_widths.end())
-			return false;
+		std::lock_guard lck{m_index_mtx};
+		m_index.reset();
+	}
 
-		auto iter = iter_widths->second.find(val);
-		return iter != iter_widths->second.end();
+
+
+	/**
+	 * combine the interned key and value ids of a tag
+	 */
+	static std::uint64_t GetTagId(t_strid key, t_strid val)
+	{
+		return (std::uint64_t(key) << 32) | std::uint64_t(val);
 	}
 
 
 
-	bool HasSurfaceColour(const std::string_view& key, const std::string_view& val) const
+	/**
+	 * add a tag to a map object, interning its key and value
+	 */
+	void AddTag(t_tags& tags, std::string_view key, std::string_view val)
 	{
-		if(!m_skip_buildings && key == "building")
-			return true;
+		tags.Add(m_strings.Intern(key), m_strings.Intern(val));
+	}
 
-		auto iter_surf = m_seg_colours.find(key);
-		if(iter_surf == m_seg_colours.end())
-			return false;
 
-		auto iter = iter_surf->second.find(val);
-		return iter != iter_surf->second.end();
+
+	/**
+	 * append ids to the shared id buffer
+	 */
+	t_idrange AddIds(const std::vector<t_size>& ids)
+	{
+		t_idrange range{ .begin = static_cast<t_size>(m_ids.size()),
+			.count = static_cast<t_size>(ids.size()) };
+		m_ids.insert(m_ids.end(), ids.begin(), ids.end());
+		return range;
 	}
 
 
 
-	bool ImportVertexXml(const boost::property_tree::ptree& node)
+	/**
+	 * extend the range at the end of the shared id buffer by another id
+	 */
+	void AddId(t_idrange& range, t_size id)
 	{
-		namespace num = std::numbers;
+		if(!range.count)
+			range.begin = static_cast<t_size>(m_ids.size());
 
-		auto id = node.get_optional<t_size>("<xmlattr>.id");
-		auto lon = node.get_optional<t_real>("<xmlattr>.lon");
-		auto lat = node.get_optional<t_real>("<xmlattr>.lat");
-		auto vis = node.get_optional<bool>("<xmlattr>.visible");
-		if(vis && !*vis)
-			return false;
+		m_ids.push_back(id);
+		++range.count;
+	}
 
-		if(!id || !lon || !lat)
-			return false;
 
-		t_vertex vertex
+
+	/**
+	 * remove the ids of erased segments and multi-segments from the shared buffer
+	 */
+	void CompactIds()
+	{
+		std::vector<t_size> ids;
+		ids.reserve(m_ids.size());
+
+		auto move_range = [this, &ids](t_idrange& range)
 		{
-			.longitude = *lon / t_real(180) * num::pi_v<t_real>,
-			.latitude = *lat / t_real(180) * num::pi_v<t_real>,
-			.referenced = true,  // mark all as referenced
+			const t_size begin = static_cast<t_size>(ids.size());
+			ids.insert(ids.end(), m_ids.begin() + range.begin,
+				m_ids.begin() + range.begin + range.count);
+			range.begin = begin;
 		};
 
-		bool has_place = false;
-		bool has_name = false;
-		if(auto tags = node.get_child_optional(""))
+		for(auto *segs : { &m_segments_background, &m_segments_foreground })
 		{
-			for(const auto& tag : *tags)
-			{
-				if(tag.first != "tag")
-					continue;
+			for(auto& [ id, seg ] : *segs)
+				move_range(seg.vertex_ids);
+		}
 
-				auto key = tag.second.get_optional<std::string>("<xmlattr>.k");
-				auto val = tag.second.get_optional<std::string>("<xmlattr>.v");
+		for(auto&& [ id, seg ] : m_segments)
+			move_range(seg.vertex_ids);
 
-				if(!key || !val)
-					continue;
+		for(auto&& [ id, seg ] : m_multisegments)
+		{
+			move_range(seg.vertex_ids);
+			move_range(seg.segment_inner_ids);
+			move_range(seg.segment_ids);
+		}
 
-				bool found_tag = false;
-				if(!has_place && *key == "place")
-				{
-					has_place = true;
-					found_tag = true;
-				}
-				if(!has_name && *key == "name")
-				{
-					has_name = true;
-					found_tag = true;
-				}
-
-				if(!m_skip_unnecessary_tags || (!m_skip_labels && found_tag))
-					vertex.tags.emplace(std::make_pair(*key, *val));
-			}
-		}
-
-		// vertex ranges
-		m_min_latitude = std::min(m_min_latitude, vertex.latitude);
-		m_max_latitude = std::max(m_max_latitude, vertex.latitude);
-		m_min_longitude = std::min(m_min_longitude, vertex.longitude);
-		m_max_longitude = std::max(m_max_longitude, vertex.longitude);
-
-		if(has_place && has_name)
-		{
-			if(!m_skip_labels)
-			{
-				// place label
-				t_size local_id = RegisterLocalId(MapObjType::VERTEX, *id);
-				m_label_vertices.emplace(std::make_pair(local_id, std::move(vertex)));
-			}
-		}
-		else
-		{
-			// vertex
-			t_size local_id = RegisterLocalId(MapObjType::VERTEX, *id);
-			m_vertices.emplace(std::make_pair(local_id, std::move(vertex)));
-		}
-
-		return true;
+		ids.shrink_to_fit();
+		m_ids = std::move(ids);
 	}
 
 
 
-	bool ImportSegmentXml(const boost::property_tree::ptree& node)
+	/**
+	 * add the objects of a separately imported map, objects with
+	 * osm ids that are already known are only added once
+	 */
+	void Merge(const Map& other)
 	{
-		auto id = node.get_optional<t_size>("<xmlattr>.id");
-		auto vis = node.get_optional<bool>("<xmlattr>.visible");
-		if(vis && !*vis)
-			return false;
+		TRACKS_PROFILE_SCOPE("Map::Merge");
+		InvalidateIndex();
 
-		t_segment seg{};
-		seg.referenced = true;  // mark all as referenced
-		bool is_background = false;
-		bool is_foreground = false;
-		bool is_road = false;
+		// translate the string ids of the other map
+		std::vector<t_strid> str_ids(other.m_strings.size());
+		for(std::size_t idx = 0; idx < str_ids.size(); ++idx)
+			str_ids[idx] = m_strings.Intern(other.m_strings.Get(static_cast<t_strid>(idx)));
 
-		if(auto tags = node.get_child_optional(""))
+		auto merge_tags = [&str_ids](const t_tags& tags) -> t_tags
 		{
-			for(const auto& tag : *tags)
-			{
-				if(tag.first == "nd")
-				{
-					auto vertex_id = tag.second.get_optional<t_size>("<xmlattr>.ref");
-					if(!vertex_id)
-						continue;
-
-					std::optional<t_size> local_id = GetLocalId(MapObjType::VERTEX, *vertex_id);
-					if(!local_id)
-						continue;
+			t_tags merged;
+			for(const auto& [ key, val ] : tags)
+				merged.Add(str_ids[key], str_ids[val]);
+			return merged;
+		};
 
-					seg.vertex_ids.push_back(*local_id);
-				}
-				else if(tag.first == "tag")
-				{
-					auto key = tag.second.get_optional<std::string>("<xmlattr>.k");
-					auto val = tag.second.get_optional<std::string>("<xmlattr>.v");
+		// translate the local ids of the other map via their osm ids, only the ids
+		// of objects that are merged or referenced by merged objects are registered,
+		// not the ones that have been pruned from the other map
+		static constexpr t_size no_id = std::numeric_limits<t_size>::max();
 
-					if(!key || !val)
-						continue;
+		struct IdTranslation
+		{
+			MapObjType ty{};
+			std::vector<t_osmid> osm_ids{};
+			std::vector<t_size> ids{};
+		};
 
-					if(!is_background && (*key == "landuse" || *key == "natural"))
-						is_background = true;
-					if(!is_foreground && (*key == "natural" && *val == "water"))
-						is_foreground = true;
-					if(!is_road && m_road_widths.find(*key) != m_road_widths.end())
-						is_road = true;
-					if(m_skip_buildings && (*key == "building"
-						|| (*key == "leisure" && *val == "swimming_pool")))
-						return false;
+		auto get_translation = [](MapObjType ty, const t_idmap& other_ids, t_size num_ids) -> IdTranslation
+		{
+			IdTranslation trafo{ .ty = ty, .osm_ids = std::vector<t_osmid>(num_ids),
+				.ids = std::vector<t_size>(num_ids, no_id) };
+			other_ids.ForEach([&trafo](t_osmid osm_id, t_size other_id)
+			{
+				trafo.osm_ids[other_id] = osm_id;
+			});
+			return trafo;
+		};
 
-					if(!m_skip_unnecessary_tags
-						|| HasSurfaceColour(*key, *val)
-						|| HasRoadWidth(*key, *val))
-					{
-						seg.tags.emplace(std::make_pair(*key, *val));
-					}
-				}
-			}
-		}
+		auto translate = [this](IdTranslation& trafo, t_size other_id) -> t_size
+		{
+			t_size& id = trafo.ids[other_id];
+			if(id == no_id)
+				id = static_cast<t_size>(RegisterLocalId(trafo.ty, trafo.osm_ids[other_id]));
+			return id;
+		};
 
-		if(seg.vertex_ids.size() >= 2 && *seg.vertex_ids.begin() == *seg.vertex_ids.rbegin())
-			seg.is_area = true;
-		if(is_road)
-			seg.is_area = false;
+		IdTranslation vert_ids = get_translation(MapObjType::VERTEX,
+			other.m_local_vert_ids, other.m_cur_local_vert_id);
+		IdTranslation seg_ids = get_translation(MapObjType::SEGMENT,
+			other.m_local_seg_ids, other.m_cur_local_seg_id);
+		IdTranslation multiseg_ids = get_translation(MapObjType::MULTISEGMENT,
+			other.m_local_multiseg_ids, other.m_cur_local_multiseg_id);
 
-		t_size local_id = RegisterLocalId(MapObjType::SEGMENT, *id);
-		if(is_foreground)
-			m_segments_foreground.emplace(std::make_pair(local_id, std::move(seg)));
-		else if(is_background)
-			m_segments_background.emplace(std::make_pair(local_id, std::move(seg)));
-		else /*if(seg.tags.size())*/
-			m_segments.emplace(std::make_pair(local_id, std::move(seg)));
+		auto merge_ids = [this, &other, &translate](const t_idrange& range, IdTranslation& trafo) -> t_idrange
+		{
+			std::vector<t_size> merged;
+			merged.reserve(range.count);
+			for(const t_size id : other.GetIds(range))
+				merged.push_back(translate(trafo, id));
+			return AddIds(merged);
+		};
 
-		return true;
-	}
+		// objects that are already in the map are skipped
+		auto merge_vertices = [&vert_ids, &translate, &merge_tags](auto& vertices, const auto& other_vertices)
+		{
+			for(const auto& [ id, other_vertex ] : other_vertices)
+			{
+				const t_size new_id = translate(vert_ids, id);
+				if(FindObject(vertices, new_id))
+					continue;
 
+				t_vertex vertex = other_vertex;
+				vertex.tags = merge_tags(other_vertex.tags);
+				vertices.emplace(std::make_pair(new_id, std::move(vertex)));
+			}
+		};
 
+		auto merge_segments = [&seg_ids, &vert_ids, &translate, &merge_tags, &merge_ids](
+			auto& segs, const auto& other_segs)
+		{
+			for(const auto& [ id, other_seg ] : other_segs)
+			{
+				const t_size new_id = translate(seg_ids, id);
+				if(FindObject(segs, new_id))
+					continue;
 
-	bool ImportMultiSegmentXml(const boost::property_tree::ptree& node)
-	{
-		auto id = node.get_optional<t_size>("<xmlattr>.id");
-		auto vis = node.get_optional<bool>("<xmlattr>.visible");
-		if(vis && !*vis)
-			return false;
+				t_segment seg = other_seg;
+				seg.vertex_ids = merge_ids(other_seg.vertex_ids, vert_ids);
+				seg.tags = merge_tags(other_seg.tags);
+				segs.emplace(std::make_pair(new_id, std::move(seg)));
+			}
+		};
 
-		t_multisegment seg{};
+		merge_vertices(m_vertices, other.m_vertices);
+		merge_vertices(m_label_vertices, other.m_label_vertices);
+		merge_segments(m_segments, other.m_segments);
+		merge_segments(m_segments_background, other.m_segments_background);
+		merge_segments(m_segments_foreground, other.m_segments_foreground);
 
-		if(auto tags = node.get_child_optional(""))
+		for(const auto& [ id, other_multiseg ] : other.m_multisegments)
 		{
-			for(const auto& tag : *tags)
-			{
-				if(tag.first == "member")
-				{
-					auto seg_ty = tag.second.get_optional<std::string>("<xmlattr>.type");
-					auto seg_ref = tag.second.get_optional<t_size>("<xmlattr>.ref");
-					auto seg_role = tag.second.get_optional<std::string>("<xmlattr>.role");
-					if(!seg_ty || !seg_ref)
-						continue;
+			const t_size new_id = translate(multiseg_ids, id);
+			if(m_multisegments.Find(new_id))
+				continue;
 
-					if(*seg_ty == "node")
-					{
-						std::optional<t_size> local_id = GetLocalId(MapObjType::VERTEX, *seg_ref);
-						if(!local_id)
-							continue;
+			t_multisegment multiseg;
+			multiseg.vertex_ids = merge_ids(other_multiseg.vertex_ids, vert_ids);
+			multiseg.segment_inner_ids = merge_ids(other_multiseg.segment_inner_ids, seg_ids);
+			multiseg.segment_ids = merge_ids(other_multiseg.segment_ids, seg_ids);
+			multiseg.tags = merge_tags(other_multiseg.tags);
+			m_multisegments.emplace(std::make_pair(new_id, std::move(multiseg)));
+		}
 
-						seg.vertex_ids.push_back(*local_id);
-					}
-					else if(*seg_ty == "way" && seg_role && *seg_role == "inner")
-					{
-						std::optional<t_size> local_id = GetLocalId(MapObjType::SEGMENT, *seg_ref);
-						if(!local_id)
-							continue;
+		m_min_latitude = std::min(m_min_latitude, other.m_min_latitude);
+		m_max_latitude = std::max(m_max_latitude, other.m_max_latitude);
+		m_min_longitude = std::min(m_min_longitude, other.m_min_longitude);
+		m_max_longitude = std::max(m_max_longitude, other.m_max_longitude);
+	}
 
-						seg.segment_inner_ids.push_back(*local_id);
-					}
-					else if(*seg_ty == "way")
-					{
-						std::optional<t_size> local_id = GetLocalId(MapObjType::SEGMENT, *seg_ref);
-						if(!local_id)
-							continue;
 
-						seg.segment_ids.push_back(*local_id);
-					}
 
-				}
-				else if(tag.first == "tag")
-				{
-					auto key = tag.second.get_optional<std::string>("<xmlattr>.k");
-					auto val = tag.second.get_optional<std::string>("<xmlattr>.v");
+	/**
+	 * find an object in a dense store or in a hash table
+	 */
+	template<class t_objs>
+	static auto FindObject(const t_objs& objs, t_size id)
+	{
+		if constexpr(requires { objs.Find(id); })
+		{
+			return objs.Find(id);
+		}
+		else
+		{
+			auto iter = objs.find(id);
+			return iter == objs.end() ? nullptr : &iter->second;
+		}
+	}
 
-					if(!key || !val)
-						continue;
 
-					if(m_skip_buildings && (*key == "building"
-						|| (*key == "leisure" && *val == "swimming_pool")))
-						return false;
 
-					if(!m_skip_unnecessary_tags
-						|| HasSurfaceColour(*key, *val)
-						|| HasRoadWidth(*key, *val))
-					{
-						seg.tags.emplace(std::make_pair(*key, *val));
-					}
-				}
-			}
+	/**
+	 * visit all objects of a container, or only the ones with the given ids
+	 */
+	template<class t_objs, class t_func>
+	static void ForEachObject(const t_objs& objs, const std::vector<t_size> *ids, t_func&& func)
+	{
+		if(!ids)
+		{
+			for(const auto& [ id, obj ] : objs)
+				func(id, obj);
+			return;
 		}
 
-		t_size local_id = RegisterLocalId(MapObjType::MULTISEGMENT, *id);
-		//if(seg.tags.size())
-		m_multisegments.emplace(std::make_pair(local_id, std::move(seg)));
-
-		return true;
+		for(const t_size id : *ids)
+		{
+			if(const auto *obj = FindObject(objs, id); obj)
+				func(id, *obj);
+		}
 	}
 
 
 
-public:
 	/**
-	 * import a map from an osm file
-	 * @see https://wiki.openstreetmap.org/wiki/OSM_XML
-	 * @see https://wiki.openstreetmap.org/wiki/Elements
+	 * sections of the flat map file format
 	 */
-	bool ImportXml(const std::string& mapname)
+	enum class FlatSection : std::uint32_t
 	{
-		namespace fs = __map_fs;
-		namespace ptree = boost::property_tree;
+		STRING_OFFSETS,
+		STRING_CHARS,
+		TAGS,
+		IDS,
+		VERTICES,
+		LABEL_VERTICES,
+		SEGMENTS,
+		SEGMENTS_BACKGROUND,
+		SEGMENTS_FOREGROUND,
+		MULTISEGMENTS,
 
-		fs::path mapfile{mapname};
-		if(!fs::exists(mapfile))
-			return false;
+		NUM_SECTIONS,
+	};
 
-		ptree::ptree map_root;
-		ptree::read_xml(mapname, map_root);
 
-		const auto& osm = map_root.get_child_optional("osm");
-		if(!osm)
-			return false;
 
-		m_filename = mapfile.filename().string();
-		m_version = osm->get<std::string>("<xmlattr>.version", "<unknown>");
-		m_creator = osm->get<std::string>("<xmlattr>.generator", "<unknown>");
+	/**
+	 * header of the flat map file format, followed by
+	 * the sections, which are aligned to MAP_FLAT_ALIGN
+	 */
+	struct FlatHeader
+	{
+		char magic[sizeof(MAP_MAGIC_FLAT)]{};
 
-		// reset vertex ranges
-		m_min_latitude = std::numeric_limits<t_real>::max();
-		m_max_latitude = -m_min_latitude;
-		m_min_longitude = std::numeric_limits<t_real>::max();
-		m_max_longitude = -m_min_longitude;
+		// the sizes of the types have to match the ones of the map
+		std::uint8_t real_size{};
+		std::uint8_t size_size{};
+		std::uint8_t strid_size{};
+		std::uint8_t flags{};
 
-		const auto& map_nodes = osm->get_child_optional("");
-		if(!map_nodes)
-			return false;
+		t_real min_latitude{}, max_latitude{};
+		t_real min_longitude{}, max_longitude{};
 
-		for(const auto& node : *map_nodes)
-		{
-			// node is a vertex
-			if(node.first == "node")
-				ImportVertexXml(node.second);
+		// byte offset and number of elements of the sections
+		std::array<std::uint64_t, std::size_t(FlatSection::NUM_SECTIONS)> offsets{};
+		std::array<std::uint64_t, std::size_t(FlatSection::NUM_SECTIONS)> counts{};
+	};
 
-			// node is a line segment or area
-			else if(node.first == "way")
-				ImportSegmentXml(node.second);
 
-			// node is a relation
-			else if(node.first == "relation")
-				ImportMultiSegmentXml(node.second);
-		}  // node iteration
 
-		//PruneUnreferenced();
-		return true;
-	}
+	/**
+	 * records of the flat map file format,
+	 * tag ranges refer to the tags section and id ranges to the ids section
+	 */
+	struct FlatTag
+	{
+		t_strid key{};
+		t_strid val{};
+	};
+
+	struct FlatVertex
+	{
+		t_real longitude{};
+		t_real latitude{};
+		t_size id{};
+		t_idrange tags{};
+	};
 
+	struct FlatSegment
+	{
+		t_size id{};
+		t_idrange vertex_ids{};
+		t_idrange tags{};
+		std::uint8_t is_area{};
+	};
+
+	struct FlatMultiSegment
+	{
+		t_size id{};
+		t_idrange vertex_ids{};
+		t_idrange segment_inner_ids{};
+		t_idrange segment_ids{};
+		t_idrange tags{};
+	};
 
 
-#ifdef _TRACKS_USE_OSMIUM_
 
 	/**
-	 * import a map from an osm or a pbf file
-	 * @see https://github.com/osmcode/libosmium/blob/master/examples/
-	 * @see https://osmcode.org/libosmium/manual.html
-	 * @see https://docs.osmcode.org/libosmium/latest/
+	 * get a section of a flat map file, checking that it is inside the file
 	 */
-	bool Import(const std::string& mapname,
-		t_real min_longitude = -10., t_real max_longitude = 10.,
-		t_real min_latitude = -10., t_real max_latitude = 10.,
-		std::function<bool(t_size, t_size)> *progress = nullptr,
-		bool check_bounds = false)
+	template<class t_elem>
+	static std::optional<std::span<const t_elem>> GetFlatSection(
+		const char *data, std::size_t size, const FlatHeader& header, FlatSection sec)
 	{
-		namespace num = std::numbers;
+		const std::uint64_t offs = header.offsets[std::size_t(sec)];
+		const std::uint64_t count = header.counts[std::size_t(sec)];
 
-		// reset vertex ranges
-		m_min_latitude = std::numeric_limits<t_real>::max();
-		m_max_latitude = -m_min_latitude;
-		m_min_longitude = std::numeric_limits<t_real>::max();
-		m_max_longitude = -m_min_longitude;
+		if(offs % alignof(t_elem) != 0 || offs > size || count > (size - offs) / sizeof(t_elem))
+			return std::nullopt;
 
-		struct OsmHandler : public osmium::handler::Handler
-		{
-		private:
-			Map<t_real, t_size> *super{};
-			const t_real *min_lon{}, *max_lon{};
-			const t_real *min_lat{}, *max_lat{};
+		return std::span<const t_elem>{
+			reinterpret_cast<const t_elem*>(data + offs),
+			static_cast<std::size_t>(count) };
+	}
 
-			const osmium::io::Reader* reader{};
-			std::optional<t_size> last_offs{};
-			std::function<bool(t_size, t_size)> *progress{};
 
 
-		public:
-			OsmHandler(Map<t_real, t_size> *super,
-				const t_real *min_lon, const t_real *max_lon,
-				const t_real *min_lat, const t_real *max_lat)
-				: super{super},
+	/**
+	 * get the corresponding local id for a map object id
+	 */
+	std::optional<t_size> GetLocalId(MapObjType ty, t_osmid id) const
+	{
+		const t_idmap *map = &m_local_vert_ids;
+
+		switch(ty)
+		{
+			case MapObjType::VERTEX:
+				map = &m_local_vert_ids;
+				break;
+			case MapObjType::SEGMENT:
+				map = &m_local_seg_ids;
+				break;
+			case MapObjType::MULTISEGMENT:
+				map = &m_local_multiseg_ids;
+				break;
+		}
+
+		return map->Find(id);
+	}
+
+
+
+	/**
+	 * register a corresponding local id for a map object id
+	 */
+	std::size_t RegisterLocalId(MapObjType ty, t_osmid id)
+	{
+		t_idmap *map = &m_local_vert_ids;
+		t_size *local_id = &m_cur_local_vert_id;
+
+		switch(ty)
+		{
+			case MapObjType::VERTEX:
+				map = &m_local_vert_ids;
+				local_id = &m_cur_local_vert_id;
+				break;
+			case MapObjType::SEGMENT:
+				map = &m_local_seg_ids;
+				local_id = &m_cur_local_seg_id;
+				break;
+			case MapObjType::MULTISEGMENT:
+				map = &m_local_multiseg_ids;
+				local_id = &m_cur_local_multiseg_id;
+				break;
+		}
+
+		// register a new id
+		if(map->Insert(id, *local_id))
+			return (*local_id)++;
+
+		// id already in map
+		return *map->Find(id);
+	}
+
+
+
+	bool HasRoadWidth(const std::string_view& key, const std::string_view& val) const
+	{
+		auto iter_widths = m_road_widths.find(key);
+		if(iter_widths == m_road_widths.end())
+			return false;
+
+		auto iter = iter_widths->second.find(val);
+		return iter != iter_widths->second.end();
+	}
+
+
+
+	/**
+	 * is an object with this tag left out of the map?
+	 */
+	bool IsSkippedObject(const std::string_view& key, const std::string_view& val) const
+	{
+		return m_skip_buildings && (key == "building"
+			|| (key == "leisure" && val == "swimming_pool"));
+	}
+
+
+
+	/**
+	 * is an object with these interned tags left out of the map?
+	 * used when exporting, as maps loaded from files may contain buildings
+	 */
+	bool IsSkippedObject(const t_tags& tags) const
+	{
+		if(!m_skip_buildings)
+			return false;
+
+		for(const t_tag& tag : tags)
+		{
+			if(tag.first == m_id_building
+				|| (tag.first == m_id_leisure && tag.second == m_id_swimming_pool))
+				return true;
+		}
+
+		return false;
+	}
+
+
+
+	bool HasSurfaceColour(const std::string_view& key, const std::string_view& val) const
+	{
+		if(!m_skip_buildings && key == "building")
+			return true;
+
+		auto iter_surf = m_seg_colours.find(key);
+		if(iter_surf == m_seg_colours.end())
+			return false;
+
+		auto iter = iter_surf->second.find(val);
+		return iter != iter_surf->second.end();
+	}
+
+
+
+	bool ImportVertexXml(const boost::property_tree::ptree& node)
+	{
+		namespace num = std::numbers;
+
+		auto id = node.get_optional<t_size>("<xmlattr>.id");
+		auto lon = node.get_optional<t_real>("<xmlattr>.lon");
+		auto lat = node.get_optional<t_real>("<xmlattr>.lat");
+		auto vis = node.get_optional<bool>("<xmlattr>.visible");
+		if(vis && !*vis)
+			return false;
+
+		if(!id || !lon || !lat)
+			return false;
+
+		t_vertex vertex
+		{
+			.longitude = *lon / t_real(180) * num::pi_v<t_real>,
+			.latitude = *lat / t_real(180) * num::pi_v<t_real>,
+			.referenced = true,  // mark all as referenced
+		};
+
+		bool has_place = false;
+		bool has_name = false;
+		if(auto tags = node.get_child_optional(""))
+		{
+			for(const auto& tag : *tags)
+			{
+				if(tag.first != "tag")
+					continue;
+
+				auto key = tag.second.get_optional<std::string>("<xmlattr>.k");
+				auto val = tag.second.get_optional<std::string>("<xmlattr>.v");
+
+				if(!key || !val)
+					continue;
+
+				bool found_tag = false;
+				if(!has_place && *key == "place")
+				{
+					has_place = true;
+					found_tag = true;
+				}
+				if(!has_name && *key == "name")
+				{
+					has_name = true;
+					found_tag = true;
+				}
+
+				if(!m_skip_unnecessary_tags || (!m_skip_labels && found_tag))
+					AddTag(vertex.tags, *key, *val);
+			}
+		}
+
+		// vertex ranges
+		m_min_latitude = std::min(m_min_latitude, vertex.latitude);
+		m_max_latitude = std::max(m_max_latitude, vertex.latitude);
+		m_min_longitude = std::min(m_min_longitude, vertex.longitude);
+		m_max_longitude = std::max(m_max_longitude, vertex.longitude);
+
+		if(has_place && has_name)
+		{
+			if(!m_skip_labels)
+			{
+				// place label
+				t_size local_id = RegisterLocalId(MapObjType::VERTEX, *id);
+				m_label_vertices.emplace(std::make_pair(local_id, std::move(vertex)));
+			}
+		}
+		else
+		{
+			// vertex
+			t_size local_id = RegisterLocalId(MapObjType::VERTEX, *id);
+			m_vertices.emplace(std::make_pair(local_id, std::move(vertex)));
+		}
+
+		return true;
+	}
+
+
+
+	bool ImportSegmentXml(const boost::property_tree::ptree& node)
+	{
+		auto id = node.get_optional<t_size>("<xmlattr>.id");
+		auto vis = node.get_optional<bool>("<xmlattr>.visible");
+		if(vis && !*vis)
+			return false;
+
+		t_segment seg{};
+		seg.referenced = true;  // mark all as referenced
+		std::vector<t_size> vertex_ids;
+		bool is_background = false;
+		bool is_foreground = false;
+		bool is_road = false;
+
+		if(auto tags = node.get_child_optional(""))
+		{
+			for(const auto& tag : *tags)
+			{
+				if(tag.first == "nd")
+				{
+					auto vertex_id = tag.second.get_optional<t_size>("<xmlattr>.ref");
+					if(!vertex_id)
+						continue;
+
+					std::optional<t_size> local_id = GetLocalId(MapObjType::VERTEX, *vertex_id);
+					if(!local_id)
+						continue;
+
+					vertex_ids.push_back(*local_id);
+				}
+				else if(tag.first == "tag")
+				{
+					auto key = tag.second.get_optional<std::string>("<xmlattr>.k");
+					auto val = tag.second.get_optional<std::string>("<xmlattr>.v");
+
+					if(!key || !val)
+						continue;
+
+					if(!is_background && (*key == "landuse" || *key == "natural"))
+						is_background = true;
+					if(!is_foreground && (*key == "natural" && *val == "water"))
+						is_foreground = true;
+					if(!is_road && m_road_widths.find(*key) != m_road_widths.end())
+						is_road = true;
+					if(m_skip_buildings && (*key == "building"
+						|| (*key == "leisure" && *val == "swimming_pool")))
+						return false;
+
+					if(!m_skip_unnecessary_tags
+						|| HasSurfaceColour(*key, *val)
+						|| HasRoadWidth(*key, *val))
+					{
+						AddTag(seg.tags, *key, *val);
+					}
+				}
+			}
+		}
+
+		if(vertex_ids.size() >= 2 && *vertex_ids.begin() == *vertex_ids.rbegin())
+			seg.is_area = true;
+		if(is_road)
+			seg.is_area = false;
+		seg.vertex_ids = AddIds(vertex_ids);
+
+		t_size local_id = RegisterLocalId(MapObjType::SEGMENT, *id);
+		if(is_foreground)
+			m_segments_foreground.emplace(std::make_pair(local_id, std::move(seg)));
+		else if(is_background)
+			m_segments_background.emplace(std::make_pair(local_id, std::move(seg)));
+		else /*if(seg.tags.size())*/
+			m_segments.emplace(std::make_pair(local_id, std::move(seg)));
+
+		return true;
+	}
+
+
+
+	bool ImportMultiSegmentXml(const boost::property_tree::ptree& node)
+	{
+		auto id = node.get_optional<t_size>("<xmlattr>.id");
+		auto vis = node.get_optional<bool>("<xmlattr>.visible");
+		if(vis && !*vis)
+			return false;
+
+		t_multisegment seg{};
+		std::vector<t_size> vertex_ids, segment_inner_ids, segment_ids;
+
+		if(auto tags = node.get_child_optional(""))
+		{
+			for(const auto& tag : *tags)
+			{
+				if(tag.first == "member")
+				{
+					auto seg_ty = tag.second.get_optional<std::string>("<xmlattr>.type");
+					auto seg_ref = tag.second.get_optional<t_size>("<xmlattr>.ref");
+					auto seg_role = tag.second.get_optional<std::string>("<xmlattr>.role");
+					if(!seg_ty || !seg_ref)
+						continue;
+
+					if(*seg_ty == "node")
+					{
+						std::optional<t_size> local_id = GetLocalId(MapObjType::VERTEX, *seg_ref);
+						if(!local_id)
+							continue;
+
+						vertex_ids.push_back(*local_id);
+					}
+					else if(*seg_ty == "way" && seg_role && *seg_role == "inner")
+					{
+						std::optional<t_size> local_id = GetLocalId(MapObjType::SEGMENT, *seg_ref);
+						if(!local_id)
+							continue;
+
+						segment_inner_ids.push_back(*local_id);
+					}
+					else if(*seg_ty == "way")
+					{
+						std::optional<t_size> local_id = GetLocalId(MapObjType::SEGMENT, *seg_ref);
+						if(!local_id)
+							continue;
+
+						segment_ids.push_back(*local_id);
+					}
+
+				}
+				else if(tag.first == "tag")
+				{
+					auto key = tag.second.get_optional<std::string>("<xmlattr>.k");
+					auto val = tag.second.get_optional<std::string>("<xmlattr>.v");
+
+					if(!key || !val)
+						continue;
+
+					if(m_skip_buildings && (*key == "building"
+						|| (*key == "leisure" && *val == "swimming_pool")))
+						return false;
+
+					if(!m_skip_unnecessary_tags
+						|| HasSurfaceColour(*key, *val)
+						|| HasRoadWidth(*key, *val))
+					{
+						AddTag(seg.tags, *key, *val);
+					}
+				}
+			}
+		}
+
+		seg.vertex_ids = AddIds(vertex_ids);
+		seg.segment_inner_ids = AddIds(segment_inner_ids);
+		seg.segment_ids = AddIds(segment_ids);
+
+		t_size local_id = RegisterLocalId(MapObjType::MULTISEGMENT, *id);
+		//if(seg.tags.size())
+		m_multisegments.emplace(std::make_pair(local_id, std::move(seg)));
+
+		return true;
+	}
+
+
+
+public:
+	/**
+	 * import a map from an osm file
+	 * @see https://wiki.openstreetmap.org/wiki/OSM_XML
+	 * @see https://wiki.openstreetmap.org/wiki/Elements
+	 */
+	bool ImportXml(const std::string& mapname)
+	{
+		namespace fs = __map_fs;
+		namespace ptree = boost::property_tree;
+
+		ProfileTimer timer{"Map::ImportXml"};
+		timer.SetArgument("file", mapname);
+		InvalidateIndex();
+
+		fs::path mapfile{mapname};
+		if(!fs::exists(mapfile))
+			return false;
+
+		ptree::ptree map_root;
+		ptree::read_xml(mapname, map_root);
+
+		const auto& osm = map_root.get_child_optional("osm");
+		if(!osm)
+			return false;
+
+		m_filename = mapfile.filename().string();
+		m_version = osm->get<std::string>("<xmlattr>.version", "<unknown>");
+		m_creator = osm->get<std::string>("<xmlattr>.generator", "<unknown>");
+
+		// reset vertex ranges
+		m_min_latitude = std::numeric_limits<t_real>::max();
+		m_max_latitude = -m_min_latitude;
+		m_min_longitude = std::numeric_limits<t_real>::max();
+		m_max_longitude = -m_min_longitude;
+
+		const auto& map_nodes = osm->get_child_optional("");
+		if(!map_nodes)
+			return false;
+
+		for(const auto& node : *map_nodes)
+		{
+			// node is a vertex
+			if(node.first == "node")
+				ImportVertexXml(node.second);
+
+			// node is a line segment or area
+			else if(node.first == "way")
+				ImportSegmentXml(node.second);
+
+			// node is a relation
+			else if(node.first == "relation")
+				ImportMultiSegmentXml(node.second);
+		}  // node iteration
+
+		//PruneUnreferenced();
+		CountObjects();
+		return true;
+	}
+
+
+
+#ifdef _TRACKS_USE_OSMIUM_
+
+	/**
+	 * get the valid bounds given in the header of an osm file
+	 */
+	static std::vector<t_bounds> GetHeaderBounds(const osmium::io::Header& header)
+	{
+		namespace num = std::numbers;
+
+		std::vector<t_bounds> bounds;
+
+		for(const osmium::Box& box : header.boxes())
+		{
+			if(!box.valid())
+				continue;
+
+			bounds.emplace_back(
+				box.left() / t_real(180) * num::pi_v<t_real>,
+				box.right() / t_real(180) * num::pi_v<t_real>,
+				box.bottom() / t_real(180) * num::pi_v<t_real>,
+				box.top() / t_real(180) * num::pi_v<t_real>);
+		}
+
+		return bounds;
+	}
+
+
+
+	/**
+	 * read the bounds from the header of an osm file without reading its objects
+	 */
+	static std::optional<std::vector<t_bounds>> ReadHeaderBounds(const std::string& mapname)
+	{
+		try
+		{
+			osmium::io::Reader osm{mapname, osmium::osm_entity_bits::nothing};
+			std::vector<t_bounds> bounds = GetHeaderBounds(osm.header());
+			osm.close();
+
+			return bounds;
+		}
+		catch(const std::exception& ex)
+		{
+			std::cerr << ex.what() << std::endl;
+			return std::nullopt;
+		}
+	}
+
+
+
+	/**
+	 * import a map from an osm or a pbf file
+	 * @see https://github.com/osmcode/libosmium/blob/master/examples/
+	 * @see https://osmcode.org/libosmium/manual.html
+	 * @see https://docs.osmcode.org/libosmium/latest/
+	 */
+	bool Import(const std::string& mapname,
+		t_real min_longitude = -10., t_real max_longitude = 10.,
+		t_real min_latitude = -10., t_real max_latitude = 10.,
+		std::function<bool(t_size, t_size)> *progress = nullptr,
+		bool check_bounds = false)
+	{
+		namespace num = std::numbers;
+
+		ProfileTimer timer{"Map::Import"};
+		timer.SetArgument("file", mapname);
+		InvalidateIndex();
+
+		// reset vertex ranges
+		m_min_latitude = std::numeric_limits<t_real>::max();
+		m_max_latitude = -m_min_latitude;
+		m_min_longitude = std::numeric_limits<t_real>::max();
+		m_max_longitude = -m_min_longitude;
+
+		// layers of the converted segments
+		enum class SegmentLayer { MAIN, BACKGROUND, FOREGROUND };
+
+		// map objects converted from one block of the osm file, with
+		// ids and tags referring to ranges in the chunk's own buffers
+		struct OsmChunk
+		{
+			// keeps the strings of the tags alive until they are interned
+			std::shared_ptr<osmium::memory::Buffer> buffer{};
+
+			std::vector<std::pair<std::string_view, std::string_view>> tags{};
+			std::vector<t_size> ids{};
+
+			// osm id, object, range of its tags and its kind
+			std::vector<std::tuple<t_osmid, t_vertex, t_idrange, bool>> vertices{};
+			std::vector<std::tuple<t_osmid, t_segment, t_idrange, SegmentLayer>> segments{};
+			std::vector<std::tuple<t_osmid, t_multisegment, t_idrange>> multisegments{};
+		};
+
+		// finds the object types contained in a block
+		struct OsmTypeScanner : public osmium::handler::Handler
+		{
+			bool has_nodes{false};
+			bool has_ways{false};
+			bool has_relations{false};
+
+			void node(const osmium::Node&) { has_nodes = true; }
+			void way(const osmium::Way&) { has_ways = true; }
+			void relation(const osmium::Relation&) { has_relations = true; }
+		};
+
+		// filters and converts the objects of one type in a block,
+		// only reads from the map, so several converters can run in parallel
+		struct OsmConverter : public osmium::handler::Handler
+		{
+		private:
+			const Map<t_real, t_size> *super{};
+			osmium::item_type type{};
+			OsmChunk *chunk{};
+			const SparseIdSet<t_osmid> *needed_nodes{};
+
+			t_real min_lon{}, max_lon{};
+			t_real min_lat{}, max_lat{};
+
+			std::vector<t_size> vertex_ids{}, segment_inner_ids{}, segment_ids{};
+
+
+		public:
+			OsmConverter(const Map<t_real, t_size> *super,
+				osmium::item_type type, OsmChunk *chunk,
+				const SparseIdSet<t_osmid> *needed_nodes,
+				t_real min_lon, t_real max_lon,
+				t_real min_lat, t_real max_lat)
+				: super{super}, type{type}, chunk{chunk}, needed_nodes{needed_nodes},
 					min_lon{min_lon}, max_lon{max_lon},
 					min_lat{min_lat}, max_lat{max_lat}
 			{}
 
+			OsmConverter(const OsmConverter&) = delete;
+			OsmConverter& operator=(const OsmConverter&) = delete;
+
+
+			/**
+			 * add a tag to the chunk and extend the object's tag range
+			 */
+			void add_tag(t_idrange& tags, std::string_view key, std::string_view val)
+			{
+				chunk->tags.emplace_back(std::make_pair(key, val));
+				++tags.count;
+			}
+
+
+			/**
+			 * remove the tags of a rejected object
+			 */
+			void drop_tags(const t_idrange& tags)
+			{
+				chunk->tags.resize(tags.begin);
+			}
+
+
+			void node(const osmium::Node& node)
+			{
+				if(type != osmium::item_type::node || !node.visible())
+					return;
+
+				t_real lon = node.location().lon() / t_real(180) * num::pi_v<t_real>;
+				t_real lat = node.location().lat() / t_real(180) * num::pi_v<t_real>;
+
+				// is the vertex within requested bounds?
+				if(lon < min_lon || lon > max_lon ||
+					lat < min_lat || lat > max_lat)
+					return;
+
+				// in a two-pass import only the nodes referenced
+				// by ways or relations are kept, besides labels
+				const bool is_needed = !needed_nodes || needed_nodes->Contains(node.id());
+				if(!is_needed && super->m_skip_labels)
+					return;
+
+				t_vertex vertex
+				{
+					.longitude = lon,
+					.latitude = lat,
+				};
+
+				t_idrange tags{ .begin = static_cast<t_size>(chunk->tags.size()) };
+				bool has_place = false;
+				bool has_name = false;
+				for(const auto& tag : node.tags())
+				{
+					bool found_tag = false;
+					std::string_view key{tag.key()};
+
+					if(!has_place && key == "place")
+					{
+						has_place = true;
+						found_tag = true;
+					}
+					if(!has_name && key == "name")
+					{
+						has_name = true;
+						found_tag = true;
+					}
+
+					if(!super->m_skip_unnecessary_tags ||
+						(!super->m_skip_labels && found_tag))
+					{
+						add_tag(tags, key, tag.value());
+					}
+				}
+
+				// place labels are only kept if they are shown
+				const bool is_label = has_place && has_name;
+				if((is_label && super->m_skip_labels) || (!is_label && !is_needed))
+				{
+					drop_tags(tags);
+					return;
+				}
+
+				chunk->vertices.emplace_back(std::make_tuple(
+					node.id(), std::move(vertex), tags, is_label));
+			}
+
+
+			void way(const osmium::Way& way)
+			{
+				if(type != osmium::item_type::way || !way.visible())
+					return;
+
+				t_segment seg{};
+
+				// get segment tags
+				t_idrange tags{ .begin = static_cast<t_size>(chunk->tags.size()) };
+				bool is_background = false;
+				bool is_foreground = false;
+				bool is_road = false;
+				for(const auto& tag : way.tags())
+				{
+					std::string_view key{tag.key()};
+					std::string_view val{tag.value()};
+
+					if(!is_background && (key == "landuse" || key == "natural"))
+						is_background = true;
+					if(!is_foreground && (key == "natural" && val == "water"))
+						is_foreground = true;
+					if(!is_road && super->m_road_widths.find(key) != super->m_road_widths.end())
+						is_road = true;
+					if(super->IsSkippedObject(key, val))
+					{
+						drop_tags(tags);
+						return;
+					}
+
+					if(!super->m_skip_unnecessary_tags
+						|| super->HasSurfaceColour(key, val)
+						|| super->HasRoadWidth(key, val))
+					{
+						add_tag(tags, key, val);
+					}
+				}
+
+				// get segment vertices
+				seg.vertex_ids.begin = static_cast<t_size>(chunk->ids.size());
+				t_size node_idx = 0;
+				for(const auto& node : way.nodes())
+				{
+					std::optional<t_size> ref = super->GetLocalId(MapObjType::VERTEX, node.ref());
+					if(ref && super->m_vertices.Find(*ref))
+					{
+						chunk->ids.push_back(*ref);
+						++seg.vertex_ids.count;
+					}
+
+					// first and last vertices are the same?
+					if(node_idx == way.nodes().size() - 1 &&
+						node.ref() == way.nodes().begin()->ref())
+					{
+						seg.is_area = true;
+					}
+
+					++node_idx;
+				}
+
+				// only referring to invalid vertices?
+				if(!seg.vertex_ids.count)
+				{
+					drop_tags(tags);
+					return;
+				}
+				if(is_road)
+					seg.is_area = false;
+
+				SegmentLayer layer = SegmentLayer::MAIN;
+				if(is_foreground)
+					layer = SegmentLayer::FOREGROUND;
+				else if(is_background)
+					layer = SegmentLayer::BACKGROUND;
+
+				chunk->segments.emplace_back(std::make_tuple(
+					way.id(), std::move(seg), tags, layer));
+			}
+
+
+			void relation(const osmium::Relation& rel)
+			{
+				if(type != osmium::item_type::relation)
+					return;
+
+				t_multisegment seg{};
+
+				// get tags
+				t_idrange tags{ .begin = static_cast<t_size>(chunk->tags.size()) };
+				for(const auto& tag : rel.tags())
+				{
+					std::string_view key{tag.key()};
+					std::string_view val{tag.value()};
+
+					if(super->IsSkippedObject(key, val))
+					{
+						drop_tags(tags);
+						return;
+					}
+
+					if(!super->m_skip_unnecessary_tags
+						|| super->HasSurfaceColour(key, val)
+						|| super->HasRoadWidth(key, val))
+					{
+						add_tag(tags, key, val);
+					}
+				}
+
+				// get vertices
+				vertex_ids.clear();
+				segment_inner_ids.clear();
+				segment_ids.clear();
+				for(const auto& member : rel.members())
+				{
+					if(member.type() == osmium::item_type::node)
+					{
+						std::optional<t_size> ref = super->GetLocalId(MapObjType::VERTEX, member.ref());
+						if(!ref || !super->m_vertices.Find(*ref))
+							continue;
+
+						vertex_ids.push_back(*ref);
+					}
+					else if(member.type() == osmium::item_type::way &&
+						std::string_view(member.role()) == "inner")
+					{
+						std::optional<t_size> ref = super->GetLocalId(MapObjType::SEGMENT, member.ref());
+						if(!ref || !super->m_segments.Find(*ref))
+							continue;
+
+						segment_inner_ids.push_back(*ref);
+					}
+					else if(member.type() == osmium::item_type::way /*&&
+						std::string_view(member.role()) == "outer"*/)
+					{
+						std::optional<t_size> ref = super->GetLocalId(MapObjType::SEGMENT, member.ref());
+						if(!ref || !super->m_segments.Find(*ref))
+							continue;
+
+						segment_ids.push_back(*ref);
+					}
+				}
+
+				// only referring to invalid objects?
+				if(!vertex_ids.size() && !segment_inner_ids.size() &&
+					!segment_ids.size())
+				{
+					drop_tags(tags);
+					return;
+				}
+
+				auto add_ids = [this](const std::vector<t_size>& ids) -> t_idrange
+				{
+					t_idrange range{ .begin = static_cast<t_size>(chunk->ids.size()),
+						.count = static_cast<t_size>(ids.size()) };
+					chunk->ids.insert(chunk->ids.end(), ids.begin(), ids.end());
+					return range;
+				};
+
+				seg.vertex_ids = add_ids(vertex_ids);
+				seg.segment_inner_ids = add_ids(segment_inner_ids);
+				seg.segment_ids = add_ids(segment_ids);
+
+				chunk->multisegments.emplace_back(std::make_tuple(
+					rel.id(), std::move(seg), tags));
+			}
+		};
+
+		// first pass of a two-pass import, collects the ids
+		// of the nodes referenced by the ways and relations
+		struct OsmNodeCollector : public osmium::handler::Handler
+		{
+		private:
+			const Map<t_real, t_size> *super{};
+			SparseIdSet<t_osmid> *nodes{};
+
+
+			bool is_skipped(const osmium::TagList& tags) const
+			{
+				for(const auto& tag : tags)
+				{
+					if(super->IsSkippedObject(tag.key(), tag.value()))
+						return true;
+				}
+
+				return false;
+			}
+
+
+		public:
+			OsmNodeCollector(const Map<t_real, t_size> *super, SparseIdSet<t_osmid> *nodes)
+				: super{super}, nodes{nodes}
+			{}
+
+			OsmNodeCollector(const OsmNodeCollector&) = delete;
+			OsmNodeCollector& operator=(const OsmNodeCollector&) = delete;
+
+
+			void way(const osmium::Way& way)
+			{
+				if(!way.visible() || is_skipped(way.tags()))
+					return;
+
+				for(const auto& node : way.nodes())
+					nodes->Insert(node.ref());
+			}
+
+
+			void relation(const osmium::Relation& rel)
+			{
+				if(is_skipped(rel.tags()))
+					return;
+
+				for(const auto& member : rel.members())
+				{
+					if(member.type() == osmium::item_type::node)
+						nodes->Insert(member.ref());
+				}
+			}
+		};
+
+		// registers the converted objects in the order of the file,
+		// so the local ids are the same as for a sequential import
+		auto merge_chunk = [this](OsmChunk& chunk)
+		{
+			TRACKS_PROFILE_SCOPE("Map::Import merge");
+
+			const t_size ids_base = static_cast<t_size>(m_ids.size());
+			m_ids.insert(m_ids.end(), chunk.ids.begin(), chunk.ids.end());
+
+			auto add_tags = [this, &chunk](t_tags& tags, const t_idrange& range)
+			{
+				for(t_size idx = range.begin; idx < range.begin + range.count; ++idx)
+					AddTag(tags, chunk.tags[idx].first, chunk.tags[idx].second);
+			};
+
+			auto rebase_ids = [ids_base](t_idrange& range)
+			{
+				range.begin += ids_base;
+			};
+
+			for(auto& [ osm_id, vertex, tags, is_label ] : chunk.vertices)
+			{
+				// vertex ranges
+				m_min_latitude = std::min(m_min_latitude, vertex.latitude);
+				m_max_latitude = std::max(m_max_latitude, vertex.latitude);
+				m_min_longitude = std::min(m_min_longitude, vertex.longitude);
+				m_max_longitude = std::max(m_max_longitude, vertex.longitude);
+
+				add_tags(vertex.tags, tags);
+
+				const t_size local_id = RegisterLocalId(MapObjType::VERTEX, osm_id);
+				if(is_label)
+					m_label_vertices.emplace(std::make_pair(local_id, std::move(vertex)));
+				else
+					m_vertices.emplace(std::make_pair(local_id, std::move(vertex)));
+			}
+
+			for(auto& [ osm_id, seg, tags, layer ] : chunk.segments)
+			{
+				rebase_ids(seg.vertex_ids);
+				for(const t_size vert_id : GetIds(seg.vertex_ids))
+					m_vertices.Find(vert_id)->referenced = true;
+
+				add_tags(seg.tags, tags);
+
+				const t_size local_id = RegisterLocalId(MapObjType::SEGMENT, osm_id);
+				if(layer == SegmentLayer::FOREGROUND)
+					m_segments_foreground.emplace(std::make_pair(local_id, std::move(seg)));
+				else if(layer == SegmentLayer::BACKGROUND)
+					m_segments_background.emplace(std::make_pair(local_id, std::move(seg)));
+				else
+					m_segments.emplace(std::make_pair(local_id, std::move(seg)));
+			}
+
+			for(auto& [ osm_id, seg, tags ] : chunk.multisegments)
+			{
+				rebase_ids(seg.vertex_ids);
+				rebase_ids(seg.segment_inner_ids);
+				rebase_ids(seg.segment_ids);
+
+				for(const t_size vert_id : GetIds(seg.vertex_ids))
+					m_vertices.Find(vert_id)->referenced = true;
+				for(const t_size seg_id : GetIds(seg.segment_inner_ids))
+					m_segments.Find(seg_id)->referenced = true;
+				for(const t_size seg_id : GetIds(seg.segment_ids))
+					m_segments.Find(seg_id)->referenced = true;
+
+				add_tags(seg.tags, tags);
+
+				const t_size local_id = RegisterLocalId(MapObjType::MULTISEGMENT, osm_id);
+				m_multisegments.emplace(std::make_pair(local_id, std::move(seg)));
+			}
+		};
+
+		try
+		{
+			osmium::io::Reader osm{mapname,
+				osmium::osm_entity_bits::node | osmium::osm_entity_bits::way
+				| osmium::osm_entity_bits::relation,
+				osmium::io::read_meta::yes};
+			bool contained = true;
+
+			// if valid bounds are given, check if the map is contained within
+			if(check_bounds)
+			{
+				contained = IsContained(GetHeaderBounds(osm.header()),
+					min_longitude, max_longitude, min_latitude, max_latitude);
+			}
+
+			if(!contained)
+				return false;
+
+			// the progress of both passes of a two-pass import
+			auto report_progress = [this, progress](const osmium::io::Reader& reader, int pass)
+			{
+				if(!progress)
+					return;
+
+				t_size offs = reader.offset();
+				t_size size = reader.file_size();
+				if(m_two_pass_import)
+					offs = (t_size(pass) * size + offs) / 2;
+
+				if(!(*progress)(offs, size))
+					throw std::runtime_error{"Stop requested."};
+			};
+
+			// first pass: only keep the nodes needed by the ways and relations
+			std::optional<SparseIdSet<t_osmid>> needed_nodes;
+			if(m_two_pass_import)
+			{
+				TRACKS_PROFILE_SCOPE("Map::Import collect");
+
+				osmium::io::Reader osm_refs{mapname,
+					osmium::osm_entity_bits::way | osmium::osm_entity_bits::relation,
+					osmium::io::read_meta::no};
+
+				needed_nodes.emplace();
+				OsmNodeCollector collector{this, &*needed_nodes};
+
+				while(osmium::memory::Buffer block = osm_refs.read())
+				{
+					osmium::apply(block, collector);
+					report_progress(osm_refs, 0);
+				}
+
+				osm_refs.close();
+				TRACKS_PROFILE_COUNT("Map::Import needed nodes", needed_nodes->size());
+			}
+
+			TRACKS_PROFILE_SCOPE("Map::Import read");
+
+			// the reader decodes the blocks of the file in parallel,
+			// the objects in the blocks are converted by the worker threads
+			std::deque<std::future<OsmChunk>> pending;
+			const std::size_t max_pending = std::max<std::size_t>(m_num_threads, 1) * 4;
+			boost::asio::thread_pool tp{m_num_threads};
+
+			auto merge_next = [&pending, &merge_chunk]()
+			{
+				OsmChunk chunk = pending.front().get();
+				pending.pop_front();
+				merge_chunk(chunk);
+			};
+
+			osmium::item_type stage = osmium::item_type::node;
+
+			while(osmium::memory::Buffer block = osm.read())
+			{
+				auto buffer = std::make_shared<osmium::memory::Buffer>(std::move(block));
+
+				OsmTypeScanner scanner;
+				osmium::apply(*buffer, scanner);
+
+				for(const auto& type_entry : {
+					std::make_pair(osmium::item_type::node, scanner.has_nodes),
+					std::make_pair(osmium::item_type::way, scanner.has_ways),
+					std::make_pair(osmium::item_type::relation, scanner.has_relations) })
+				{
+					if(!type_entry.second)
+						continue;
+					const osmium::item_type type = type_entry.first;
+
+					// ways refer to the local ids of all previous nodes,
+					// and relations to the ones of all previous ways
+					if(type != stage)
+					{
+						while(pending.size())
+							merge_next();
+						stage = type;
+					}
+
+					const SparseIdSet<t_osmid> *needed = needed_nodes ? &*needed_nodes : nullptr;
+					auto task = std::make_shared<std::packaged_task<OsmChunk()>>(
+						[this, buffer, type, needed, min_longitude, max_longitude,
+							min_latitude, max_latitude]() -> OsmChunk
+					{
+						TRACKS_PROFILE_SCOPE("Map::Import convert");
+
+						OsmChunk chunk{ .buffer = buffer };
+						OsmConverter converter{this, type, &chunk, needed,
+							min_longitude, max_longitude,
+							min_latitude, max_latitude};
+						osmium::apply(*buffer, converter);
+
+						return chunk;
+					});
+
+					pending.emplace_back(task->get_future());
+					boost::asio::post(tp, [task]() -> void { (*task)(); });
+
+					while(pending.size() > max_pending)
+						merge_next();
+				}
+
+				report_progress(osm, 1);
+			}
+
+			while(pending.size())
+				merge_next();
+
+			tp.join();
+			osm.close();
+		}
+		catch(const std::exception& ex)
+		{
+			std::cerr << ex.what() << std::endl;
+			return false;
+		}
+
+		PruneUnreferenced();
+		CountObjects();
+		return true;
+	}
+
+#else
+
+	bool Import(const std::string& mapname,
+		t_real = -10., t_real = 10.,
+		t_real = -10., t_real = 10.,
+		std::function<bool(t_size, t_size)>* = nullptr,
+		bool = false)
+	{
+		std::cerr << "Cannot import \"" << mapname
+			<< "\" because osmium support is disabled."
+			<< std::endl;
+		return false;
+	}
+
+
+
+	static std::optional<std::vector<t_bounds>> ReadHeaderBounds(const std::string&)
+	{
+		return std::nullopt;
+	}
+
+#endif  // _TRACKS_USE_OSMIUM_
+
+
+
+	/**
+	 * check if the given bounds are contained in one of the bounds of a map file,
+	 * invalid bounds match any map file
+	 */
+	static bool IsContained(const std::vector<t_bounds>& file_bounds,
+		t_real min_longitude, t_real max_longitude,
+		t_real min_latitude, t_real max_latitude)
+	{
+		namespace num = std::numbers;
+
+		if(min_longitude < -num::pi_v<t_real> || max_longitude > num::pi_v<t_real> ||
+			min_latitude < -num::pi_v<t_real>/t_real(2) || max_latitude > num::pi_v<t_real>/t_real(2))
+			return true;
+
+		for(const auto& [ file_min_lon, file_max_lon, file_min_lat, file_max_lat ] : file_bounds)
+		{
+			if(file_min_lon <= min_longitude && file_max_lon >= max_longitude &&
+				file_min_lat <= min_latitude && file_max_lat >= max_latitude)
+				return true;
+		}
+
+		return false;
+	}
+
+
+
+	/**
+	 * check if the given bounds intersect one of the bounds of a map file
+	 */
+	static bool IsIntersecting(const std::vector<t_bounds>& file_bounds,
+		t_real min_longitude, t_real max_longitude,
+		t_real min_latitude, t_real max_latitude)
+	{
+		for(const auto& [ file_min_lon, file_max_lon, file_min_lat, file_max_lat ] : file_bounds)
+		{
+			if(file_min_lon <= max_longitude && file_max_lon >= min_longitude &&
+				file_min_lat <= max_latitude && file_max_lat >= min_latitude)
+				return true;
+		}
+
+		return false;
+	}
+
+
+
+	/**
+	 * import several map files in parallel and merge them, objects contained
+	 * in more than one file, like at the borders of extracts, are only added once
+	 */
+	bool ImportFiles(const std::vector<std::string>& mapnames,
+		t_real min_longitude = -10., t_real max_longitude = 10.,
+		t_real min_latitude = -10., t_real max_latitude = 10.,
+		std::function<bool(t_size, t_size)> *progress = nullptr)
+	{
+		ProfileTimer timer{"Map::ImportFiles"};
+		timer.SetArgument("files", std::to_string(mapnames.size()));
+
+		const std::size_t num_files = mapnames.size();
+		if(num_files == 0)
+			return false;
+
+		// progress of the individual imports
+		std::vector<std::atomic<t_size>> offsets(num_files), sizes(num_files);
+		std::atomic<bool> stop{false};
+
+		std::vector<std::unique_ptr<Map>> maps;
+		std::vector<std::future<bool>> results;
+		maps.reserve(num_files);
+		results.reserve(num_files);
+
+		// divide the threads between the files imported at the same time,
+		// further files are imported once a previous one has finished
+		const std::size_t num_parallel = std::min<std::size_t>(num_files, m_num_threads);
+		const unsigned int num_file_threads = std::max<unsigned int>(
+			m_num_threads / static_cast<unsigned int>(num_parallel), 1);
+		boost::asio::thread_pool tp{num_parallel};
+
+		for(std::size_t idx = 0; idx < num_files; ++idx)
+		{
+			std::unique_ptr<Map> map = std::make_unique<Map>();
+			map->SetSkipBuildings(m_skip_buildings);
+			map->SetSkipLabels(m_skip_labels);
+			map->SetTwoPassImport(m_two_pass_import);
+			map->SetNumThreads(num_file_threads);
+			map->m_skip_unnecessary_tags = m_skip_unnecessary_tags;
+			if(m_node_index_file != "")
+				map->SetNodeIndexFile(m_node_index_file + "." + std::to_string(idx));
+
+			auto task = std::make_shared<std::packaged_task<bool()>>(
+				[map = map.get(), &mapname = mapnames[idx], idx, &offsets, &sizes, &stop,
+				min_longitude, max_longitude, min_latitude, max_latitude]() -> bool
+			{
+				std::function<bool(t_size, t_size)> file_progress =
+					[idx, &offsets, &sizes, &stop](t_size offs, t_size size) -> bool
+				{
+					offsets[idx] = offs;
+					sizes[idx] = size;
+					return !stop;
+				};
+
+				return map->Import(mapname,
+					min_longitude, max_longitude,
+					min_latitude, max_latitude,
+					&file_progress, false);
+			});
+
+			results.emplace_back(task->get_future());
+			boost::asio::post(tp, [task]() { (*task)(); });
+			maps.emplace_back(std::move(map));
+		}
+
+		// report the combined progress while waiting for the imports
+		for(std::future<bool>& result : results)
+		{
+			while(result.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+			{
+				if(!progress || stop)
+					continue;
+
+				t_size offs = 0, size = 0;
+				for(std::size_t idx = 0; idx < num_files; ++idx)
+				{
+					offs += offsets[idx];
+					size += sizes[idx];
+				}
+
+				if(!(*progress)(offs, size))
+					stop = true;
+			}
+		}
+
+		tp.join();
+		if(stop)
+			return false;
+
+		// reset vertex ranges
+		m_min_latitude = std::numeric_limits<t_real>::max();
+		m_max_latitude = -m_min_latitude;
+		m_min_longitude = std::numeric_limits<t_real>::max();
+		m_max_longitude = -m_min_longitude;
+
+		// merge the maps in the order of the files
+		bool imported = false;
+		for(std::size_t idx = 0; idx < num_files; ++idx)
+		{
+			if(results[idx].get())
+			{
+				Merge(*maps[idx]);
+				imported = true;
+			}
+
+			maps[idx].reset();
+		}
+
+		CountObjects();
+		return imported;
+	}
+
+
+
+	/**
+	 * try to import from all map files in a given directory
+	 * until a map with matching bounds has been found
+	 */
+	bool ImportDir(const std::string& dirname,
+		t_real min_longitude = -10., t_real max_longitude = 10.,
+		t_real min_latitude = -10., t_real max_latitude = 10.,
+		std::function<bool(t_size, t_size)> *progress = nullptr)
+	{
+		namespace fs = __map_fs;
+
+		// if a file is given instead of a directory, load it directly
+		// without bounds checks ...
+		if(fs::is_regular_file(dirname))
+		{
+			return Import(dirname,
+				min_longitude, max_longitude,
+				min_latitude, max_latitude,
+				progress, false);
+		}
+
+		// ... otherwise find the files with the correct bounds using the index
+		// of the directory, which only needs to read the headers of changed files
+		MapDirIndex<t_real> index;
+		const fs::path index_file = fs::path{dirname} / MAP_DIR_INDEX;
+		{
+			TRACKS_PROFILE_SCOPE("Map::ImportDir index");
+
+			index.Load(index_file.string());
+			if(index.Update(dirname, &ReadHeaderBounds))
+			{
+				// the directory may not be writable
+				if(!index.Save(index_file.string()))
+					std::cerr << "Could not write \"" << index_file.string() << "\"." << std::endl;
+			}
+		}
+
+		for(const auto& entry : index.GetEntries())
+		{
+			if(!IsContained(entry.bounds,
+				min_longitude, max_longitude,
+				min_latitude, max_latitude))
+				continue;
+
+			const fs::path file = fs::path{dirname} / entry.filename;
+			if(Import(file.string(),
+				min_longitude, max_longitude,
+				min_latitude, max_latitude,
+				progress, false))
+			{
+				return true;
+			}
+		}
+
+		// no single file contains the area, so assemble
+		// it from all the files intersecting it
+		std::vector<std::string> files;
+		for(const auto& entry : index.GetEntries())
+		{
+			if(IsIntersecting(entry.bounds,
+				min_longitude, max_longitude,
+				min_latitude, max_latitude))
+				files.push_back((fs::path{dirname} / entry.filename).string());
+		}
+
+		if(files.size() == 0)
+			return false;
+
+		if(files.size() == 1)
+		{
+			return Import(files[0],
+				min_longitude, max_longitude,
+				min_latitude, max_latitude,
+				progress, false);
+		}
+
+		return ImportFiles(files,
+			min_longitude, max_longitude,
+			min_latitude, max_latitude,
+			progress);
+	}
+
+
+
+	/**
+	 * @see https://wiki.openstreetmap.org/wiki/Key:surface
+	 */
+	std::tuple<bool, int, int, int>
+	GetSurfaceColour(const std::string& key, const std::string& val) const
+	{
+		const auto def_colour = std::make_tuple(false, 0, 0, 0);
+
+		if(key == "building" /*&& val == "yes"*/)
+			return std::make_tuple(true, 0xdd, 0xdd, 0xdd);
+
+		auto surf_iter = m_seg_colours.find(key);
+		if(surf_iter == m_seg_colours.end())
+			return def_colour;
+
+		const auto& surface = surf_iter->second;
+		if(auto iter = surface.find(val); iter != surface.end())
+			return std::tuple_cat(std::make_tuple(true), iter->second);
+
+		return def_colour;
+	}
+
+
+
+	/**
+	 * get the colour of an interned tag
+	 */
+	std::tuple<bool, int, int, int>
+	GetSurfaceColour(const t_tag& tag) const
+	{
+		if(tag.first == m_id_building)
+			return std::make_tuple(true, 0xdd, 0xdd, 0xdd);
+
+		auto iter = m_seg_colour_ids.find(GetTagId(tag.first, tag.second));
+		if(iter == m_seg_colour_ids.end())
+			return std::make_tuple(false, 0, 0, 0);
+
+		return std::tuple_cat(std::make_tuple(true), iter->second);
+	}
+
+
+
+	std::tuple<bool, std::string>
+	GetSurfaceColourString(const std::string& key, const std::string& val,
+		const std::string& def_col) const
+	{
+		auto [ ok, r, g, b ] = GetSurfaceColour(key, val);
+		if(!ok)
+			return std::make_tuple(ok, def_col);
+
+		return std::make_tuple(ok, GetColourString(r, g, b));
+	}
+
+
+
+	std::tuple<bool, std::string>
+	GetSurfaceColourString(const t_tag& tag, const std::string& def_col) const
+	{
+		auto [ ok, r, g, b ] = GetSurfaceColour(tag);
+		if(!ok)
+			return std::make_tuple(ok, def_col);
+
+		return std::make_tuple(ok, GetColourString(r, g, b));
+	}
+
+
+
+	static std::string GetColourString(int r, int g, int b)
+	{
+		std::ostringstream col_ostr;
+		col_ostr << "#"
+			<< std::setw(2) << std::setfill('0') << std::hex << r
+			<< std::setw(2) << std::setfill('0') << std::hex << g
+			<< std::setw(2) << std::setfill('0') << std::hex << b;
+
+		return col_ostr.str();
+	}
+
+
+
+	std::tuple<bool, t_real>
+	GetRoadWidth(const std::string& key, const std::string& val,
+		t_real def_line_width) const
+	{
+		auto widths_iter = m_road_widths.find(key);
+		if(widths_iter == m_road_widths.end())
+			return std::make_tuple(false, def_line_width);
+
+		const auto& widths = widths_iter->second;
+		if(auto iter = widths.find(val); iter != widths.end())
+			return std::make_tuple(true, iter->second);
+
+		return std::make_tuple(false, def_line_width);
+	}
+
+
+
+	/**
+	 * get the road width of an interned tag
+	 */
+	std::tuple<bool, t_real>
+	GetRoadWidth(const t_tag& tag, t_real def_line_width) const
+	{
+		auto iter = m_road_width_ids.find(GetTagId(tag.first, tag.second));
+		if(iter == m_road_width_ids.end())
+			return std::make_tuple(false, def_line_width);
+
+		return std::make_tuple(true, iter->second);
+	}
+
+
+
+	/**
+	 * get an interned tag key or value
+	 */
+	const std::string& GetString(t_strid id) const
+	{
+		return m_strings.Get(id);
+	}
+
+
+
+	/**
+	 * get the value of the tag with the given key
+	 */
+	const std::string* GetTagValue(const t_tags& tags, std::string_view key) const
+	{
+		std::optional<t_strid> key_id = m_strings.Find(key);
+		if(!key_id)
+			return nullptr;
+
+		std::optional<t_strid> val_id = tags.Find(*key_id);
+		if(!val_id)
+			return nullptr;
+
+		return &m_strings.Get(*val_id);
+	}
+
+
+
+	/**
+	 * get the vertex or segment ids referenced by a segment or multi-segment
+	 */
+	std::span<const t_size> GetIds(const t_idrange& range) const
+	{
+		return std::span<const t_size>{ m_ids.data() + range.begin, range.count };
+	}
+
+
+
+	/**
+	 * write an svg file
+	 */
+	bool ExportSvg(const std::string& filename, t_real scale = 1) const
+	{
+		std::ofstream ofstr(filename);
+		if(!ofstr)
+			return false;
+
+		return ExportSvg(ofstr, scale);
+	}
+
+
+
+	/**
+	 * write an svg stream
+	 */
+	bool ExportSvg(std::ostream& ostr, t_real scale = 1,
+		std::optional<t_real> min_lon = std::nullopt, std::optional<t_real> max_lon = std::nullopt,
+		std::optional<t_real> min_lat = std::nullopt, std::optional<t_real> max_lat = std::nullopt) const
+	{
+		std::string svg;
+		if(!ExportSvgToBuffer(svg, scale, min_lon, max_lon, min_lat, max_lat))
+			return false;
+
+		ostr.write(svg.data(), static_cast<std::streamsize>(svg.size()));
+		return static_cast<bool>(ostr);
+	}
+
+
+
+	/**
+	 * write an svg image into a buffer, which can be reused for further images
+	 */
+	bool ExportSvgToBuffer(std::string& svg, t_real scale = 1,
+		std::optional<t_real> min_lon = std::nullopt, std::optional<t_real> max_lon = std::nullopt,
+		std::optional<t_real> min_lat = std::nullopt, std::optional<t_real> max_lat = std::nullopt) const
+	{
+		TRACKS_PROFILE_SCOPE("Map::ExportSvg");
+
+		using t_style = typename SvgWriter<t_real>::t_style;
+
+		// actual bounds from data
+		t_real max_longitude = m_max_longitude;
+		t_real min_longitude = m_min_longitude;
+		t_real max_latitude = m_max_latitude;
+		t_real min_latitude = m_min_latitude;
+
+		// bounds for plot (which may be lower than the data bounds)
+		if(min_lon)
+			min_longitude = *min_lon;
+		if(min_lat)
+			min_latitude = *min_lat;
+		if(max_lon)
+			max_longitude = *max_lon;
+		if(max_lat)
+			max_latitude = *max_lat;
+
+		const t_real w = std::trunc(t_real(5000) * scale);
+		const t_real h = std::trunc(t_real(5000) * scale);
+
+		SvgWriter<t_real> writer{svg};
+		writer.Begin(w, h, min_longitude, max_longitude, min_latitude, max_latitude);
+
+		// only draw the objects intersecting the plot bounds if they do not contain the whole map
+		std::optional<std::array<std::vector<t_size>, std::size_t(IndexLayer::NUM_LAYERS)>> visible;
+		if(min_longitude > m_min_longitude || max_longitude < m_max_longitude ||
+			min_latitude > m_min_latitude || max_latitude < m_max_latitude)
+		{
+			visible = QueryIndex(min_longitude, max_longitude, min_latitude, max_latitude);
+		}
+
+		// get the ids of the visible objects of a layer, or null for all objects
+		auto visible_ids = [&visible](IndexLayer layer) -> const std::vector<t_size>*
+		{
+			return visible ? &(*visible)[std::size_t(layer)] : nullptr;
+		};
+
+		// css classes by colour and line width
+		std::unordered_map<std::uint32_t, t_style> area_styles;
+		std::map<std::pair<std::uint32_t, t_real>, t_style> street_styles;
+
+		auto get_colour = [](int r, int g, int b) -> std::uint32_t
+		{
+			return (std::uint32_t(r) << 16) | (std::uint32_t(g) << 8) | std::uint32_t(b);
+		};
+
+		auto get_colour_string = [](std::uint32_t col) -> std::string
+		{
+			return GetColourString((col >> 16) & 0xff, (col >> 8) & 0xff, col & 0xff);
+		};
+
+		auto get_area_style = [&writer, &area_styles, &get_colour_string](std::uint32_t fill_col) -> t_style
+		{
+			if(auto iter = area_styles.find(fill_col); iter != area_styles.end())
+				return iter->second;
+
+			const t_style style = writer.AddStyle(
+				"stroke:#000000;stroke-width:2px;fill:" + get_colour_string(fill_col));
+			area_styles.emplace(fill_col, style);
+			return style;
+		};
+
+		auto get_street_style = [&writer, &street_styles, &get_colour_string](
+			std::uint32_t line_col, t_real line_width) -> t_style
+		{
+			const auto key = std::make_pair(line_col, line_width);
+			if(auto iter = street_styles.find(key); iter != street_styles.end())
+				return iter->second;
+
+			std::ostringstream ostr;
+			ostr << "stroke:" << get_colour_string(line_col)
+				<< ";stroke-width:" << line_width << "px;fill:none";
+
+			const t_style style = writer.AddStyle(ostr.str());
+			street_styles.emplace(key, style);
+			return style;
+		};
+
+		// draw area
+		// segment ids are dense, so the drawn segments can be flagged by index
+		std::vector<bool> seg_already_drawn(m_segments.GetIdRange(), false);
+		auto draw_seg = [this, &seg_already_drawn, &writer, &get_colour, &get_area_style]
+			(t_size id, const t_segment *seg = nullptr,
+			const t_tags* more_tags = nullptr)
+		{
+			if(id >= seg_already_drawn.size())
+				seg_already_drawn.resize(id + 1, false);
+			else if(seg_already_drawn[id])
+				return;
+			seg_already_drawn[id] = true;
 
-			void SetReader(const osmium::io::Reader *reader)
+			if(!seg)
 			{
-				this->reader = reader;
+				seg = m_segments.Find(id);
+				if(!seg)
+					return;
 			}
 
+			if(!seg->is_area || IsSkippedObject(seg->tags)
+				|| (more_tags && IsSkippedObject(*more_tags)))
+				return;
 
-			void SetProgressFunction(std::function<bool(t_size, t_size)> *progress)
+			std::optional<std::uint32_t> fill_col;
+			auto find_colour = [this, &fill_col, &get_colour](const t_tags& tags)
 			{
-				this->progress = progress;
-			}
+				for(const t_tag& tag : tags)
+				{
+					if(auto [ found, r, g, b ] = GetSurfaceColour(tag); found)
+					{
+						fill_col = get_colour(r, g, b);
+						break;
+					}
+				}
+			};
 
+			// search additional tag map for colour
+			if(more_tags)
+				find_colour(*more_tags);
 
-			void node(const osmium::Node& node)
+			// search tag map for colour
+			if(!fill_col)
+				find_colour(seg->tags);
+
+			if(!fill_col)
+				return;
+
+			writer.BeginPath(get_area_style(*fill_col));
+			for(const t_size vert_id : GetIds(seg->vertex_ids))
 			{
-				if(!node.visible())
-					return;
+				if(const t_vertex *vertex = m_vertices.Find(vert_id); vertex)
+					writer.AddPoint(vertex->longitude, vertex->latitude);
+			}
+			writer.EndPath();
+		};
 
-				t_real lon = node.location().lon() / t_real(180) * num::pi_v<t_real>;
-				t_real lat = node.location().lat() / t_real(180) * num::pi_v<t_real>;
+		// draw background areas
+		ForEachObject(m_segments_background, visible_ids(IndexLayer::SEGMENT_BACKGROUND),
+			[&draw_seg](t_size id, const t_segment& seg)
+		{
+			draw_seg(id, &seg);
+		});
 
-				// is the vertex within requested bounds?
-				if(lon < *min_lon || lon > *max_lon ||
-					lat < *min_lat || lat > *max_lat)
-					return;
+		// draw multi-areas
+		ForEachObject(m_multisegments, visible_ids(IndexLayer::MULTISEGMENT),
+			[this, &draw_seg](t_size, const t_multisegment& multiseg)
+		{
+			for(const t_size id : GetIds(multiseg.segment_ids))
+				draw_seg(id, nullptr, &multiseg.tags);
+			for(const t_size id : GetIds(multiseg.segment_inner_ids))
+				draw_seg(id, nullptr, &multiseg.tags);
+		});
 
-				t_vertex vertex
-				{
-					.longitude = lon,
-					.latitude = lat,
-				};
+		// draw areas
+		ForEachObject(m_segments, visible_ids(IndexLayer::SEGMENT),
+			[&draw_seg](t_size id, const t_segment& seg)
+		{
+			draw_seg(id, &seg);
+		});
 
-				// vertex ranges
-				super->m_min_latitude = std::min(super->m_min_latitude, vertex.latitude);
-				super->m_max_latitude = std::max(super->m_max_latitude, vertex.latitude);
-				super->m_min_longitude = std::min(super->m_min_longitude, vertex.longitude);
-				super->m_max_longitude = std::max(super->m_max_longitude, vertex.longitude);
+		// draw foreground areas
+		ForEachObject(m_segments_foreground, visible_ids(IndexLayer::SEGMENT_FOREGROUND),
+			[&draw_seg](t_size id, const t_segment& seg)
+		{
+			draw_seg(id, &seg);
+		});
 
-				bool has_place = false;
-				bool has_name = false;
-				for(const auto& tag : node.tags())
-				{
-					bool found_tag = false;
-					std::string_view key{tag.key()};
+		// draw streets
+		ForEachObject(m_segments, visible_ids(IndexLayer::SEGMENT),
+			[this, &writer, &get_colour, &get_street_style](t_size, const t_segment& seg)
+		{
+			if(seg.is_area || IsSkippedObject(seg.tags))
+				return;
 
-					if(!has_place && key == "place")
-					{
-						has_place = true;
-						found_tag = true;
-					}
-					if(!has_name && key == "name")
-					{
-						has_name = true;
-						found_tag = true;
-					}
+			std::uint32_t line_col = 0x222222;
+			t_real line_width = 8.;
+			bool found_width = false, found_col = false;
 
-					if(!super->m_skip_unnecessary_tags ||
-						(!super->m_skip_labels && found_tag))
-					{
-						vertex.tags.emplace(std::make_pair(tag.key(), tag.value()));
-					}
-				}
+			for(const t_tag& tag : seg.tags)
+			{
+				if(!found_width)
+					std::tie(found_width, line_width) =
+						GetRoadWidth(tag, 8.);
 
-				if(has_place && has_name)
+				if(!found_col)
 				{
-					if(!super->m_skip_labels)
+					if(auto [ found, r, g, b ] = GetSurfaceColour(tag); found)
 					{
-						// place label
-						super->m_label_vertices.emplace(
-							std::make_pair(
-								super->RegisterLocalId(MapObjType::VERTEX, node.id()),
-								std::move(vertex)));
+						line_col = get_colour(r, g, b);
+						found_col = true;
 					}
 				}
-				else
+
+				if(found_width && found_col)
+					break;
+			}
+
+			writer.BeginPolyline(get_street_style(line_col, line_width));
+			for(const t_size vert_id : GetIds(seg.vertex_ids))
+			{
+				if(const t_vertex *vertex = m_vertices.Find(vert_id); vertex)
+					writer.AddPoint(vertex->longitude, vertex->latitude);
+			}
+			writer.EndPolyline();
+		});
+
+		// draw track
+		if(m_track.size())
+		{
+			for(std::string_view style : {
+				"stroke:#000000;stroke-width:48px;fill:none",
+				"stroke:#ffff00;stroke-width:24px;fill:none" })
+			{
+				writer.BeginPolyline(writer.AddStyle(style));
+				for(const t_vertex& vertex : m_track)
+					writer.AddPoint(vertex.longitude, vertex.latitude);
+				writer.EndPolyline();
+			}
+
+			// draw start and end points
+			const t_vertex& first = *m_track.begin();
+			const t_vertex& last = *m_track.rbegin();
+			writer.Circle(first.longitude, first.latitude, 42.,
+				writer.AddStyle("stroke-width:16px;stroke:#000000;fill:#ff0000"));
+			writer.Circle(last.longitude, last.latitude, 42.,
+				writer.AddStyle("stroke-width:16px;stroke:#000000;fill:#00ff00"));
+		}
+
+		// draw place labels
+		if(!m_skip_labels)
+		{
+			const t_style label_style = writer.AddStyle(
+				"font-family:sans-serif;font-size:180pt;"
+				"font-style:normal;font-weight:bold;"
+				"stroke-width:12px;stroke:#000000;fill:#cccc44");
+
+			for(const auto& [ id, vertex ] : m_label_vertices)
+			{
+				std::optional<t_strid> place_id = vertex.tags.Find(m_id_place);
+				std::optional<t_strid> name_id = vertex.tags.Find(m_id_name);
+
+				if(!place_id || !name_id)
+					continue;
+
+				writer.Text(vertex.longitude, vertex.latitude,
+					m_strings.Get(*name_id), label_style);
+			}
+		}
+
+		writer.End();
+		return true;
+	}
+
+
+
+	void SetSkipBuildings(bool b)
+	{
+		m_skip_buildings = b;
+	}
+
+
+
+	void SetSkipLabels(bool b)
+	{
+		m_skip_labels = b;
+	}
+
+
+
+	/**
+	 * read the osm file twice, first collecting the nodes referenced by
+	 * ways and relations, so that other nodes are not stored in between,
+	 * this only saves memory when (most of) the file's extent is imported,
+	 * as the ids are collected for the whole file
+	 */
+	void SetTwoPassImport(bool b)
+	{
+		m_two_pass_import = b;
+	}
+
+
+
+	/**
+	 * keep the translation of node ids in a memory-mapped scratch file
+	 * instead of on the heap, an empty name disables it,
+	 * needs to be set before importing
+	 *
+	 * Only the id table is moved to the file, the vertex coordinates stay
+	 * in memory as they are part of the map. The two-pass import limits
+	 * them to the vertices referenced by the ways and relations.
+	 */
+	void SetNodeIndexFile(const std::string& filename)
+	{
+		m_node_index_file = filename;
+		m_local_vert_ids.SetFile(filename);
+	}
+
+
+
+	/**
+	 * number of threads converting the objects of an osm file
+	 */
+	void SetNumThreads(unsigned int num)
+	{
+		m_num_threads = std::max(num, 1u);
+	}
+
+
+
+	unsigned int GetNumThreads() const
+	{
+		return m_num_threads;
+	}
+
+
+
+	/**
+	 * default number of threads, one per hardware thread
+	 */
+	static unsigned int GetDefaultNumThreads()
+	{
+		return std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+	}
+
+
+
+	/**
+	 * remove the objects outside the given bounds in radians, segments
+	 * are kept if the bounds of their vertices intersect them
+	 */
+	void Crop(t_real min_longitude, t_real max_longitude,
+		t_real min_latitude, t_real max_latitude)
+	{
+		TRACKS_PROFILE_SCOPE("Map::Crop");
+		InvalidateIndex();
+
+		auto is_inside = [=](const t_vertex& vertex) -> bool
+		{
+			return vertex.longitude >= min_longitude && vertex.longitude <= max_longitude
+				&& vertex.latitude >= min_latitude && vertex.latitude <= max_latitude;
+		};
+
+		// do the bounds of the vertices intersect the crop bounds?
+		auto intersects = [=, this](const t_idrange& vertex_ids) -> bool
+		{
+			t_real seg_min_lon = std::numeric_limits<t_real>::max(), seg_max_lon = -seg_min_lon;
+			t_real seg_min_lat = std::numeric_limits<t_real>::max(), seg_max_lat = -seg_min_lat;
+
+			for(const t_size id : GetIds(vertex_ids))
+			{
+				const t_vertex *vertex = m_vertices.Find(id);
+				if(!vertex)
+					continue;
+
+				seg_min_lon = std::min(seg_min_lon, vertex->longitude);
+				seg_max_lon = std::max(seg_max_lon, vertex->longitude);
+				seg_min_lat = std::min(seg_min_lat, vertex->latitude);
+				seg_max_lat = std::max(seg_max_lat, vertex->latitude);
+			}
+
+			return seg_min_lon <= max_longitude && seg_max_lon >= min_longitude
+				&& seg_min_lat <= max_latitude && seg_max_lat >= min_latitude;
+		};
+
+		m_segments.EraseIf([&intersects](const t_segment& seg) -> bool
+		{
+			return !intersects(seg.vertex_ids);
+		});
+
+		for(auto *segs : { &m_segments_background, &m_segments_foreground })
+		{
+			std::erase_if(*segs, [&intersects](const auto& entry) -> bool
+			{
+				return !intersects(entry.second.vertex_ids);
+			});
+		}
+
+		// keep the multi-segments with remaining segments
+		auto has_segment = [this](t_size id) -> bool
+		{
+			return m_segments.Find(id)
+				|| m_segments_background.contains(id)
+				|| m_segments_foreground.contains(id);
+		};
+
+		m_multisegments.EraseIf([this, &intersects, &has_segment](const t_multisegment& multiseg) -> bool
+		{
+			if(intersects(multiseg.vertex_ids))
+				return false;
+
+			for(const t_idrange *seg_ids : { &multiseg.segment_ids, &multiseg.segment_inner_ids })
+			{
+				for(const t_size id : GetIds(*seg_ids))
 				{
-					// vertex
-					super->m_vertices.emplace(
-						std::make_pair(
-							super->RegisterLocalId(MapObjType::VERTEX, node.id()),
-							std::move(vertex)));
+					if(has_segment(id))
+						return false;
 				}
+			}
+
+			return true;
+		});
+
+		std::erase_if(m_label_vertices, [&is_inside](const auto& entry) -> bool
+		{
+			return !is_inside(entry.second);
+		});
+
+		// only keep the vertices of the remaining objects
+		for(auto&& [ id, vertex ] : m_vertices)
+			vertex.referenced = false;
+
+		auto mark_vertices = [this](const t_idrange& vertex_ids)
+		{
+			for(const t_size id : GetIds(vertex_ids))
+			{
+				if(t_vertex *vertex = m_vertices.Find(id); vertex)
+					vertex->referenced = true;
+			}
+		};
+
+		for(auto&& [ id, seg ] : m_segments)
+			mark_vertices(seg.vertex_ids);
+		for(auto *segs : { &m_segments_background, &m_segments_foreground })
+		{
+			for(const auto& [ id, seg ] : *segs)
+				mark_vertices(seg.vertex_ids);
+		}
+		for(auto&& [ id, multiseg ] : m_multisegments)
+			mark_vertices(multiseg.vertex_ids);
+
+		m_vertices.EraseIf([](const t_vertex& vertex) -> bool
+		{
+			return !vertex.referenced;
+		});
+
+		CompactIds();
+
+		m_min_longitude = std::max(m_min_longitude, min_longitude);
+		m_max_longitude = std::min(m_max_longitude, max_longitude);
+		m_min_latitude = std::max(m_min_latitude, min_latitude);
+		m_max_latitude = std::min(m_max_latitude, max_latitude);
+	}
+
+
+
+	/**
+	 * get the bounds (min_lon, max_lon, min_lat, max_lat) of the map data in radians
+	 */
+	std::tuple<t_real, t_real, t_real, t_real> GetBounds() const
+	{
+		return std::make_tuple(m_min_longitude, m_max_longitude, m_min_latitude, m_max_latitude);
+	}
+
+
+
+	/**
+	 * set a track to be displayed together with the map
+	 */
+	void SetTrack(std::vector<t_vertex>&& track)
+	{
+		m_track = std::forward<std::vector<t_vertex>&&>(track);
+	}
+
+
+
+	bool Save(std::ofstream& ofstr) const
+	{
+		return Save(ofstr, nullptr);
+	}
+
+
+
+	/**
+	 * save the map, or only the objects of one of its tiles
+	 */
+	bool Save(std::ostream& ofstr, const t_tile *tile) const
+	{
+		if(!ofstr)
+			return false;
+
+		auto save_string = [&ofstr](const std::string& str)
+		{
+			const t_size len = str.size();
+			ofstr.write(reinterpret_cast<const char*>(&len), sizeof(len));
+			ofstr.write(reinterpret_cast<const char*>(str.data()), str.size() * sizeof(char));
+		};
+
+		auto save_tags = [this, &ofstr, &save_string](
+			const t_tags& tags)
+		{
+			t_size num_tags = tags.size();
+			ofstr.write(reinterpret_cast<const char*>(&num_tags), sizeof(num_tags));
 
-				update_progress();
+			for(const auto& [key, val] : tags)
+			{
+				save_string(m_strings.Get(key));
+				save_string(m_strings.Get(val));
 			}
+		};
 
+		auto save_vertices = [&ofstr, &save_tags](const auto& vertices, const std::vector<t_size> *ids)
+		{
+			t_size num_vertices = ids ? ids->size() : vertices.size();
+			ofstr.write(reinterpret_cast<const char*>(&num_vertices), sizeof(num_vertices));
 
-			void way(const osmium::Way& way)
+			ForEachObject(vertices, ids, [&ofstr, &save_tags](t_size idx, const t_vertex& vertex)
 			{
-				if(!way.visible())
-					return;
+				ofstr.write(reinterpret_cast<const char*>(&idx), sizeof(idx));
+				ofstr.write(reinterpret_cast<const char*>(&vertex.latitude), sizeof(vertex.latitude));
+				ofstr.write(reinterpret_cast<const char*>(&vertex.longitude), sizeof(vertex.longitude));
 
-				t_segment seg{};
-				//seg.vertex_ids.reserve(way.nodes().size());
+				save_tags(vertex.tags);
+			});
+		};
 
-				// get segment tags
-				bool is_background = false;
-				bool is_foreground = false;
-				bool is_road = false;
-				for(const auto& tag : way.tags())
-				{
-					std::string_view key{tag.key()};
-					std::string_view val{tag.value()};
+		// write an id range as one block
+		auto save_ids = [this, &ofstr](const t_idrange& range)
+		{
+			ofstr.write(reinterpret_cast<const char*>(&range.count), sizeof(range.count));
 
-					if(!is_background && (key == "landuse" || key == "natural"))
-						is_background = true;
-					if(!is_foreground && (key == "natural" && val == "water"))
-						is_foreground = true;
-					if(!is_road && super->m_road_widths.find(key) != super->m_road_widths.end())
-						is_road = true;
-					if(super->m_skip_buildings && (key == "building"
-						|| (key == "leisure" && val == "swimming_pool")))
-						return;
+			std::span<const t_size> ids = GetIds(range);
+			ofstr.write(reinterpret_cast<const char*>(ids.data()), ids.size_bytes());
+		};
 
-					if(!super->m_skip_unnecessary_tags
-						|| super->HasSurfaceColour(key, val)
-						|| super->HasRoadWidth(key, val))
-					{
-						seg.tags.emplace(std::make_pair(key, val));
-					}
-				}
+		auto save_segments = [&ofstr, &save_tags, &save_ids](const auto& segs, const std::vector<t_size> *ids)
+		{
+			t_size num_segs = ids ? ids->size() : segs.size();
+			ofstr.write(reinterpret_cast<const char*>(&num_segs), sizeof(num_segs));
 
-				//if(!seg.tags.size())
-				//	return;
+			ForEachObject(segs, ids, [&ofstr, &save_tags, &save_ids](t_size idx, const t_segment& seg)
+			{
+				ofstr.write(reinterpret_cast<const char*>(&idx), sizeof(idx));
 
-				// get segment vertices
-				t_size node_idx = 0;
-				for(const auto& node : way.nodes())
-				{
-					std::optional<t_size> ref = super->GetLocalId(MapObjType::VERTEX, node.ref());
-					if(ref)
-					{
-						auto vert_iter = super->m_vertices.find(*ref);
-						if(vert_iter != super->m_vertices.end())
-						{
-							seg.vertex_ids.push_back(*ref);
-							vert_iter->second.referenced = true;
-						}
-					}
+				std::uint8_t flags = seg.is_area ? 1 : 0;
+				ofstr.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
 
-					// first and last vertices are the same?
-					if(node_idx == way.nodes().size() - 1 &&
-						node.ref() == way.nodes().begin()->ref())
-					{
-						seg.is_area = true;
-					}
+				save_ids(seg.vertex_ids);
+				save_tags(seg.tags);
+			});
+		};
 
-					++node_idx;
-				}
+		auto save_multisegments = [&ofstr, &save_tags, &save_ids](const auto& segs, const std::vector<t_size> *ids)
+		{
+			t_size num_segs = ids ? ids->size() : segs.size();
+			ofstr.write(reinterpret_cast<const char*>(&num_segs), sizeof(num_segs));
 
-				// only referring to invalid vertices?
-				if(!seg.vertex_ids.size())
-					return;
-				if(is_road)
-					seg.is_area = false;
+			ForEachObject(segs, ids, [&ofstr, &save_tags, &save_ids](t_size idx, const t_multisegment& seg)
+			{
+				ofstr.write(reinterpret_cast<const char*>(&idx), sizeof(idx));
 
-				t_size local_id = super->RegisterLocalId(MapObjType::SEGMENT, way.id());
-				if(is_foreground)
-				{
-					super->m_segments_foreground.emplace(
-						std::make_pair(
-							local_id,
-							std::move(seg)));
-				}
-				else if(is_background)
-				{
-					super->m_segments_background.emplace(
-						std::make_pair(
-							local_id,
-							std::move(seg)));
-				}
-				else
-				{
-					super->m_segments.emplace(
-						std::make_pair(
-							local_id,
-							std::move(seg)));
-				}
+				save_ids(seg.vertex_ids);
+				save_ids(seg.segment_inner_ids);
+				save_ids(seg.segment_ids);
+				save_tags(seg.tags);
+			});
+		};
 
-				update_progress();
-			}
+		const t_real& min_latitude = tile ? tile->min_latitude : m_min_latitude;
+		const t_real& max_latitude = tile ? tile->max_latitude : m_max_latitude;
+		const t_real& min_longitude = tile ? tile->min_longitude : m_min_longitude;
+		const t_real& max_longitude = tile ? tile->max_longitude : m_max_longitude;
 
+		ofstr.write(reinterpret_cast<const char*>(&min_latitude), sizeof(min_latitude));
+		ofstr.write(reinterpret_cast<const char*>(&max_latitude), sizeof(max_latitude));
+		ofstr.write(reinterpret_cast<const char*>(&min_longitude), sizeof(min_longitude));
+		ofstr.write(reinterpret_cast<const char*>(&max_longitude), sizeof(max_longitude));
 
-			void relation(const osmium::Relation& rel)
-			{
-				t_multisegment seg{};
+		std::uint8_t flags = 0;
+		if(m_skip_buildings)
+			flags |= (1 << 0);
+		if(m_skip_labels)
+			flags |= (1 << 1);
+		ofstr.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
 
-				// get tags
-				for(const auto& tag : rel.tags())
-				{
-					std::string_view key{tag.key()};
-					std::string_view val{tag.value()};
+		save_vertices(m_vertices, tile ? &tile->vertex_ids : nullptr);
+		save_vertices(m_label_vertices, tile ? &tile->label_vertex_ids : nullptr);
+		save_segments(m_segments, tile ? &tile->segment_ids : nullptr);
+		save_segments(m_segments_background, tile ? &tile->segment_background_ids : nullptr);
+		save_segments(m_segments_foreground, tile ? &tile->segment_foreground_ids : nullptr);
+		save_multisegments(m_multisegments, tile ? &tile->multisegment_ids : nullptr);
 
-					if(super->m_skip_buildings && (key == "building"
-						|| (key == "leisure" && val == "swimming_pool")))
-						return;
+		return true;
+	}
 
-					if(!super->m_skip_unnecessary_tags
-						|| super->HasSurfaceColour(key, val)
-						|| super->HasRoadWidth(key, val))
-					{
-						seg.tags.emplace(std::make_pair(key, val));
-					}
-				}
 
-				//if(!seg.tags.size())
-				//	return;
 
-				// get vertices
-				for(const auto& member : rel.members())
-				{
-					if(member.type() == osmium::item_type::node)
-					{
-						std::optional<t_size> ref = super->GetLocalId(MapObjType::VERTEX, member.ref());
-						if(!ref)
-							continue;
+	/**
+	 * load a map, with merge set the objects are added to the ones already
+	 * in the map, objects contained in several files, like in neighbouring
+	 * tiles, are only added once
+	 */
+	bool Load(std::ifstream& ifstr, bool merge = false)
+	{
+		if(!ifstr)
+			return false;
+		InvalidateIndex();
 
-						auto vert_iter = super->m_vertices.find(*ref);
-						if(vert_iter == super->m_vertices.end())
-							continue;
+		auto load_string = [&ifstr]() -> std::string
+		{
+			t_size len{};
+			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
 
-						seg.vertex_ids.push_back(*ref);
-						vert_iter->second.referenced = true;
-					}
-					else if(member.type() == osmium::item_type::way &&
-						std::string_view(member.role()) == "inner")
-					{
-						std::optional<t_size> ref = super->GetLocalId(MapObjType::SEGMENT, member.ref());
-						if(!ref)
-							continue;
+			std::string str;
+			str.resize(len);
+			ifstr.read(reinterpret_cast<char*>(str.data()), str.size() * sizeof(char));
 
-						auto seg_iter = super->m_segments.find(*ref);
-						if(seg_iter == super->m_segments.end())
-							continue;
+			return str;
+		};
 
-						seg.segment_inner_ids.push_back(*ref);
-						seg_iter->second.referenced = true;
-					}
-					else if(member.type() == osmium::item_type::way /*&&
-						std::string_view(member.role()) == "outer"*/)
-					{
-						std::optional<t_size> ref = super->GetLocalId(MapObjType::SEGMENT, member.ref());
-						if(!ref)
-							continue;
+		auto load_tags = [this, &ifstr, &load_string]() -> t_tags
+		{
+			t_size len{};
+			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
 
-						auto seg_iter = super->m_segments.find(*ref);
-						if(seg_iter == super->m_segments.end())
-							continue;
+			t_tags tags;
 
-						seg.segment_ids.push_back(*ref);
-						seg_iter->second.referenced = true;
-					}
-				}
+			for(t_size i = 0; i < len; ++i)
+			{
+				std::string key = load_string();
+				std::string val = load_string();
 
-				// only referring to invalid objects?
-				if(!seg.vertex_ids.size() && !seg.segment_inner_ids.size() &&
-					!seg.segment_ids.size())
-					return;
+				AddTag(tags, key, val);
+			}
 
-				super->m_multisegments.emplace(
-					std::make_pair(
-						super->RegisterLocalId(MapObjType::MULTISEGMENT, rel.id()),
-						std::move(seg)));
+			return tags;
+		};
 
-				update_progress();
-			}
+		auto load_vertices = [this, &ifstr, &load_tags, merge]<class t_cont>(t_cont& vertices)
+		{
+			t_size len{};
+			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
 
+			if(!merge)
+				vertices = t_cont{};
 
-			void update_progress()
+			for(t_size i = 0; i < len; ++i)
 			{
-				if(!reader || !progress)
-					return;
-
-				t_size offs = reader->offset();
-				t_size size = reader->file_size();
+				t_vertex vertex;
 
-				// offset already seen?
-				if(last_offs && *last_offs == offs)
-					return;
-				last_offs = offs;
+				t_size idx{};
+				ifstr.read(reinterpret_cast<char*>(&idx), sizeof(idx));
+				ifstr.read(reinterpret_cast<char*>(&vertex.latitude), sizeof(vertex.latitude));
+				ifstr.read(reinterpret_cast<char*>(&vertex.longitude), sizeof(vertex.longitude));
 
-				if(!(*progress)(offs, size))
-					throw std::runtime_error{"Stop requested."};
-				//std::cout << offs << " / " << size << std::endl;
-			}
+				vertex.tags = load_tags();
+				vertex.referenced = true;
 
+				if(merge)
+				{
+					// already loaded from another file?
+					if(GetLocalId(MapObjType::VERTEX, idx))
+						continue;
+					idx = static_cast<t_size>(RegisterLocalId(MapObjType::VERTEX, idx));
+				}
 
-			/*void area(const osmium::Area& area)
-			{
+				vertices.emplace(std::make_pair(idx, std::move(vertex)));
 			}
+		};
+
+		// read an id range as one block into the shared id buffer
+		auto load_ids = [this, &ifstr, merge](MapObjType ty) -> t_idrange
+		{
+			t_idrange range{ .begin = static_cast<t_size>(m_ids.size()) };
+			ifstr.read(reinterpret_cast<char*>(&range.count), sizeof(range.count));
 
+			m_ids.resize(m_ids.size() + range.count);
+			ifstr.read(reinterpret_cast<char*>(m_ids.data() + range.begin),
+				range.count * sizeof(t_size));
 
-			void osm_object(const osmium::OSMObject&)
+			if(merge)
 			{
-				update_progress();
-			}
+				// translate the ids of the file to the ones in the map
+				t_size num_ids = 0;
+				for(t_size idx = range.begin; idx < range.begin + range.count; ++idx)
+				{
+					if(std::optional<t_size> id = GetLocalId(ty, m_ids[idx]); id)
+						m_ids[range.begin + num_ids++] = *id;
+				}
 
+				range.count = num_ids;
+				m_ids.resize(range.begin + num_ids);
+			}
 
-			void tag_list(const osmium::TagList& tags)
-			{
-			}*/
-		} osm_handler{this,
-			&min_longitude, &max_longitude,
-			&min_latitude, &max_latitude};
+			return range;
+		};
 
-		try
+		auto load_segments = [this, &ifstr, &load_tags, &load_ids, merge]<class t_cont>(t_cont& segs)
 		{
-			osmium::io::Reader osm{mapname,
-				osmium::osm_entity_bits::node | osmium::osm_entity_bits::way
-				| osmium::osm_entity_bits::relation,
-				osmium::io::read_meta::yes};
-			bool contained = true;
+			t_size len{};
+			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
 
-			// if valid bounds are given, check if the map is contained within
-			if(check_bounds &&
-				min_longitude >= -num::pi_v<t_real> && max_longitude <= num::pi_v<t_real> &&
-				min_latitude >= -num::pi_v<t_real>/t_real(2) && max_latitude <= num::pi_v<t_real>/t_real(2))
+			if(!merge)
+				segs = t_cont{};
+
+			for(t_size i = 0; i < len; ++i)
 			{
-				contained = false;
+				t_segment seg;
 
-				osmium::io::Header header = osm.header();
-				for(const osmium::Box& box : header.boxes())
-				{
-					if(!box.valid())
-						continue;
+				t_size idx{};
+				ifstr.read(reinterpret_cast<char*>(&idx), sizeof(idx));
 
-					if(box.left() / t_real(180) * num::pi_v<t_real> > min_longitude)
-						continue;
-					if(box.bottom() / t_real(180) * num::pi_v<t_real> > min_latitude)
-						continue;
-					if(box.right() / t_real(180) * num::pi_v<t_real> < min_longitude)
-						continue;
-					if(box.top() / t_real(180) * num::pi_v<t_real> < min_latitude)
-						continue;
+				std::uint8_t flags;
+				ifstr.read(reinterpret_cast<char*>(&flags), sizeof(flags));
+				seg.is_area = (flags != 0);
 
-					if(box.left() / t_real(180) * num::pi_v<t_real> > max_longitude)
-						continue;
-					if(box.bottom() / t_real(180) * num::pi_v<t_real> > max_latitude)
-						continue;
-					if(box.right() / t_real(180) * num::pi_v<t_real> < max_longitude)
-						continue;
-					if(box.top() / t_real(180) * num::pi_v<t_real> < max_latitude)
-						continue;
+				seg.vertex_ids = load_ids(MapObjType::VERTEX);
+				seg.tags = load_tags();
+				seg.referenced = true;
 
-					contained = true;
-					break;
+				if(merge)
+				{
+					// already loaded from another file?
+					if(GetLocalId(MapObjType::SEGMENT, idx))
+					{
+						m_ids.resize(seg.vertex_ids.begin);
+						continue;
+					}
+					idx = static_cast<t_size>(RegisterLocalId(MapObjType::SEGMENT, idx));
 				}
-			}
 
-			if(!contained)
-				return false;
+				segs.emplace(std::make_pair(idx, std::move(seg)));
+			}
+		};
 
-			osm_handler.SetProgressFunction(progress);
-			osm_handler.SetReader(&osm);
-			osmium::apply(osm, osm_handler);
-		}
-		catch(const std::exception& ex)
+		auto load_multisegments = [this, &ifstr, &load_tags, &load_ids, merge]<class t_cont>(t_cont& segs)
 		{
-			std::cerr << ex.what() << std::endl;
-			return false;
-		}
-
-		PruneUnreferenced();
-		return true;
-	}
+			t_size len{};
+			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
 
-#else
+			if(!merge)
+				segs = t_cont{};
 
-	bool Import(const std::string& mapname,
-		t_real = -10., t_real = 10.,
-		t_real = -10., t_real = 10.,
-		std::function<bool(t_size, t_size)>* = nullptr,
-		bool = false)
-	{
-		std::cerr << "Cannot import \"" << mapname
-			<< "\" because osmium support is disabled."
-			<< std::endl;
-		return false;
-	}
+			for(t_size i = 0; i < len; ++i)
+			{
+				t_multisegment seg;
 
-#endif  // _TRACKS_USE_OSMIUM_
+				t_size idx{};
+				ifstr.read(reinterpret_cast<char*>(&idx), sizeof(idx));
 
+				seg.vertex_ids = load_ids(MapObjType::VERTEX);
+				seg.segment_inner_ids = load_ids(MapObjType::SEGMENT);
+				seg.segment_ids = load_ids(MapObjType::SEGMENT);
+				seg.tags = load_tags();
 
+				if(merge)
+				{
+					// already loaded from another file?
+					if(GetLocalId(MapObjType::MULTISEGMENT, idx))
+					{
+						m_ids.resize(seg.vertex_ids.begin);
+						continue;
+					}
+					idx = static_cast<t_size>(RegisterLocalId(MapObjType::MULTISEGMENT, idx));
+				}
 
-	/**
-	 * try to import from all map files in a given directory
-	 * until a map with matching bounds has been found
-	 */
-	bool ImportDir(const std::string& dirname,
-		t_real min_longitude = -10., t_real max_longitude = 10.,
-		t_real min_latitude = -10., t_real max_latitude = 10.,
-		std::function<bool(t_size, t_size)> *progress = nullptr)
-	{
-		namespace fs = __map_fs;
+				segs.emplace(std::make_pair(idx, std::move(seg)));
+			}
+		};
 
-		// if a file is given instead of a directory, load it directly
-		// without bounds checks ...
-		if(fs::is_regular_file(dirname))
-		{
-			return Import(dirname,
-				min_longitude, max_longitude,
-				min_latitude, max_latitude,
-				progress, false);
-		}
+		t_real min_latitude{}, max_latitude{};
+		t_real min_longitude{}, max_longitude{};
 
-		// ... otherwise iterate all files in the directory until
-		// the one with the correct bounds has been found
-		using t_iter = fs::directory_iterator;
-		t_iter dir{fs::path{dirname}};
+		ifstr.read(reinterpret_cast<char*>(&min_latitude), sizeof(min_latitude));
+		ifstr.read(reinterpret_cast<char*>(&max_latitude), sizeof(max_latitude));
+		ifstr.read(reinterpret_cast<char*>(&min_longitude), sizeof(min_longitude));
+		ifstr.read(reinterpret_cast<char*>(&max_longitude), sizeof(max_longitude));
 
-		for(t_iter iter = fs::begin(dir); iter != fs::end(dir); ++iter)
+		if(merge)
+		{
+			m_min_latitude = std::min(m_min_latitude, min_latitude);
+			m_max_latitude = std::max(m_max_latitude, max_latitude);
+			m_min_longitude = std::min(m_min_longitude, min_longitude);
+			m_max_longitude = std::max(m_max_longitude, max_longitude);
+		}
+		else
 		{
-			const fs::path& file = *iter;
+			m_min_latitude = min_latitude;
+			m_max_latitude = max_latitude;
+			m_min_longitude = min_longitude;
+			m_max_longitude = max_longitude;
+		}
 
-			if(!fs::is_regular_file(file))
-				continue;
-			if(std::string ext = file.extension().string();
-				boost::to_lower_copy(ext) != ".osm" && boost::to_lower_copy(ext) != ".pbf")
-				continue;
+		std::uint8_t flags = 0;
+		ifstr.read(reinterpret_cast<char*>(&flags), sizeof(flags));
+		m_skip_buildings = (flags & (1 << 0)) != 0;
+		m_skip_labels = (flags & (1 << 1)) != 0;
 
-			std::string filename = file.filename().string();
-			if(Import(filename,
-				min_longitude, max_longitude,
-				min_latitude, max_latitude,
-				progress, true))
-			{
-				return true;
-			}
-		}
+		if(!merge)
+			m_ids.clear();
+		load_vertices(m_vertices);
+		load_vertices(m_label_vertices);
+		load_segments(m_segments);
+		load_segments(m_segments_background);
+		load_segments(m_segments_foreground);
+		load_multisegments(m_multisegments);
 
-		return false;
+		return true;
 	}
 
 
 
 	/**
-	 * @see https://wiki.openstreetmap.org/wiki/Key:surface
+	 * save the map in the flat format, which consists of aligned arrays
+	 * that can be used directly from a memory-mapped file
 	 */
-	std::tuple<bool, int, int, int>
-	GetSurfaceColour(const std::string& key, const std::string& val) const
+	bool SaveFlat(std::ostream& ofstr) const
 	{
-		const auto def_colour = std::make_tuple(false, 0, 0, 0);
-
-		if(key == "building" /*&& val == "yes"*/)
-			return std::make_tuple(true, 0xdd, 0xdd, 0xdd);
+		TRACKS_PROFILE_SCOPE("Map::SaveFlat");
 
-		auto surf_iter = m_seg_colours.find(key);
-		if(surf_iter == m_seg_colours.end())
-			return def_colour;
+		if(!ofstr)
+			return false;
 
-		const auto& surface = surf_iter->second;
-		if(auto iter = surface.find(val); iter != surface.end())
-			return std::tuple_cat(std::make_tuple(true), iter->second);
+		// string table
+		std::vector<std::uint64_t> string_offsets;
+		std::string string_chars;
+		string_offsets.reserve(m_strings.size() + 1);
+		for(std::size_t idx = 0; idx < m_strings.size(); ++idx)
+		{
+			string_offsets.push_back(string_chars.size());
+			string_chars += m_strings.Get(static_cast<t_strid>(idx));
+		}
+		string_offsets.push_back(string_chars.size());
 
-		return def_colour;
-	}
+		std::vector<FlatTag> tags;
+		auto save_tags = [&tags](const t_tags& obj_tags) -> t_idrange
+		{
+			t_idrange range{ .begin = static_cast<t_size>(tags.size()),
+				.count = static_cast<t_size>(obj_tags.size()) };
+			for(const auto& [ key, val ] : obj_tags)
+				tags.emplace_back(FlatTag{ .key = key, .val = val });
+			return range;
+		};
 
+		// the records are value-initialised, which also clears their padding
+		auto save_vertices = [&save_tags](const auto& vertices) -> std::vector<FlatVertex>
+		{
+			std::vector<FlatVertex> recs(vertices.size());
+			std::size_t rec_idx = 0;
+			for(const auto& [ id, vertex ] : vertices)
+			{
+				FlatVertex& rec = recs[rec_idx++];
+				rec.longitude = vertex.longitude;
+				rec.latitude = vertex.latitude;
+				rec.id = id;
+				rec.tags = save_tags(vertex.tags);
+			}
+			return recs;
+		};
 
+		auto save_segments = [&save_tags](const auto& segs) -> std::vector<FlatSegment>
+		{
+			std::vector<FlatSegment> recs(segs.size());
+			std::size_t rec_idx = 0;
+			for(const auto& [ id, seg ] : segs)
+			{
+				FlatSegment& rec = recs[rec_idx++];
+				rec.id = id;
+				rec.vertex_ids = seg.vertex_ids;
+				rec.tags = save_tags(seg.tags);
+				rec.is_area = seg.is_area ? 1 : 0;
+			}
+			return recs;
+		};
 
-	std::tuple<bool, std::string>
-	GetSurfaceColourString(const std::string& key, const std::string& val,
-		const std::string& def_col) const
-	{
-		auto [ ok, r, g, b ] = GetSurfaceColour(key, val);
-		if(!ok)
-			return std::make_tuple(ok, def_col);
+		const std::vector<FlatVertex> vertices = save_vertices(m_vertices);
+		const std::vector<FlatVertex> label_vertices = save_vertices(m_label_vertices);
+		const std::vector<FlatSegment> segments = save_segments(m_segments);
+		const std::vector<FlatSegment> segments_background = save_segments(m_segments_background);
+		const std::vector<FlatSegment> segments_foreground = save_segments(m_segments_foreground);
 
-		std::ostringstream col_ostr;
-		col_ostr << "#"
-			<< std::setw(2) << std::setfill('0') << std::hex << r
-			<< std::setw(2) << std::setfill('0') << std::hex << g
-			<< std::setw(2) << std::setfill('0') << std::hex << b;
+		std::vector<FlatMultiSegment> multisegments(m_multisegments.size());
+		std::size_t multiseg_idx = 0;
+		for(const auto& [ id, seg ] : m_multisegments)
+		{
+			FlatMultiSegment& rec = multisegments[multiseg_idx++];
+			rec.id = id;
+			rec.vertex_ids = seg.vertex_ids;
+			rec.segment_inner_ids = seg.segment_inner_ids;
+			rec.segment_ids = seg.segment_ids;
+			rec.tags = save_tags(seg.tags);
+		}
 
-		return std::make_tuple(ok, col_ostr.str());
-	}
+		// value-initialised to clear the padding
+		FlatHeader header = FlatHeader();
+		std::memcpy(header.magic, MAP_MAGIC_FLAT, sizeof(MAP_MAGIC_FLAT));
+		header.real_size = sizeof(t_real);
+		header.size_size = sizeof(t_size);
+		header.strid_size = sizeof(t_strid);
+		header.flags = (m_skip_buildings ? (1 << 0) : 0) | (m_skip_labels ? (1 << 1) : 0);
+		header.min_latitude = m_min_latitude;
+		header.max_latitude = m_max_latitude;
+		header.min_longitude = m_min_longitude;
+		header.max_longitude = m_max_longitude;
+
+		// the id ranges refer to the shared id buffer, which is written as is
+		std::array<std::span<const std::byte>, std::size_t(FlatSection::NUM_SECTIONS)> sections{};
+		auto set_section = [&header, &sections](FlatSection sec, const auto& elems)
+		{
+			sections[std::size_t(sec)] = std::as_bytes(std::span{elems});
+			header.counts[std::size_t(sec)] = elems.size();
+		};
 
+		set_section(FlatSection::STRING_OFFSETS, string_offsets);
+		set_section(FlatSection::STRING_CHARS, string_chars);
+		set_section(FlatSection::TAGS, tags);
+		set_section(FlatSection::IDS, m_ids);
+		set_section(FlatSection::VERTICES, vertices);
+		set_section(FlatSection::LABEL_VERTICES, label_vertices);
+		set_section(FlatSection::SEGMENTS, segments);
+		set_section(FlatSection::SEGMENTS_BACKGROUND, segments_background);
+		set_section(FlatSection::SEGMENTS_FOREGROUND, segments_foreground);
+		set_section(FlatSection::MULTISEGMENTS, multisegments);
+
+		auto align = [](std::uint64_t offs) -> std::uint64_t
+		{
+			return (offs + MAP_FLAT_ALIGN - 1) / MAP_FLAT_ALIGN * MAP_FLAT_ALIGN;
+		};
 
+		std::uint64_t offs = align(sizeof(header));
+		for(std::size_t sec = 0; sec < sections.size(); ++sec)
+		{
+			header.offsets[sec] = offs;
+			offs = align(offs + sections[sec].size());
+		}
 
-	std::tuple<bool, t_real>
-	GetRoadWidth(const std::string& key, const std::string& val,
-		t_real def_line_width) const
-	{
-		auto widths_iter = m_road_widths.find(key);
-		if(widths_iter == m_road_widths.end())
-			return std::make_tuple(false, def_line_width);
+		// write the header and the padded sections
+		const char padding[MAP_FLAT_ALIGN]{};
+		offs = sizeof(header);
+		ofstr.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
-		const auto& widths = widths_iter->second;
-		if(auto iter = widths.find(val); iter != widths.end())
-			return std::make_tuple(true, iter->second);
+		for(std::size_t sec = 0; sec < sections.size(); ++sec)
+		{
+			ofstr.write(padding, static_cast<std::streamsize>(header.offsets[sec] - offs));
+			ofstr.write(reinterpret_cast<const char*>(sections[sec].data()), sections[sec].size());
+			offs = header.offsets[sec] + sections[sec].size();
+		}
 
-		return std::make_tuple(false, def_line_width);
+		return static_cast<bool>(ofstr);
 	}
 
 
 
 	/**
-	 * write an svg file
-	 * @see https://github.com/boostorg/geometry/tree/develop/example
+	 * load a map in the flat format from memory aligned to MAP_FLAT_ALIGN,
+	 * e.g. a memory-mapped file, with merge set the objects are added
+	 * to the ones already in the map
 	 */
-	bool ExportSvg(const std::string& filename, t_real scale = 1) const
+	bool LoadFlat(const char *data, std::size_t size, bool merge = false)
 	{
-		std::ofstream ofstr(filename);
-		if(!ofstr)
+		TRACKS_PROFILE_SCOPE("Map::LoadFlat");
+
+		FlatHeader header;
+		if(size < sizeof(header) || reinterpret_cast<std::uintptr_t>(data) % MAP_FLAT_ALIGN != 0)
 			return false;
+		std::memcpy(&header, data, sizeof(header));
 
-		return ExportSvg(ofstr, scale);
-	}
+		if(std::memcmp(header.magic, MAP_MAGIC_FLAT, sizeof(MAP_MAGIC_FLAT)) != 0 ||
+			header.real_size != sizeof(t_real) ||
+			header.size_size != sizeof(t_size) ||
+			header.strid_size != sizeof(t_strid))
+			return false;
 
+		auto string_offsets = GetFlatSection<std::uint64_t>(data, size, header, FlatSection::STRING_OFFSETS);
+		auto string_chars = GetFlatSection<char>(data, size, header, FlatSection::STRING_CHARS);
+		auto tags = GetFlatSection<FlatTag>(data, size, header, FlatSection::TAGS);
+		auto ids = GetFlatSection<t_size>(data, size, header, FlatSection::IDS);
+		auto vertices = GetFlatSection<FlatVertex>(data, size, header, FlatSection::VERTICES);
+		auto label_vertices = GetFlatSection<FlatVertex>(data, size, header, FlatSection::LABEL_VERTICES);
+		auto segments = GetFlatSection<FlatSegment>(data, size, header, FlatSection::SEGMENTS);
+		auto segments_background = GetFlatSection<FlatSegment>(data, size, header, FlatSection::SEGMENTS_BACKGROUND);
+		auto segments_foreground = GetFlatSection<FlatSegment>(data, size, header, FlatSection::SEGMENTS_FOREGROUND);
+		auto multisegments = GetFlatSection<FlatMultiSegment>(data, size, header, FlatSection::MULTISEGMENTS);
+
+		if(!string_offsets || !string_chars || !tags || !ids || !vertices || !label_vertices ||
+			!segments || !segments_background || !segments_foreground || !multisegments ||
+			string_offsets->size() == 0)
+			return false;
 
+		// validate all sections before changing the map, so that it stays untouched
+		// if the file is corrupt
+		const std::size_t num_strings = string_offsets->size() - 1;
+		for(std::size_t idx = 0; idx < num_strings; ++idx)
+		{
+			const std::uint64_t begin = (*string_offsets)[idx];
+			const std::uint64_t end = (*string_offsets)[idx + 1];
+			if(begin > end || end > string_chars->size())
+				return false;
+		}
 
-	/**
-	 * write an svg stream
-	 * @see https://github.com/boostorg/geometry/tree/develop/example
-	 */
-	bool ExportSvg(std::ostream& ostr, t_real scale = 1,
-		std::optional<t_real> min_lon = std::nullopt, std::optional<t_real> max_lon = std::nullopt,
-		std::optional<t_real> min_lat = std::nullopt, std::optional<t_real> max_lat = std::nullopt) const
-	{
-		namespace geo = boost::geometry;
-		namespace num = std::numbers;
+		for(const FlatTag& tag : *tags)
+		{
+			if(tag.key >= num_strings || tag.val >= num_strings)
+				return false;
+		}
 
-		using t_vert = geo::model::point<t_real, 2, geo::cs::cartesian>;
-		using t_line = geo::model::linestring<t_vert, std::vector>;
-		using t_poly = geo::model::polygon<t_vert, true /*cw*/, false /*closed*/, std::vector>;
-		using t_box = geo::model::box<t_vert>;
-		using t_svg = geo::svg_mapper<t_vert, false, t_real>;
+		auto is_valid_range = [](const t_idrange& range, std::size_t num) -> bool
+		{
+			return range.begin <= num && range.count <= num - range.begin;
+		};
 
-		// actual bounds from data
-		t_real max_longitude = m_max_longitude;
-		t_real min_longitude = m_min_longitude;
-		t_real max_latitude = m_max_latitude;
-		t_real min_latitude = m_min_latitude;
+		// the records of dense stores are sorted by id, so the last one gives the id range,
+		// ids out of order or at the limit of t_size come from a corrupt file
+		auto is_valid_order = []<class t_cont, class t_rec>(
+			const t_cont& /*objs*/, std::span<const t_rec> recs) -> bool
+		{
+			if constexpr(requires(t_cont& store) { store.Reserve(recs.back().id); })
+			{
+				for(std::size_t idx = 1; idx < recs.size(); ++idx)
+				{
+					if(recs[idx].id <= recs[idx - 1].id)
+						return false;
+				}
 
-		// bounds for plot (which may be lower than the data bounds)
-		if(min_lon)
-			min_longitude = *min_lon;
-		if(min_lat)
-			min_latitude = *min_lat;
-		if(max_lon)
-			max_longitude = *max_lon;
-		if(max_lat)
-			max_latitude = *max_lat;
+				if(recs.size() && recs.back().id == std::numeric_limits<t_size>::max())
+					return false;
+			}
 
-		//t_svg svg(ostr,
-		//	scale * (max_longitude - min_longitude) * t_real(180) / num::pi_v<t_real>,
-		//	scale * (max_latitude - min_latitude) * t_real(180) / num::pi_v<t_real>);
-		int w = static_cast<int>(5000 * scale);
-		int h = static_cast<int>(5000 * scale);
-		t_svg svg(ostr, w, h,
-			"width=\"" + std::to_string(w) + "px\" "
-			"height=\"" + std::to_string(h) + "px\"");
-
-		t_box frame(
-			t_vert{
-				min_longitude * t_real(180) / num::pi_v<t_real>,
-				min_latitude * t_real(180) / num::pi_v<t_real> },
-			t_vert{
-				max_longitude * t_real(180) / num::pi_v<t_real>,
-				max_latitude * t_real(180) / num::pi_v<t_real> });
-		svg.add(frame);
-		//svg.map(frame, "stroke:#ff0000; stroke-width:0.01px; fill:none;");
+			return true;
+		};
 
-		// draw area
-		std::unordered_set<t_size> seg_already_drawn;
-		auto draw_seg = [this, &seg_already_drawn, &svg]
-			(t_size id, const t_segment *seg = nullptr,
-			const t_tags* more_tags = nullptr)
+		auto is_valid_vertices = [&tags, &is_valid_range, &is_valid_order](
+			const auto& vertices, std::span<const FlatVertex> recs) -> bool
 		{
-			auto id_iter = seg_already_drawn.find(id);
-			if(id_iter != seg_already_drawn.end())
-				return;
-			seg_already_drawn.insert(id);
+			if(!is_valid_order(vertices, recs))
+				return false;
 
-			if(!seg)
+			return std::all_of(recs.begin(), recs.end(), [&tags, &is_valid_range](const FlatVertex& rec) -> bool
 			{
-				auto iter = m_segments.find(id);
-				if(iter == m_segments.end())
-					return;
-
-				seg = &iter->second;
-			}
-
-			if(!seg->is_area)
-				return;
+				return is_valid_range(rec.tags, tags->size());
+			});
+		};
 
-			t_poly poly;
+		auto is_valid_segments = [&tags, &ids, &is_valid_range, &is_valid_order](
+			const auto& segs, std::span<const FlatSegment> recs) -> bool
+		{
+			if(!is_valid_order(segs, recs))
+				return false;
 
-			for(const t_size vert_id : seg->vertex_ids)
+			return std::all_of(recs.begin(), recs.end(), [&tags, &ids, &is_valid_range](const FlatSegment& rec) -> bool
 			{
-				auto iter = m_vertices.find(vert_id);
-				if(iter == m_vertices.end())
-					continue;
+				return is_valid_range(rec.tags, tags->size()) &&
+					is_valid_range(rec.vertex_ids, ids->size());
+			});
+		};
 
-				t_vert vert{
-					iter->second.longitude * t_real(180) / num::pi_v<t_real>,
-					iter->second.latitude * t_real(180) / num::pi_v<t_real>};
-				poly.outer().push_back(vert);
-			}
+		if(!is_valid_vertices(m_vertices, *vertices) ||
+			!is_valid_vertices(m_label_vertices, *label_vertices) ||
+			!is_valid_segments(m_segments, *segments) ||
+			!is_valid_segments(m_segments_background, *segments_background) ||
+			!is_valid_segments(m_segments_foreground, *segments_foreground) ||
+			!is_valid_order(m_multisegments, *multisegments))
+			return false;
 
-			std::string line_col = "#000000";
-			std::string fill_col = "#ffffff";
-			t_real line_width = 2.;
-			bool found = false;
+		for(const FlatMultiSegment& rec : *multisegments)
+		{
+			if(!is_valid_range(rec.tags, tags->size()) ||
+				!is_valid_range(rec.vertex_ids, ids->size()) ||
+				!is_valid_range(rec.segment_inner_ids, ids->size()) ||
+				!is_valid_range(rec.segment_ids, ids->size()))
+				return false;
+		}
 
-			if(more_tags)
-			{
-				// search additional tag map for colour
-				for(const auto& [ tag_key, tag_val ] : *more_tags)
-				{
-					std::tie(found, fill_col) =
-						GetSurfaceColourString(tag_key, tag_val, "#ffffff");
-					if(found)
-						break;
-				}
-			}
+		// without merging, the objects replace the ones in the map,
+		// allocate their stores first, as this fails for huge ids
+		auto create_store = []<class t_cont, class t_rec>(
+			const t_cont& /*objs*/, std::span<const t_rec> recs, bool create) -> t_cont
+		{
+			t_cont new_objs{};
+			if(!create)
+				return new_objs;
 
-			if(!found)
+			if constexpr(requires { new_objs.Reserve(recs.back().id); })
 			{
-				// search tag map for colour
-				for(const auto& [ tag_key, tag_val ] : seg->tags)
-				{
-					std::tie(found, fill_col) =
-						GetSurfaceColourString(tag_key, tag_val, "#ffffff");
-					if(found)
-						break;
-				}
+				if(recs.size())
+					new_objs.Reserve(recs.back().id + 1);
 			}
-
-			if(found)
+			else
 			{
-				//svg.add(poly);
-				svg.map(poly, "stroke:" + line_col +
-					"; stroke-width:" + std::to_string(line_width) + "px" +
-					"; fill:" + fill_col + ";", 1.);
+				new_objs.reserve(recs.size());
 			}
+
+			return new_objs;
 		};
 
-		// draw background areas
-		for(const auto& [ id, seg ] : m_segments_background)
-			draw_seg(id, &seg);
+		auto new_vertices = create_store(m_vertices, *vertices, !merge);
+		auto new_label_vertices = create_store(m_label_vertices, *label_vertices, !merge);
+		auto new_segments = create_store(m_segments, *segments, !merge);
+		auto new_segments_background = create_store(m_segments_background, *segments_background, !merge);
+		auto new_segments_foreground = create_store(m_segments_foreground, *segments_foreground, !merge);
+		auto new_multisegments = create_store(m_multisegments, *multisegments, !merge);
 
-		// draw multi-areas
-		for(const auto& [ multiseg_id, multiseg ] : m_multisegments)
+		InvalidateIndex();
+
+		// intern the string table, giving the ids of the strings in the map
+		std::vector<t_strid> str_ids;
+		str_ids.reserve(num_strings);
+		for(std::size_t idx = 0; idx < num_strings; ++idx)
 		{
-			for(const t_size id : multiseg.segment_ids)
-				draw_seg(id, nullptr, &multiseg.tags);
-			for(const t_size id : multiseg.segment_inner_ids)
-				draw_seg(id, nullptr, &multiseg.tags);
+			const std::uint64_t begin = (*string_offsets)[idx];
+			const std::uint64_t end = (*string_offsets)[idx + 1];
+
+			str_ids.push_back(m_strings.Intern(std::string_view{
+				string_chars->data() + begin, static_cast<std::size_t>(end - begin) }));
 		}
 
-		// draw areas
-		for(const auto& [ id, seg ] : m_segments)
-			draw_seg(id, &seg);
+		auto load_tags = [&tags, &str_ids](const t_idrange& range) -> t_tags
+		{
+			t_tags obj_tags;
+			for(const FlatTag& tag : tags->subspan(range.begin, range.count))
+				obj_tags.Add(str_ids[tag.key], str_ids[tag.val]);
+			return obj_tags;
+		};
 
-		// draw foreground areas
-		for(const auto& [ id, seg ] : m_segments_foreground)
-			draw_seg(id, &seg);
+		// without merging, the ranges refer to the id buffer, which is taken over
+		// as a whole, otherwise the ids are translated to the ones in the map
+		auto load_ids = [this, &ids, merge](const t_idrange& range, MapObjType ty) -> t_idrange
+		{
+			if(!merge)
+				return range;
 
-		// draw streets
-		for(const auto& [ id, seg ] : m_segments)
+			std::vector<t_size> translated;
+			translated.reserve(range.count);
+			for(const t_size id : ids->subspan(range.begin, range.count))
+			{
+				if(std::optional<t_size> local_id = GetLocalId(ty, id); local_id)
+					translated.push_back(*local_id);
+			}
+
+			return AddIds(translated);
+		};
+
+		// get the id of an object, with merge set, objects which
+		// have already been loaded from another file are skipped
+		auto load_id = [this, merge](t_size id, MapObjType ty) -> std::optional<t_size>
 		{
-			if(seg.is_area)
-				continue;
-			t_line line;
+			if(!merge)
+				return id;
+			if(GetLocalId(ty, id))
+				return std::nullopt;
+			return static_cast<t_size>(RegisterLocalId(ty, id));
+		};
 
-			for(const t_size vert_id : seg.vertex_ids)
+		auto load_vertices = [&load_tags, &load_id]<class t_cont>(
+			t_cont& vertices, std::span<const FlatVertex> recs)
+		{
+			for(const FlatVertex& rec : recs)
 			{
-				auto iter = m_vertices.find(vert_id);
-				if(iter == m_vertices.end())
+				std::optional<t_size> id = load_id(rec.id, MapObjType::VERTEX);
+				if(!id)
 					continue;
 
-				t_vert vert{
-					iter->second.longitude * t_real(180) / num::pi_v<t_real>,
-					iter->second.latitude * t_real(180) / num::pi_v<t_real>};
-				line.push_back(vert);
-			}
+				t_vertex vertex
+				{
+					.longitude = rec.longitude,
+					.latitude = rec.latitude,
+					.tags = load_tags(rec.tags),
+					.referenced = true,
+				};
 
-			std::string line_col = "#222222";
-			std::string fill_col = "none";
-			t_real line_width = 8.;
-			bool found_width = false, found_col = false;
+				vertices.emplace(std::make_pair(*id, std::move(vertex)));
+			}
+		};
 
-			for(const auto& [ tag_key, tag_val ] : seg.tags)
+		auto load_segments = [&load_tags, &load_ids, &load_id]<class t_cont>(
+			t_cont& segs, std::span<const FlatSegment> recs)
+		{
+			for(const FlatSegment& rec : recs)
 			{
-				if(!found_width)
-					std::tie(found_width, line_width) =
-						GetRoadWidth(tag_key, tag_val, 8.);
+				std::optional<t_size> id = load_id(rec.id, MapObjType::SEGMENT);
+				if(!id)
+					continue;
 
-				if(!found_col)
-					std::tie(found_col, line_col) =
-						GetSurfaceColourString(tag_key, tag_val, "#222222");
+				t_segment seg
+				{
+					.vertex_ids = load_ids(rec.vertex_ids, MapObjType::VERTEX),
+					.is_area = rec.is_area != 0,
+					.tags = load_tags(rec.tags),
+					.referenced = true,
+				};
 
-				if(found_width && found_col)
-					break;
+				segs.emplace(std::make_pair(*id, std::move(seg)));
 			}
+		};
 
-			//svg.add(line);
-			svg.map(line, "stroke:" + line_col +
-				"; stroke-width:" + std::to_string(line_width) + "px"
-				"; fill:" + fill_col + ";", 1.);
+		if(merge)
+		{
+			m_min_latitude = std::min(m_min_latitude, header.min_latitude);
+			m_max_latitude = std::max(m_max_latitude, header.max_latitude);
+			m_min_longitude = std::min(m_min_longitude, header.min_longitude);
+			m_max_longitude = std::max(m_max_longitude, header.max_longitude);
 		}
-
-		// draw track
-		t_line line;
-		for(const t_vertex& vertex : m_track)
+		else
 		{
-			t_vert vert{
-				vertex.longitude * t_real(180) / num::pi_v<t_real>,
-				vertex.latitude * t_real(180) / num::pi_v<t_real>};
-			line.push_back(vert);
+			m_min_latitude = header.min_latitude;
+			m_max_latitude = header.max_latitude;
+			m_min_longitude = header.min_longitude;
+			m_max_longitude = header.max_longitude;
+
+			m_ids.assign(ids->begin(), ids->end());
+
+			m_vertices = std::move(new_vertices);
+			m_label_vertices = std::move(new_label_vertices);
+			m_segments = std::move(new_segments);
+			m_segments_background = std::move(new_segments_background);
+			m_segments_foreground = std::move(new_segments_foreground);
+			m_multisegments = std::move(new_multisegments);
 		}
 
-		if(line.size())
-		{
-			//svg.add(line);
-			svg.map(line, "stroke:#000000; "
-				"stroke-width:48px; fill:none;", 1.);
-			svg.map(line, "stroke:#ffff00; "
-				"stroke-width:24px; fill:none;", 1.);
+		m_skip_buildings = (header.flags & (1 << 0)) != 0;
+		m_skip_labels = (header.flags & (1 << 1)) != 0;
 
-			// draw start and end points
-			svg.map(*line.begin(), "stroke-width:16px; "
-				"stroke:#000000; fill:#ff0000;", 42.);
-			svg.map(*line.rbegin(), "stroke-width:16px; "
-				"stroke:#000000; fill:#00ff00;", 42.);
-		}
+		load_vertices(m_vertices, *vertices);
+		load_vertices(m_label_vertices, *label_vertices);
+		load_segments(m_segments, *segments);
+		load_segments(m_segments_background, *segments_background);
+		load_segments(m_segments_foreground, *segments_foreground);
 
-		// draw place labels
-		if(!m_skip_labels)
+		for(const FlatMultiSegment& rec : *multisegments)
 		{
-			for(const auto& [ id, vertex ] : m_label_vertices)
-			{
-				auto place_iter = vertex.tags.find("place");
-				auto name_iter = vertex.tags.find("name");
-
-				if(place_iter == vertex.tags.end() || name_iter == vertex.tags.end())
-					continue;
+			std::optional<t_size> id = load_id(rec.id, MapObjType::MULTISEGMENT);
+			if(!id)
+				continue;
 
-				t_vert vert{
-					vertex.longitude * t_real(180) / num::pi_v<t_real>,
-					vertex.latitude * t_real(180) / num::pi_v<t_real>};
+			t_multisegment seg
+			{
+				.vertex_ids = load_ids(rec.vertex_ids, MapObjType::VERTEX),
+				.segment_inner_ids = load_ids(rec.segment_inner_ids, MapObjType::SEGMENT),
+				.segment_ids = load_ids(rec.segment_ids, MapObjType::SEGMENT),
+				.tags = load_tags(rec.tags),
+			};
 
-				svg.text(vert, name_iter->second,
-					"font-family:sans-serif; font-size:180pt; "
-					"font-style=normal; font-weight=bold; "
-					"stroke-width:12px; stroke:#000000; fill:#cccc44;",
-					0, 0, 1);
-			}
+			m_multisegments.emplace(std::make_pair(*id, std::move(seg)));
 		}
 
 		return true;
@@ -1359,351 +3657,469 @@ public:
 
 
 
-	void SetSkipBuildings(bool b)
+	/**
+	 * save the map in the flat format
+	 */
+	bool Save(const std::string& filename) const
 	{
-		m_skip_buildings = b;
-	}
-
-
+		std::ofstream ofstr{filename, std::ios::binary};
+		if(!ofstr)
+			return false;
 
-	void SetSkipLabels(bool b)
-	{
-		m_skip_labels = b;
+		return SaveFlat(ofstr);
 	}
 
 
 
 	/**
-	 * set a track to be displayed together with the map
+	 * load a map in the flat format by memory-mapping it,
+	 * or in the original streamed format
 	 */
-	void SetTrack(std::vector<t_vertex>&& track)
+	bool Load(const std::string& filename, bool merge = false)
 	{
-		m_track = std::forward<std::vector<t_vertex>&&>(track);
-	}
+		namespace ipr = boost::interprocess;
 
+		TRACKS_PROFILE_SCOPE("Map::Load");
 
+		{
+			std::ifstream ifstr{filename, std::ios::binary};
+			if(!ifstr)
+				return false;
 
-	bool Save(std::ofstream& ofstr) const
-	{
-		if(!ofstr)
-			return false;
+			// check signature
+			char magic[sizeof(MAP_MAGIC_FLAT)]{};
+			ifstr.read(magic, sizeof(MAP_MAGIC));
+			if(std::string_view(magic) == MAP_MAGIC)
+				return Load(ifstr, merge);
 
-		auto save_string = [&ofstr](const std::string& str)
+			ifstr.read(magic + sizeof(MAP_MAGIC), sizeof(magic) - sizeof(MAP_MAGIC));
+			if(!ifstr || std::memcmp(magic, MAP_MAGIC_FLAT, sizeof(magic)) != 0)
+				return false;
+		}
+
+		try
 		{
-			const t_size len = str.size();
-			ofstr.write(reinterpret_cast<const char*>(&len), sizeof(len));
-			ofstr.write(reinterpret_cast<const char*>(str.data()), str.size() * sizeof(char));
-		};
+			ipr::file_mapping file{filename.c_str(), ipr::read_only};
+			ipr::mapped_region region{file, ipr::read_only};
 
-		auto save_tags = [&ofstr, &save_string](
-			const t_tags& tags)
+			return LoadFlat(static_cast<const char*>(region.get_address()),
+				region.get_size(), merge);
+		}
+		catch(const ipr::interprocess_exception&)
 		{
-			t_size num_tags = tags.size();
-			ofstr.write(reinterpret_cast<const char*>(&num_tags), sizeof(num_tags));
+			return false;
+		}
+		catch(const std::exception& ex)
+		{
+			// e.g. running out of memory for the ids of a corrupt file
+			std::cerr << "Could not load \"" << filename << "\": " << ex.what() << std::endl;
+			return false;
+		}
+	}
 
-			for(const auto& [key, val] : tags)
-			{
-				save_string(key);
-				save_string(val);
-			}
-		};
 
-		auto save_vertices = [&ofstr, &save_tags](
-			const std::unordered_map<t_size, t_vertex>& vertices)
-		{
-			t_size num_vertices = vertices.size();
-			ofstr.write(reinterpret_cast<const char*>(&num_vertices), sizeof(num_vertices));
 
-			for(const auto& [idx, vertex] : vertices)
-			{
-				ofstr.write(reinterpret_cast<const char*>(&idx), sizeof(idx));
-				ofstr.write(reinterpret_cast<const char*>(&vertex.latitude), sizeof(vertex.latitude));
-				ofstr.write(reinterpret_cast<const char*>(&vertex.longitude), sizeof(vertex.longitude));
+	/**
+	 * get the indices of the tile containing a point, angles in radians
+	 * @see https://wiki.openstreetmap.org/wiki/Slippy_map_tilenames
+	 */
+	static std::pair<std::uint32_t, std::uint32_t> GetTile(
+		t_real longitude, t_real latitude, unsigned int zoom)
+	{
+		namespace num = std::numbers;
 
-				save_tags(vertex.tags);
-			}
-		};
+		const t_real num_tiles = static_cast<t_real>(std::uint64_t(1) << zoom);
+
+		// the mercator projection ends at about +-85 degrees
+		const t_real lat_limit = std::atan(std::sinh(num::pi_v<t_real>));
+		latitude = std::clamp(latitude, -lat_limit, lat_limit);
 
-		auto save_segments = [&ofstr, &save_tags](
-			const std::unordered_map<t_size, t_segment>& segs)
+		const t_real x = (longitude + num::pi_v<t_real>)
+			/ (t_real(2) * num::pi_v<t_real>) * num_tiles;
+		const t_real y = (t_real(1) - std::asinh(std::tan(latitude))
+			/ num::pi_v<t_real>) / t_real(2) * num_tiles;
+
+		auto to_index = [num_tiles](t_real coord) -> std::uint32_t
 		{
-			t_size num_segs = segs.size();
-			ofstr.write(reinterpret_cast<const char*>(&num_segs), sizeof(num_segs));
+			return static_cast<std::uint32_t>(
+				std::clamp(std::floor(coord), t_real(0), num_tiles - t_real(1)));
+		};
 
-			for(const auto& [idx, seg] : segs)
-			{
-				ofstr.write(reinterpret_cast<const char*>(&idx), sizeof(idx));
+		return std::make_pair(to_index(x), to_index(y));
+	}
 
-				std::uint8_t flags = seg.is_area ? 1 : 0;
-				ofstr.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
 
-				t_size num_verts = seg.vertex_ids.size();
-				ofstr.write(reinterpret_cast<const char*>(&num_verts), sizeof(num_verts));
-				for(t_size vert_id : seg.vertex_ids)
-					ofstr.write(reinterpret_cast<const char*>(&vert_id), sizeof(vert_id));
 
-				save_tags(seg.tags);
-			}
+	/**
+	 * get the bounds (min_lon, max_lon, min_lat, max_lat) of a tile in radians
+	 */
+	static std::tuple<t_real, t_real, t_real, t_real> GetTileBounds(
+		std::uint32_t x, std::uint32_t y, unsigned int zoom)
+	{
+		namespace num = std::numbers;
+
+		const t_real num_tiles = static_cast<t_real>(std::uint64_t(1) << zoom);
+
+		auto get_longitude = [num_tiles](std::uint32_t x) -> t_real
+		{
+			return t_real(x) / num_tiles * t_real(2) * num::pi_v<t_real> - num::pi_v<t_real>;
 		};
 
-		auto save_multisegments = [&ofstr, &save_tags](
-			const std::unordered_map<t_size, t_multisegment>& segs)
+		auto get_latitude = [num_tiles](std::uint32_t y) -> t_real
 		{
-			t_size num_segs = segs.size();
-			ofstr.write(reinterpret_cast<const char*>(&num_segs), sizeof(num_segs));
+			return std::atan(std::sinh(num::pi_v<t_real> * (t_real(1) - t_real(2) * t_real(y) / num_tiles)));
+		};
 
-			for(const auto& [idx, seg] : segs)
-			{
-				ofstr.write(reinterpret_cast<const char*>(&idx), sizeof(idx));
+		return std::make_tuple(
+			get_longitude(x), get_longitude(x + 1),
+			get_latitude(y + 1), get_latitude(y));
+	}
 
-				t_size num_verts = seg.vertex_ids.size();
-				ofstr.write(reinterpret_cast<const char*>(&num_verts), sizeof(num_verts));
-				for(t_size vert_id : seg.vertex_ids)
-					ofstr.write(reinterpret_cast<const char*>(&vert_id), sizeof(vert_id));
 
-				t_size num_isegs = seg.segment_inner_ids.size();
-				ofstr.write(reinterpret_cast<const char*>(&num_isegs), sizeof(num_isegs));
-				for(t_size seg_id : seg.segment_inner_ids)
-					ofstr.write(reinterpret_cast<const char*>(&seg_id), sizeof(seg_id));
 
-				t_size num_segs = seg.segment_ids.size();
-				ofstr.write(reinterpret_cast<const char*>(&num_segs), sizeof(num_segs));
-				for(t_size seg_id : seg.segment_ids)
-					ofstr.write(reinterpret_cast<const char*>(&seg_id), sizeof(seg_id));
+	/**
+	 * get the zoom level of a tile directory written by SaveTiles,
+	 * if it contains several, the finest one is used
+	 */
+	static std::optional<unsigned int> GetTileZoom(const std::string& dirname)
+	{
+		namespace fs = __map_fs;
 
-				save_tags(seg.tags);
-			}
-		};
+		if(!fs::is_directory(dirname))
+			return std::nullopt;
 
-		ofstr.write(reinterpret_cast<const char*>(&m_min_latitude), sizeof(m_min_latitude));
-		ofstr.write(reinterpret_cast<const char*>(&m_max_latitude), sizeof(m_max_latitude));
-		ofstr.write(reinterpret_cast<const char*>(&m_min_longitude), sizeof(m_min_longitude));
-		ofstr.write(reinterpret_cast<const char*>(&m_max_longitude), sizeof(m_max_longitude));
+		std::optional<unsigned int> zoom;
 
-		std::uint8_t flags = 0;
-		if(m_skip_buildings)
-			flags |= (1 << 0);
-		if(m_skip_labels)
-			flags |= (1 << 1);
-		ofstr.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+		using t_iter = fs::directory_iterator;
+		t_iter dir{fs::path{dirname}};
 
-		save_vertices(m_vertices);
-		save_vertices(m_label_vertices);
-		save_segments(m_segments);
-		save_segments(m_segments_background);
-		save_segments(m_segments_foreground);
-		save_multisegments(m_multisegments);
+		for(t_iter iter = fs::begin(dir); iter != fs::end(dir); ++iter)
+		{
+			const fs::path& subdir = *iter;
+			if(!fs::is_directory(subdir))
+				continue;
 
-		return true;
+			const std::string name = subdir.filename().string();
+			if(name.size() == 0 || name.size() > 2 ||
+				name.find_first_not_of("0123456789") != std::string::npos)
+				continue;
+
+			const unsigned int dir_zoom = static_cast<unsigned int>(std::stoul(name));
+			if(!zoom || dir_zoom > *zoom)
+				zoom = dir_zoom;
+		}
+
+		return zoom;
 	}
 
 
 
-	bool Load(std::ifstream& ifstr)
+	/**
+	 * cut the map into tiles of a fixed zoom level, written to <dir>/<zoom>/<x>/<y>.trackmap
+	 *
+	 * A tile contains all segments and multi-segments whose bounds intersect it,
+	 * together with all the vertices and segments they reference. Objects keep
+	 * their ids, so that they are only added once when assembling the tiles.
+	 *
+	 * The map has to be fully imported before cutting it, as the ids are only
+	 * unique within one import, so the memory needed is that of the whole map.
+	 * The tiles are written in the streamed format, not in the flat one.
+	 */
+	bool SaveTiles(const std::string& dirname, unsigned int zoom = MAP_TILE_ZOOM,
+		std::function<bool(t_size, t_size)> *progress = nullptr) const
 	{
-		if(!ifstr)
-			return false;
+		namespace fs = __map_fs;
 
-		auto load_string = [&ifstr]() -> std::string
+		TRACKS_PROFILE_SCOPE("Map::SaveTiles");
+
+		// bounds of a map object
+		struct Bounds
 		{
-			t_size len{};
-			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
+			t_real min_longitude{std::numeric_limits<t_real>::max()};
+			t_real max_longitude{-std::numeric_limits<t_real>::max()};
+			t_real min_latitude{std::numeric_limits<t_real>::max()};
+			t_real max_latitude{-std::numeric_limits<t_real>::max()};
 
-			std::string str;
-			str.resize(len);
-			ifstr.read(reinterpret_cast<char*>(str.data()), str.size() * sizeof(char));
+			void Add(const t_vertex& vertex)
+			{
+				min_longitude = std::min(min_longitude, vertex.longitude);
+				max_longitude = std::max(max_longitude, vertex.longitude);
+				min_latitude = std::min(min_latitude, vertex.latitude);
+				max_latitude = std::max(max_latitude, vertex.latitude);
+			}
 
-			return str;
+			bool IsValid() const
+			{
+				return min_longitude <= max_longitude && min_latitude <= max_latitude;
+			}
 		};
 
-		auto load_tags = [&ifstr, &load_string]() -> t_tags
+		// tiles indexed by their x and y indices
+		std::unordered_map<std::uint64_t, t_tile> tiles;
+
+		// call a function for all tiles intersecting the bounds
+		auto for_tiles = [&tiles, zoom](const Bounds& bounds, auto&& func)
 		{
-			t_size len{};
-			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
+			if(!bounds.IsValid())
+				return;
 
-			t_tags tags;
+			// tile y indices increase from north to south
+			auto [ x_min, y_min ] = GetTile(bounds.min_longitude, bounds.max_latitude, zoom);
+			auto [ x_max, y_max ] = GetTile(bounds.max_longitude, bounds.min_latitude, zoom);
 
-			for(t_size i = 0; i < len; ++i)
-			{
-				std::string key = load_string();
-				std::string val = load_string();
+			for(std::uint64_t x = x_min; x <= x_max; ++x)
+				for(std::uint64_t y = y_min; y <= y_max; ++y)
+					func(tiles[(x << 32) | y]);
+		};
 
-				tags.emplace(std::make_pair(std::move(key), std::move(val)));
+		auto add_bounds = [this](Bounds& bounds, const t_idrange& vertex_ids)
+		{
+			for(const t_size id : GetIds(vertex_ids))
+			{
+				if(const t_vertex *vertex = m_vertices.Find(id); vertex)
+					bounds.Add(*vertex);
 			}
-
-			return tags;
 		};
 
-		auto load_vertices = [&ifstr, &load_tags]()
-			-> std::unordered_map<t_size, t_vertex>
+		auto add_vertices = [this](t_tile& tile, const t_idrange& vertex_ids)
 		{
-			t_size len{};
-			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
-
-			std::unordered_map<t_size, t_vertex> vertices;
-
-			for(t_size i = 0; i < len; ++i)
+			for(const t_size id : GetIds(vertex_ids))
 			{
-				t_vertex vertex;
-
-				t_size idx{};
-				ifstr.read(reinterpret_cast<char*>(&idx), sizeof(idx));
-				ifstr.read(reinterpret_cast<char*>(&vertex.latitude), sizeof(vertex.latitude));
-				ifstr.read(reinterpret_cast<char*>(&vertex.longitude), sizeof(vertex.longitude));
-
-				vertex.tags = load_tags();
-				vertex.referenced = true;
-
-				vertices.emplace(std::make_pair(idx, std::move(vertex)));
+				if(m_vertices.Find(id))
+					tile.vertex_ids.push_back(id);
 			}
+		};
 
-			return vertices;
+		// find a segment in any of the layers
+		auto find_segment = [this](t_size id) -> std::pair<const t_segment*, std::vector<t_size> t_tile::*>
+		{
+			if(const t_segment *seg = FindObject(m_segments, id); seg)
+				return std::make_pair(seg, &t_tile::segment_ids);
+			if(const t_segment *seg = FindObject(m_segments_background, id); seg)
+				return std::make_pair(seg, &t_tile::segment_background_ids);
+			if(const t_segment *seg = FindObject(m_segments_foreground, id); seg)
+				return std::make_pair(seg, &t_tile::segment_foreground_ids);
+			return std::make_pair(nullptr, nullptr);
 		};
 
-		auto load_segments = [&ifstr, &load_tags]()
-			-> std::unordered_map<t_size, t_segment>
 		{
-			t_size len{};
-			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
+			TRACKS_PROFILE_SCOPE("Map::SaveTiles assign");
+
+			for(const auto& entry : m_label_vertices)
+			{
+				Bounds bounds;
+				bounds.Add(entry.second);
 
-			std::unordered_map<t_size, t_segment> segs;
+				for_tiles(bounds, [&entry](t_tile& tile)
+				{
+					tile.label_vertex_ids.push_back(entry.first);
+				});
+			}
 
-			for(t_size i = 0; i < len; ++i)
+			auto add_segments = [&for_tiles, &add_bounds, &add_vertices](
+				const auto& segs, std::vector<t_size> t_tile::*seg_ids)
 			{
-				t_segment seg;
+				for(const auto& entry : segs)
+				{
+					Bounds bounds;
+					add_bounds(bounds, entry.second.vertex_ids);
 
-				t_size idx{};
-				ifstr.read(reinterpret_cast<char*>(&idx), sizeof(idx));
+					for_tiles(bounds, [&entry, &add_vertices, seg_ids](t_tile& tile)
+					{
+						(tile.*seg_ids).push_back(entry.first);
+						add_vertices(tile, entry.second.vertex_ids);
+					});
+				}
+			};
 
-				std::uint8_t flags;
-				ifstr.read(reinterpret_cast<char*>(&flags), sizeof(flags));
-				seg.is_area = (flags != 0);
+			add_segments(m_segments, &t_tile::segment_ids);
+			add_segments(m_segments_background, &t_tile::segment_background_ids);
+			add_segments(m_segments_foreground, &t_tile::segment_foreground_ids);
 
-				t_size num_verts{};
-				ifstr.read(reinterpret_cast<char*>(&num_verts), sizeof(num_verts));
+			for(const auto& entry : m_multisegments)
+			{
+				const t_multisegment& multiseg = entry.second;
 
-				for(t_size j = 0; j < num_verts; ++j)
+				Bounds bounds;
+				add_bounds(bounds, multiseg.vertex_ids);
+				for(const t_idrange *seg_ids : { &multiseg.segment_ids, &multiseg.segment_inner_ids })
 				{
-					t_size vert_id{};
-					ifstr.read(reinterpret_cast<char*>(&vert_id), sizeof(vert_id));
-
-					seg.vertex_ids.push_back(vert_id);
+					for(const t_size seg_id : GetIds(*seg_ids))
+					{
+						if(const t_segment *seg = find_segment(seg_id).first; seg)
+							add_bounds(bounds, seg->vertex_ids);
+					}
 				}
 
-				seg.tags = load_tags();
-				seg.referenced = true;
+				for_tiles(bounds, [this, &entry, &multiseg, &add_vertices, &find_segment](t_tile& tile)
+				{
+					tile.multisegment_ids.push_back(entry.first);
+					add_vertices(tile, multiseg.vertex_ids);
 
-				segs.emplace(std::make_pair(idx, std::move(seg)));
+					for(const t_idrange *seg_ids : { &multiseg.segment_ids, &multiseg.segment_inner_ids })
+					{
+						for(const t_size seg_id : GetIds(*seg_ids))
+						{
+							auto [ seg, tile_seg_ids ] = find_segment(seg_id);
+							if(!seg)
+								continue;
+
+							(tile.*tile_seg_ids).push_back(seg_id);
+							add_vertices(tile, seg->vertex_ids);
+						}
+					}
+				});
 			}
+		}
 
-			return segs;
-		};
+		TRACKS_PROFILE_SCOPE("Map::SaveTiles write");
 
-		auto load_multisegments = [&ifstr, &load_tags]()
-			-> std::unordered_map<t_size, t_multisegment>
+		const fs::path zoom_dir = fs::path{dirname} / std::to_string(zoom);
+		t_size tile_idx = 0;
+
+		for(auto& [ key, tile ] : tiles)
 		{
-			t_size len{};
-			ifstr.read(reinterpret_cast<char*>(&len), sizeof(len));
+			const std::uint32_t x = static_cast<std::uint32_t>(key >> 32);
+			const std::uint32_t y = static_cast<std::uint32_t>(key & 0xffffffff);
 
-			std::unordered_map<t_size, t_multisegment> segs;
+			std::tie(tile.min_longitude, tile.max_longitude, tile.min_latitude, tile.max_latitude)
+				= GetTileBounds(x, y, zoom);
 
-			for(t_size i = 0; i < len; ++i)
+			// objects referenced from several others were added more than once
+			for(std::vector<t_size> *ids : {
+				&tile.vertex_ids, &tile.label_vertex_ids,
+				&tile.segment_ids, &tile.segment_background_ids, &tile.segment_foreground_ids,
+				&tile.multisegment_ids })
 			{
-				t_multisegment seg;
+				std::sort(ids->begin(), ids->end());
+				ids->erase(std::unique(ids->begin(), ids->end()), ids->end());
+			}
 
-				t_size idx{};
-				ifstr.read(reinterpret_cast<char*>(&idx), sizeof(idx));
+			const fs::path x_dir = zoom_dir / std::to_string(x);
+			fs::create_directories(x_dir);
 
-				t_size num_verts{};
-				ifstr.read(reinterpret_cast<char*>(&num_verts), sizeof(num_verts));
+			std::ofstream ofstr{(x_dir / (std::to_string(y) + ".trackmap")).string(), std::ios::binary};
+			if(!ofstr)
+				return false;
 
-				for(t_size j = 0; j < num_verts; ++j)
-				{
-					t_size vert_id{};
-					ifstr.read(reinterpret_cast<char*>(&vert_id), sizeof(vert_id));
+			// save signature
+			ofstr.write(MAP_MAGIC, sizeof(MAP_MAGIC));
 
-					seg.vertex_ids.push_back(vert_id);
-				}
+			if(!Save(ofstr, &tile))
+				return false;
 
-				t_size num_isegs{};
-				ifstr.read(reinterpret_cast<char*>(&num_isegs), sizeof(num_isegs));
+			// the tile is not needed anymore
+			tile = t_tile{};
 
-				for(t_size j = 0; j < num_isegs; ++j)
-				{
-					t_size seg_id{};
-					ifstr.read(reinterpret_cast<char*>(&seg_id), sizeof(seg_id));
+			if(progress && !(*progress)(++tile_idx, static_cast<t_size>(tiles.size())))
+				return false;
+		}
 
-					seg.segment_inner_ids.push_back(seg_id);
-				}
+		return true;
+	}
 
-				t_size num_segs{};
-				ifstr.read(reinterpret_cast<char*>(&num_segs), sizeof(num_segs));
 
-				for(t_size j = 0; j < num_segs; ++j)
-				{
-					t_size seg_id{};
-					ifstr.read(reinterpret_cast<char*>(&seg_id), sizeof(seg_id));
 
-					seg.segment_ids.push_back(seg_id);
-				}
+	/**
+	 * assemble the map from the tiles written by SaveTiles which intersect the given bounds
+	 */
+	bool LoadTiles(const std::string& dirname,
+		t_real min_longitude, t_real max_longitude,
+		t_real min_latitude, t_real max_latitude,
+		std::function<bool(t_size, t_size)> *progress = nullptr)
+	{
+		namespace fs = __map_fs;
 
-				seg.tags = load_tags();
+		TRACKS_PROFILE_SCOPE("Map::LoadTiles");
 
-				segs.emplace(std::make_pair(idx, std::move(seg)));
-			}
+		std::optional<unsigned int> zoom = GetTileZoom(dirname);
+		if(!zoom)
+			return false;
 
-			return segs;
-		};
+		// reset vertex ranges
+		m_min_latitude = std::numeric_limits<t_real>::max();
+		m_max_latitude = -m_min_latitude;
+		m_min_longitude = std::numeric_limits<t_real>::max();
+		m_max_longitude = -m_min_longitude;
 
-		ifstr.read(reinterpret_cast<char*>(&m_min_latitude), sizeof(m_min_latitude));
-		ifstr.read(reinterpret_cast<char*>(&m_max_latitude), sizeof(m_max_latitude));
-		ifstr.read(reinterpret_cast<char*>(&m_min_longitude), sizeof(m_min_longitude));
-		ifstr.read(reinterpret_cast<char*>(&m_max_longitude), sizeof(m_max_longitude));
+		// tile y indices increase from north to south
+		auto [ x_min, y_min ] = GetTile(min_longitude, max_latitude, *zoom);
+		auto [ x_max, y_max ] = GetTile(max_longitude, min_latitude, *zoom);
 
-		std::uint8_t flags = 0;
-		ifstr.read(reinterpret_cast<char*>(&flags), sizeof(flags));
-		m_skip_buildings = (flags & (1 << 0)) != 0;
-		m_skip_labels = (flags & (1 << 1)) != 0;
+		const fs::path zoom_dir = fs::path{dirname} / std::to_string(*zoom);
+		const t_size num_tiles = static_cast<t_size>((x_max - x_min + 1) * (y_max - y_min + 1));
+		t_size tile_idx = 0;
+		bool loaded = false;
 
-		m_vertices = load_vertices();
-		m_label_vertices = load_vertices();
-		m_segments = load_segments();
-		m_segments_background = load_segments();
-		m_segments_foreground = load_segments();
-		m_multisegments = load_multisegments();
+		for(std::uint32_t x = x_min; x <= x_max; ++x)
+		{
+			for(std::uint32_t y = y_min; y <= y_max; ++y)
+			{
+				const fs::path file = zoom_dir / std::to_string(x) / (std::to_string(y) + ".trackmap");
+				if(fs::is_regular_file(file) && Load(file.string(), true))
+					loaded = true;
 
-		return true;
+				if(progress && !(*progress)(++tile_idx, num_tiles))
+					return false;
+			}
+		}
+
+		return loaded;
 	}
 
 
 
-	bool Save(const std::string& filename) const
+	/**
+	 * estimate the heap memory used by the map objects
+	 */
+	MemoryBreakdown MemoryUsage() const
 	{
-		std::ofstream ofstr{filename, std::ios::binary};
-		if(!ofstr)
-			return false;
+		MemoryBreakdown mem;
+
+		// dense stores or hash tables of map objects
+		auto mem_objects = [](const auto& objs) -> std::size_t
+		{
+			if constexpr(requires { objs.GetMemory(); })
+				return objs.GetMemory();
+			else
+				return mem_unordered_map(objs);
+		};
 
-		// save signature
-		ofstr.write(MAP_MAGIC, sizeof(MAP_MAGIC));
+		auto add_vertices = [&mem, &mem_objects](const auto& vertices)
+		{
+			mem.Add("vertices", mem_objects(vertices));
+			for(const auto& [ id, vertex ] : vertices)
+				mem.Add("vertex tags", vertex.tags.GetMemory());
+		};
 
-		return Save(ofstr);
-	}
+		auto add_segments = [&mem, &mem_objects](const auto& segments)
+		{
+			mem.Add("segments", mem_objects(segments));
+			for(const auto& [ id, segment ] : segments)
+				mem.Add("segment tags", segment.tags.GetMemory());
+		};
 
+		add_vertices(m_vertices);
+		add_vertices(m_label_vertices);
+		add_segments(m_segments);
+		add_segments(m_segments_background);
+		add_segments(m_segments_foreground);
 
+		mem.Add("multi-segments", mem_objects(m_multisegments));
+		for(const auto& [ id, multisegment ] : m_multisegments)
+			mem.Add("multi-segment tags", multisegment.tags.GetMemory());
 
-	bool Load(const std::string& filename)
-	{
-		std::ifstream ifstr{filename, std::ios::binary};
-		if(!ifstr)
-			return false;
+		mem.Add("id references", mem_vector(m_ids));
+		mem.Add("tag strings", m_strings.GetMemory());
 
-		// check signature
-		char magic[sizeof(MAP_MAGIC)];
-		ifstr.read(magic, sizeof(magic));
-		if(std::string_view(magic) != MAP_MAGIC)
-			return false;
+		mem.Add("track", mem_vector(m_track));
+		mem.Add("id translation", m_local_vert_ids.GetMemory()
+			+ m_local_seg_ids.GetMemory()
+			+ m_local_multiseg_ids.GetMemory());
+		mem.Add("strings", mem_string(m_filename)
+			+ mem_string(m_version) + mem_string(m_creator));
 
-		return Load(ifstr);
+		return mem;
 	}
 
 
@@ -1719,13 +4135,27 @@ protected:
 	bool m_skip_buildings{false};
 	bool m_skip_labels{true};
 	bool m_skip_unnecessary_tags{true};
+	bool m_two_pass_import{false};
+
+	unsigned int m_num_threads{GetDefaultNumThreads()};
 
-	std::unordered_map<t_size, t_vertex> m_vertices{};
+	// objects looked up by their local id are stored densely, the label
+	// vertices and background and foreground segments only use a sparse
+	// part of the shared id ranges and are kept in hash tables
+	DenseStore<t_vertex, t_size> m_vertices{};
 	std::unordered_map<t_size, t_vertex> m_label_vertices{};
-	std::unordered_map<t_size, t_segment> m_segments{};
+	DenseStore<t_segment, t_size> m_segments{};
 	std::unordered_map<t_size, t_segment> m_segments_background{};
 	std::unordered_map<t_size, t_segment> m_segments_foreground{};
-	std::unordered_map<t_size, t_multisegment> m_multisegments{};
+	DenseStore<t_multisegment, t_size> m_multisegments{};
+
+	// ids referenced by the segments and multi-segments, in consecutive ranges
+	std::vector<t_size> m_ids{};
+
+	// spatial index of the segments and multi-segments, built on demand
+	// and reset whenever the objects change
+	mutable std::unique_ptr<t_index> m_index{};
+	mutable std::mutex m_index_mtx{};
 
 	std::vector<t_vertex> m_track{};
 
@@ -1733,13 +4163,24 @@ protected:
 
 private:
 	// map to translate to local ids (only used for importing)
-	std::unordered_map<t_osmid, t_size> m_local_vert_ids{};
-	std::unordered_map<t_osmid, t_size> m_local_seg_ids{};
-	std::unordered_map<t_osmid, t_size> m_local_multiseg_ids{};
+	using t_idmap = SparseIdMap<t_osmid, t_size>;
+	std::string m_node_index_file{};
+	t_idmap m_local_vert_ids{};
+	t_idmap m_local_seg_ids{};
+	t_idmap m_local_multiseg_ids{};
 	t_size m_cur_local_vert_id{};
 	t_size m_cur_local_seg_id{};
 	t_size m_cur_local_multiseg_id{};
 
+	// interned tag keys and values
+	StringPool<t_strid> m_strings{};
+	t_strid m_id_building{}, m_id_place{}, m_id_name{};
+	t_strid m_id_leisure{}, m_id_swimming_pool{};
+
+	// styles indexed by the combined key and value ids
+	std::unordered_map<std::uint64_t, t_real> m_road_width_ids{};
+	std::unordered_map<std::uint64_t, std::tuple<int, int, int>> m_seg_colour_ids{};
+
 
 	// @see https://wiki.openstreetmap.org/wiki/Key:highway
 	std::unordered_map<std::string_view, t_widthmap> m_road_widths
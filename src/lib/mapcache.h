@@ -0,0 +1,224 @@
+/**
+ * cache of map files keyed by their bounds
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_MAP_CACHE_H__
+#define __TRACKS_MAP_CACHE_H__
+
+#include <string>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <optional>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <concepts>
+
+#if __has_include(<filesystem>)
+	#include <filesystem>
+	namespace __mapcache_fs = std::filesystem;
+#else
+	#include <boost/filesystem.hpp>
+	namespace __mapcache_fs = boost::filesystem;
+#endif
+
+#include <boost/algorithm/string.hpp>
+
+
+
+/**
+ * finds cached map files covering a requested area
+ *
+ * The bounds of a cached map are widened to a coarse grid and encoded in its
+ * file name, so that tracks in the same area share one cached map, which
+ * is found by checking whether its bounds contain the requested ones.
+ */
+template<class t_real = double>
+requires std::floating_point<t_real>
+class MapCache
+{
+public:
+	// min_lon, max_lon, min_lat, max_lat in radians
+	using t_bounds = std::tuple<t_real, t_real, t_real, t_real>;
+
+
+
+public:
+	MapCache() = default;
+	~MapCache() = default;
+
+
+
+	/**
+	 * set the directory containing the cached maps
+	 */
+	void SetDirectory(const std::string& dir)
+	{
+		m_dir = dir;
+	}
+
+
+
+	/**
+	 * set the grid spacing of the cached bounds in radians
+	 */
+	void SetGrid(t_real grid)
+	{
+		m_grid = grid;
+	}
+
+
+
+	/**
+	 * widen bounds to the cache grid
+	 */
+	t_bounds Quantise(const t_bounds& bounds) const
+	{
+		const auto [ min_lon, max_lon, min_lat, max_lat ] = bounds;
+
+		return std::make_tuple(
+			std::floor(min_lon / m_grid) * m_grid,
+			std::ceil(max_lon / m_grid) * m_grid,
+			std::floor(min_lat / m_grid) * m_grid,
+			std::ceil(max_lat / m_grid) * m_grid);
+	}
+
+
+
+	/**
+	 * get the file name to cache a map with the given bounds under,
+	 * the bounds are widened to the cache grid
+	 */
+	std::string GetFilename(const t_bounds& bounds) const
+	{
+		const std::array<std::int64_t, 4> keys = ToKeys(Quantise(bounds));
+
+		std::string filename = "bounds";
+		for(std::int64_t key : keys)
+			filename += "_" + std::to_string(key);
+		filename += ".trackmap";
+
+		return (GetDirectory() / filename).string();
+	}
+
+
+
+	/**
+	 * find the smallest cached map containing the given bounds
+	 */
+	std::optional<std::string> Find(const t_bounds& bounds) const
+	{
+		namespace fs = __mapcache_fs;
+
+		const auto [ min_lon, max_lon, min_lat, max_lat ] = ToKeys(bounds);
+
+		const fs::path dir = GetDirectory();
+		if(!fs::is_directory(dir))
+			return std::nullopt;
+
+		std::optional<std::string> best_file;
+		double best_area = std::numeric_limits<double>::max();
+
+		using t_iter = fs::directory_iterator;
+		t_iter dir_iter{dir};
+
+		for(t_iter iter = fs::begin(dir_iter); iter != fs::end(dir_iter); ++iter)
+		{
+			const fs::path& file = *iter;
+			if(!fs::is_regular_file(file) || file.extension().string() != ".trackmap")
+				continue;
+
+			std::optional<std::array<std::int64_t, 4>> keys = ParseFilename(file.stem().string());
+			if(!keys)
+				continue;
+
+			const auto [ file_min_lon, file_max_lon, file_min_lat, file_max_lat ] = *keys;
+			if(file_min_lon > min_lon || file_max_lon < max_lon ||
+				file_min_lat > min_lat || file_max_lat < max_lat)
+				continue;
+
+			const double area = double(file_max_lon - file_min_lon) * double(file_max_lat - file_min_lat);
+			if(area < best_area)
+			{
+				best_area = area;
+				best_file = file.string();
+			}
+		}
+
+		return best_file;
+	}
+
+
+
+protected:
+	__mapcache_fs::path GetDirectory() const
+	{
+		return __mapcache_fs::path{m_dir == "" ? "." : m_dir};
+	}
+
+
+
+	/**
+	 * convert bounds to integers in units of micro-radians,
+	 * rounding outwards so that containment checks stay conservative
+	 */
+	static std::array<std::int64_t, 4> ToKeys(const t_bounds& bounds)
+	{
+		const auto [ min_lon, max_lon, min_lat, max_lat ] = bounds;
+		constexpr t_real scale = 1e6;
+
+		return std::array<std::int64_t, 4>{
+			static_cast<std::int64_t>(std::floor(min_lon * scale)),
+			static_cast<std::int64_t>(std::ceil(max_lon * scale)),
+			static_cast<std::int64_t>(std::floor(min_lat * scale)),
+			static_cast<std::int64_t>(std::ceil(max_lat * scale)) };
+	}
+
+
+
+	/**
+	 * get the bounds keys from a file name "bounds_<min_lon>_<max_lon>_<min_lat>_<max_lat>"
+	 */
+	static std::optional<std::array<std::int64_t, 4>> ParseFilename(const std::string& name)
+	{
+		std::vector<std::string> parts;
+		boost::split(parts, name, [](char c) -> bool { return c == '_'; });
+
+		if(parts.size() != 5 || parts[0] != "bounds")
+			return std::nullopt;
+
+		std::array<std::int64_t, 4> keys{};
+		for(std::size_t idx = 0; idx < keys.size(); ++idx)
+		{
+			const std::string& part = parts[idx + 1];
+			if(part.size() == 0 || part.find_first_not_of("-0123456789") != std::string::npos)
+				return std::nullopt;
+
+			try
+			{
+				keys[idx] = std::stoll(part);
+			}
+			catch(const std::exception&)
+			{
+				return std::nullopt;
+			}
+		}
+
+		return keys;
+	}
+
+
+
+private:
+	std::string m_dir{};
+
+	// about 10 km in latitude
+	t_real m_grid{0.0015};
+};
+
+
+#endif
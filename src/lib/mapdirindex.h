@@ -0,0 +1,266 @@
+/**
+ * index of the map files in a directory
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_MAP_DIR_INDEX_H__
+#define __TRACKS_MAP_DIR_INDEX_H__
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <optional>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <cstdint>
+#include <concepts>
+
+#if __has_include(<filesystem>)
+	#include <filesystem>
+	namespace __mapdir_fs = std::filesystem;
+#else
+	#include <boost/filesystem.hpp>
+	namespace __mapdir_fs = boost::filesystem;
+#endif
+
+#include <boost/algorithm/string.hpp>
+
+
+#define MAP_DIR_INDEX ".tracks_mapindex"
+#define MAP_DIR_INDEX_MAGIC "TRACKS_MAPINDEX_2"
+
+
+
+/**
+ * keeps the bounds stored in the headers of the map files in a directory,
+ * so that the map files do not have to be opened to find a matching one
+ *
+ * An entry is only refreshed when the size or the modification time
+ * of its file has changed, or when its bounds could not be read before.
+ */
+template<class t_real = double>
+requires std::floating_point<t_real>
+class MapDirIndex
+{
+public:
+	// min_lon, max_lon, min_lat, max_lat in radians
+	using t_bounds = std::tuple<t_real, t_real, t_real, t_real>;
+
+	struct Entry
+	{
+		// file name relative to the directory
+		std::string filename{};
+		std::int64_t mtime{};
+		std::uintmax_t size{};
+
+		std::vector<t_bounds> bounds{};
+
+		// the bounds could not be read, e.g. without osmium support
+		bool unknown{false};
+	};
+
+
+
+public:
+	MapDirIndex() = default;
+	~MapDirIndex() = default;
+
+
+
+	bool Load(const std::string& filename)
+	{
+		std::ifstream ifstr{filename};
+		if(!ifstr)
+			return false;
+
+		std::string line;
+		if(!std::getline(ifstr, line) || line != MAP_DIR_INDEX_MAGIC)
+			return false;
+
+		m_entries.clear();
+
+		// one line per file: size, modification time, number of bounds or -1 if unknown, bounds, name
+		while(std::getline(ifstr, line))
+		{
+			std::istringstream istr{line};
+
+			Entry entry;
+			std::int64_t num_bounds = 0;
+			istr >> entry.size >> entry.mtime >> num_bounds;
+
+			if(num_bounds < 0)
+			{
+				entry.unknown = true;
+				num_bounds = 0;
+			}
+
+			entry.bounds.reserve(std::size_t(num_bounds));
+			for(std::int64_t idx = 0; idx < num_bounds; ++idx)
+			{
+				t_real min_lon{}, max_lon{}, min_lat{}, max_lat{};
+				istr >> min_lon >> max_lon >> min_lat >> max_lat;
+				entry.bounds.emplace_back(min_lon, max_lon, min_lat, max_lat);
+			}
+
+			std::getline(istr >> std::ws, entry.filename);
+			if(istr.fail() || entry.filename == "")
+			{
+				// corrupt index, rebuild it
+				m_entries.clear();
+				return false;
+			}
+
+			m_entries.emplace_back(std::move(entry));
+		}
+
+		m_modified = false;
+		return true;
+	}
+
+
+
+	bool Save(const std::string& filename) const
+	{
+		std::ofstream ofstr{filename};
+		if(!ofstr)
+			return false;
+
+		ofstr.precision(std::numeric_limits<t_real>::max_digits10);
+		ofstr << MAP_DIR_INDEX_MAGIC << "\n";
+
+		for(const Entry& entry : m_entries)
+		{
+			ofstr << entry.size << " " << entry.mtime << " "
+				<< (entry.unknown ? std::int64_t(-1) : std::int64_t(entry.bounds.size()));
+			for(const auto& [ min_lon, max_lon, min_lat, max_lat ] : entry.bounds)
+				ofstr << " " << min_lon << " " << max_lon << " " << min_lat << " " << max_lat;
+			ofstr << " " << entry.filename << "\n";
+		}
+
+		return static_cast<bool>(ofstr);
+	}
+
+
+
+	/**
+	 * bring the index up to date with the map files in the directory,
+	 * only reading the bounds of new or changed files
+	 * @param read_bounds gives no value if the bounds of a file could not be read
+	 * @return true if the index has changed
+	 */
+	bool Update(const std::string& dirname,
+		const std::function<std::optional<std::vector<t_bounds>>(const std::string&)>& read_bounds)
+	{
+		namespace fs = __mapdir_fs;
+
+		std::unordered_map<std::string, Entry> old_entries;
+		for(Entry& entry : m_entries)
+			old_entries.emplace(entry.filename, std::move(entry));
+		m_entries.clear();
+
+		using t_iter = fs::directory_iterator;
+		t_iter dir{fs::path{dirname}};
+
+		for(t_iter iter = fs::begin(dir); iter != fs::end(dir); ++iter)
+		{
+			const fs::path& file = *iter;
+
+			if(!fs::is_regular_file(file))
+				continue;
+			if(std::string ext = file.extension().string();
+				boost::to_lower_copy(ext) != ".osm" && boost::to_lower_copy(ext) != ".pbf")
+				continue;
+
+			Entry entry
+			{
+				.filename = file.filename().string(),
+				.mtime = GetModificationTime(file),
+				.size = static_cast<std::uintmax_t>(fs::file_size(file)),
+			};
+
+			// reuse the bounds if the file is unchanged and they are known
+			bool was_unknown = false;
+			if(auto iter_old = old_entries.find(entry.filename); iter_old != old_entries.end()
+				&& iter_old->second.mtime == entry.mtime && iter_old->second.size == entry.size)
+			{
+				Entry old_entry = std::move(iter_old->second);
+				old_entries.erase(iter_old);
+
+				if(!old_entry.unknown)
+				{
+					m_entries.emplace_back(std::move(old_entry));
+					continue;
+				}
+
+				was_unknown = true;
+			}
+
+			if(std::optional<std::vector<t_bounds>> bounds = read_bounds(file.string()); bounds)
+				entry.bounds = std::move(*bounds);
+			else
+				entry.unknown = true;
+
+			// an entry that is still unknown has not changed
+			if(!was_unknown || !entry.unknown)
+				m_modified = true;
+			m_entries.emplace_back(std::move(entry));
+		}
+
+		// files have been removed
+		if(old_entries.size())
+			m_modified = true;
+
+		std::sort(m_entries.begin(), m_entries.end(),
+			[](const Entry& entry1, const Entry& entry2) -> bool
+		{
+			return entry1.filename < entry2.filename;
+		});
+
+		return m_modified;
+	}
+
+
+
+	const std::vector<Entry>& GetEntries() const
+	{
+		return m_entries;
+	}
+
+
+
+protected:
+	static std::int64_t GetModificationTime(const __mapdir_fs::path& file)
+	{
+		return GetTimeStamp(__mapdir_fs::last_write_time(file));
+	}
+
+
+
+	/**
+	 * std::filesystem gives a time point, boost::filesystem a time_t
+	 */
+	template<class t_time>
+	static std::int64_t GetTimeStamp(const t_time& mtime)
+	{
+		if constexpr(requires { mtime.time_since_epoch(); })
+			return static_cast<std::int64_t>(mtime.time_since_epoch().count());
+		else
+			return static_cast<std::int64_t>(mtime);
+	}
+
+
+
+private:
+	std::vector<Entry> m_entries{};
+	bool m_modified{false};
+};
+
+
+#endif
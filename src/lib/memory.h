@@ -0,0 +1,184 @@
+/**
+ * memory usage estimation
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_MEMORY_H__
+#define __TRACKS_MEMORY_H__
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstddef>
+
+
+
+/**
+ * named memory sizes of the parts of a data structure
+ */
+class MemoryBreakdown
+{
+public:
+	using t_entry = std::pair<std::string, std::size_t>;
+
+
+
+public:
+	MemoryBreakdown() = default;
+	~MemoryBreakdown() = default;
+
+
+
+	/**
+	 * add a size [bytes] to the part with the given name
+	 */
+	void Add(const std::string& name, std::size_t bytes)
+	{
+		auto iter = std::find_if(m_entries.begin(), m_entries.end(),
+			[&name](const t_entry& entry) -> bool
+		{
+			return entry.first == name;
+		});
+
+		if(iter == m_entries.end())
+			m_entries.emplace_back(std::make_pair(name, bytes));
+		else
+			iter->second += bytes;
+	}
+
+
+
+	/**
+	 * add all parts of another breakdown
+	 */
+	void Add(const MemoryBreakdown& other, const std::string& prefix = "")
+	{
+		for(const auto& [ name, bytes ] : other.m_entries)
+			Add(prefix + name, bytes);
+	}
+
+
+
+	const std::vector<t_entry>& GetEntries() const
+	{
+		return m_entries;
+	}
+
+
+
+	std::size_t GetTotal() const
+	{
+		std::size_t total = 0;
+		for(const auto& entry : m_entries)
+			total += entry.second;
+		return total;
+	}
+
+
+
+	/**
+	 * print a table of the parts and the total size
+	 */
+	void Print(std::ostream& ostr) const
+	{
+		const int w_name = 32, w_val = 14;
+		std::ios_base::fmtflags flags = ostr.flags();
+		std::streamsize prec = ostr.precision();
+
+		const std::size_t total = GetTotal();
+		ostr << std::fixed << std::setprecision(2);
+
+		for(const auto& [ name, bytes ] : m_entries)
+		{
+			ostr << std::left << std::setw(w_name) << name
+				<< std::right << std::setw(w_val) << (double(bytes) / 1024. / 1024.) << " MiB"
+				<< std::setw(w_val - 4) << (total ? double(bytes) / double(total) * 100. : 0.) << " %\n";
+		}
+
+		ostr << std::left << std::setw(w_name) << "total"
+			<< std::right << std::setw(w_val) << (double(total) / 1024. / 1024.) << " MiB\n";
+
+		ostr.flush();
+		ostr.flags(flags);
+		ostr.precision(prec);
+	}
+
+
+
+private:
+	std::vector<t_entry> m_entries{};
+};
+
+
+
+// ----------------------------------------------------------------------------
+// heap memory of standard containers, excluding the allocator's own overhead
+// and the size of the container object itself
+// ----------------------------------------------------------------------------
+
+template<class t_val>
+std::size_t mem_vector(const std::vector<t_val>& vec)
+{
+	return vec.capacity() * sizeof(t_val);
+}
+
+
+
+inline std::size_t mem_string(const std::string& str)
+{
+	// short strings are stored within the string object
+	static const std::size_t sso_capacity = std::string{}.capacity();
+
+	if(str.capacity() <= sso_capacity)
+		return 0;
+	return str.capacity() + 1;
+}
+
+
+
+/**
+ * list nodes with their forward and backward pointers
+ */
+template<class t_val>
+std::size_t mem_list(const std::list<t_val>& lst)
+{
+	return lst.size() * (sizeof(t_val) + 2*sizeof(void*));
+}
+
+
+
+/**
+ * hash table buckets and nodes with their next pointers and cached hash values
+ */
+template<class t_key, class t_val, class ...t_args>
+std::size_t mem_unordered_map(const std::unordered_map<t_key, t_val, t_args...>& map)
+{
+	using t_map = std::unordered_map<t_key, t_val, t_args...>;
+
+	return map.bucket_count() * sizeof(void*)
+		+ map.size() * (sizeof(typename t_map::value_type) + sizeof(void*) + sizeof(std::size_t));
+}
+
+
+
+/**
+ * hash table of strings, including the string contents
+ */
+template<class ...t_args>
+std::size_t mem_string_map(const std::unordered_map<std::string, std::string, t_args...>& map)
+{
+	std::size_t bytes = mem_unordered_map(map);
+	for(const auto& [ key, val ] : map)
+		bytes += mem_string(key) + mem_string(val);
+	return bytes;
+}
+
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * growing array, optionally backed by a memory-mapped file
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_MMAP_VECTOR_H__
+#define __TRACKS_MMAP_VECTOR_H__
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+#include <cstddef>
+#include <filesystem>
+#include <system_error>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+
+
+/**
+ * array of trivially copyable elements which are either kept in memory
+ * or in a scratch file that is mapped into memory, letting the operating
+ * system page them out instead of running out of memory
+ */
+template<class t_val>
+requires std::is_trivially_copyable_v<t_val>
+class MmapVector
+{
+public:
+	MmapVector() = default;
+
+	~MmapVector()
+	{
+		Clear();
+	}
+
+	MmapVector(const MmapVector&) = delete;
+	MmapVector& operator=(const MmapVector&) = delete;
+
+
+
+	/**
+	 * store the elements in the given scratch file, which is removed again
+	 * when the array is cleared, an empty name keeps them in memory
+	 */
+	void SetFile(const std::string& filename)
+	{
+		Clear();
+		m_filename = filename;
+	}
+
+
+
+	bool IsFileBacked() const
+	{
+		return m_filename != "";
+	}
+
+
+
+	void push_back(const t_val& val)
+	{
+		if(!IsFileBacked())
+		{
+			m_mem.push_back(val);
+			return;
+		}
+
+		if(m_size == m_capacity)
+			Grow(std::max<std::size_t>(m_capacity * 2, MIN_FILE_ELEMS));
+
+		m_data[m_size++] = val;
+	}
+
+
+
+	std::size_t size() const
+	{
+		return IsFileBacked() ? m_size : m_mem.size();
+	}
+
+
+
+	const t_val* data() const
+	{
+		return IsFileBacked() ? m_data : m_mem.data();
+	}
+
+
+
+	t_val* data()
+	{
+		return IsFileBacked() ? m_data : m_mem.data();
+	}
+
+
+
+	const t_val& operator[](std::size_t idx) const { return data()[idx]; }
+	t_val& operator[](std::size_t idx) { return data()[idx]; }
+
+	const t_val* begin() const { return data(); }
+	const t_val* end() const { return data() + size(); }
+
+
+
+	/**
+	 * remove all elements and the scratch file
+	 */
+	void Clear()
+	{
+		m_mem.clear();
+		m_mem.shrink_to_fit();
+
+		m_region = boost::interprocess::mapped_region{};
+		m_data = nullptr;
+		m_size = m_capacity = 0;
+
+		if(IsFileBacked())
+		{
+			std::error_code err;
+			std::filesystem::remove(m_filename, err);
+		}
+	}
+
+
+
+	/**
+	 * heap memory, the mapped file is not counted
+	 */
+	std::size_t GetMemory() const
+	{
+		return m_mem.capacity() * sizeof(t_val);
+	}
+
+
+
+protected:
+	/**
+	 * enlarge the scratch file and map it again
+	 */
+	void Grow(std::size_t capacity)
+	{
+		namespace ipr = boost::interprocess;
+
+		m_region = ipr::mapped_region{};
+		m_data = nullptr;
+
+		if(!m_capacity)
+		{
+			std::ofstream ofstr(m_filename, std::ios_base::binary | std::ios_base::trunc);
+			if(!ofstr)
+				throw std::runtime_error("Cannot create \"" + m_filename + "\".");
+		}
+
+		std::filesystem::resize_file(m_filename, capacity * sizeof(t_val));
+
+		ipr::file_mapping file{m_filename.c_str(), ipr::read_write};
+		m_region = ipr::mapped_region{file, ipr::read_write};
+		m_data = static_cast<t_val*>(m_region.get_address());
+		m_capacity = capacity;
+	}
+
+
+
+private:
+	// minimum number of elements in the scratch file
+	static constexpr std::size_t MIN_FILE_ELEMS =
+		std::max<std::size_t>((std::size_t(1) << 20) / sizeof(t_val), 1);
+
+	std::vector<t_val> m_mem{};
+
+	std::string m_filename{};
+	boost::interprocess::mapped_region m_region{};
+	t_val *m_data{};
+	std::size_t m_size{}, m_capacity{};
+};
+
+
+#endif
@@ -0,0 +1,563 @@
+/**
+ * lightweight timing and counter instrumentation
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_PROFILE_H__
+#define __TRACKS_PROFILE_H__
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <cstdint>
+
+
+
+/**
+ * collects the timings and counters of the instrumented program stages
+ *
+ * Every thread records into its own table, so recording does not contend
+ * between threads. The tables are merged when the results are requested.
+ * Nothing is recorded while the profiler is disabled.
+ *
+ * With tracing enabled, every timed scope is additionally stored as an event
+ * with its thread, which can be written as a Chrome/Perfetto trace. At most
+ * MAX_TRACE_EVENTS events are kept, later ones are only counted.
+ *
+ * The table of a finished thread is merged into a common one, so that short-lived
+ * pool threads do not accumulate.
+ */
+class Profiler
+{
+public:
+	using t_clk = std::chrono::steady_clock;
+	using t_real = double;
+
+	static constexpr std::size_t MAX_TRACE_EVENTS = 1 << 20;
+
+	/**
+	 * timing and counter values of one stage
+	 */
+	struct Entry
+	{
+		std::string name{};
+
+		std::uint64_t calls{};    // number of timed calls
+		t_real total{};           // total time [s]
+		t_real min{std::numeric_limits<t_real>::max()};
+		t_real max{};
+
+		std::uint64_t count{};    // sum of the counter
+	};
+
+
+
+	/**
+	 * a timed scope on one thread
+	 */
+	struct TraceEvent
+	{
+		const char *name{};
+		std::int64_t start{};     // [us] since the start of tracing
+		std::int64_t duration{};  // [us]
+
+		// optional argument, e.g. the processed file
+		const char *arg_key{};
+		std::string arg_val{};
+	};
+
+
+
+public:
+	Profiler() = delete;
+
+
+
+	static bool IsEnabled()
+	{
+		return s_enabled.load(std::memory_order_relaxed);
+	}
+
+
+
+	static void SetEnabled(bool enabled)
+	{
+		s_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+
+
+	static bool IsTracing()
+	{
+		return s_tracing.load(std::memory_order_relaxed);
+	}
+
+
+
+	/**
+	 * record the timed scopes as trace events,
+	 * this also enables the profiler
+	 */
+	static void SetTracing(bool tracing)
+	{
+		if(tracing)
+		{
+			s_trace_start.store(t_clk::now().time_since_epoch().count(), std::memory_order_relaxed);
+			SetEnabled(true);
+		}
+
+		s_tracing.store(tracing, std::memory_order_relaxed);
+	}
+
+
+
+	/**
+	 * record the duration of a stage
+	 * @param name stage name, has to be a string literal
+	 */
+	static void AddTime(const char *name, t_real secs)
+	{
+		ThreadData& data = GetThreadData();
+		std::lock_guard<std::mutex> _lck{data.mtx};
+
+		Entry& entry = data.entries[name];
+		++entry.calls;
+		entry.total += secs;
+		entry.min = std::min(entry.min, secs);
+		entry.max = std::max(entry.max, secs);
+	}
+
+
+
+	/**
+	 * record a trace event
+	 * @param name stage name, has to be a string literal
+	 */
+	static void AddTraceEvent(const char *name, const t_clk::time_point& start, const t_clk::time_point& stop,
+		const char *arg_key = nullptr, std::string&& arg_val = "")
+	{
+		using namespace std::chrono;
+		const t_clk::time_point trace_start{t_clk::duration{s_trace_start.load(std::memory_order_relaxed)}};
+
+		if(s_num_events.fetch_add(1, std::memory_order_relaxed) >= MAX_TRACE_EVENTS)
+		{
+			s_dropped_events.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		ThreadData& data = GetThreadData();
+		std::lock_guard<std::mutex> _lck{data.mtx};
+
+		data.events.emplace_back(TraceEvent
+		{
+			.name = name,
+			.start = duration_cast<microseconds>(start - trace_start).count(),
+			.duration = duration_cast<microseconds>(stop - start).count(),
+			.arg_key = arg_key,
+			.arg_val = std::move(arg_val),
+		});
+	}
+
+
+
+	/**
+	 * increment a counter
+	 * @param name counter name, has to be a string literal
+	 */
+	static void AddCount(const char *name, std::uint64_t count)
+	{
+		ThreadData& data = GetThreadData();
+		std::lock_guard<std::mutex> _lck{data.mtx};
+
+		data.entries[name].count += count;
+	}
+
+
+
+	/**
+	 * merge the values of all threads, sorted by total time
+	 */
+	static std::vector<Entry> GetResults()
+	{
+		std::unordered_map<std::string_view, Entry> merged;
+
+		{
+			std::lock_guard<std::mutex> _lck{s_threads_mtx};
+			MergeEntries(merged, s_finished_entries);
+			for(const auto& data : s_threads)
+			{
+				std::lock_guard<std::mutex> _lck_data{data->mtx};
+				MergeEntries(merged, data->entries);
+			}
+		}
+
+		std::vector<Entry> results;
+		results.reserve(merged.size());
+		for(auto& [ name, entry ] : merged)
+		{
+			entry.name = name;
+			if(!entry.calls)
+				entry.min = 0.;
+			results.emplace_back(std::move(entry));
+		}
+
+		std::stable_sort(results.begin(), results.end(), [](const Entry& entry1, const Entry& entry2) -> bool
+		{
+			if(entry1.total != entry2.total)
+				return entry1.total > entry2.total;
+			return entry1.name < entry2.name;
+		});
+
+		return results;
+	}
+
+
+
+	/**
+	 * clear the values of all threads
+	 */
+	static void Reset()
+	{
+		std::lock_guard<std::mutex> _lck{s_threads_mtx};
+		for(const auto& data : s_threads)
+		{
+			std::lock_guard<std::mutex> _lck_data{data->mtx};
+			data->entries.clear();
+			data->events.clear();
+		}
+
+		// finished threads were only kept for their events
+		std::erase_if(s_threads, [](const std::shared_ptr<ThreadData>& data) -> bool
+		{
+			return data->finished;
+		});
+		s_finished_entries.clear();
+		s_num_events.store(0, std::memory_order_relaxed);
+		s_dropped_events.store(0, std::memory_order_relaxed);
+
+		if(IsTracing())
+			s_trace_start.store(t_clk::now().time_since_epoch().count(), std::memory_order_relaxed);
+	}
+
+
+
+	/**
+	 * print the results as a table
+	 */
+	static void Print(std::ostream& ostr)
+	{
+		const std::vector<Entry> results = GetResults();
+
+		const int w_name = 40, w_val = 14;
+		std::ios_base::fmtflags flags = ostr.flags();
+		std::streamsize prec = ostr.precision();
+
+		ostr << std::left << std::setw(w_name) << "Stage"
+			<< std::right << std::setw(w_val) << "Calls"
+			<< std::setw(w_val) << "Total [ms]"
+			<< std::setw(w_val) << "Mean [ms]"
+			<< std::setw(w_val) << "Min [ms]"
+			<< std::setw(w_val) << "Max [ms]"
+			<< std::setw(w_val) << "Count" << "\n";
+
+		ostr << std::fixed << std::setprecision(3);
+		for(const Entry& entry : results)
+		{
+			ostr << std::left << std::setw(w_name) << entry.name
+				<< std::right << std::setw(w_val) << entry.calls
+				<< std::setw(w_val) << entry.total * 1000.
+				<< std::setw(w_val) << (entry.calls ? entry.total / t_real(entry.calls) * 1000. : 0.)
+				<< std::setw(w_val) << entry.min * 1000.
+				<< std::setw(w_val) << entry.max * 1000.
+				<< std::setw(w_val) << entry.count << "\n";
+		}
+
+		ostr.flush();
+		ostr.flags(flags);
+		ostr.precision(prec);
+	}
+
+
+
+	/**
+	 * write the trace events of all threads in the chrome trace event format,
+	 * which can be viewed in chrome://tracing or https://ui.perfetto.dev
+	 * @see https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+	 */
+	static bool WriteTrace(std::ostream& ostr)
+	{
+		std::lock_guard<std::mutex> _lck{s_threads_mtx};
+		bool first = true;
+
+		ostr << "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [";
+
+		for(const auto& data : s_threads)
+		{
+			std::lock_guard<std::mutex> _lck_data{data->mtx};
+			if(data->events.size() == 0)
+				continue;
+
+			// thread name
+			ostr << (first ? "\n" : ",\n")
+				<< "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << data->id
+				<< ", \"args\": {\"name\": \"thread " << data->id << "\"}}";
+			first = false;
+
+			for(const TraceEvent& evt : data->events)
+			{
+				ostr << ",\n{\"name\": \"" << EscapeJson(evt.name)
+					<< "\", \"cat\": \"tracks\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << data->id
+					<< ", \"ts\": " << evt.start << ", \"dur\": " << evt.duration;
+				if(evt.arg_key)
+				{
+					ostr << ", \"args\": {\"" << EscapeJson(evt.arg_key)
+						<< "\": \"" << EscapeJson(evt.arg_val) << "\"}";
+				}
+				ostr << "}";
+			}
+		}
+
+		ostr << "\n]";
+		if(const std::size_t dropped = s_dropped_events.load(std::memory_order_relaxed); dropped)
+			ostr << ",\n\"metadata\": {\"dropped_events\": " << dropped << "}";
+		ostr << "\n}" << std::endl;
+		return static_cast<bool>(ostr);
+	}
+
+
+
+	static bool WriteTrace(const std::string& filename)
+	{
+		std::ofstream ofstr{filename};
+		if(!ofstr)
+			return false;
+
+		return WriteTrace(ofstr);
+	}
+
+
+
+protected:
+	/**
+	 * values recorded by one thread
+	 */
+	struct ThreadData
+	{
+		std::size_t id{};
+		bool finished{false};
+		std::mutex mtx{};
+		std::unordered_map<std::string_view, Entry> entries{};
+		std::vector<TraceEvent> events{};
+	};
+
+
+
+	/**
+	 * registers the table of the current thread and hands it over when the thread ends
+	 */
+	struct ThreadHandle
+	{
+		std::shared_ptr<ThreadData> data{};
+
+		ThreadHandle()
+			: data{std::make_shared<ThreadData>()}
+		{
+			std::lock_guard<std::mutex> _lck{s_threads_mtx};
+			data->id = s_next_thread_id++;
+			s_threads.push_back(data);
+		}
+
+		~ThreadHandle()
+		{
+			FinishThread(data);
+		}
+
+		ThreadHandle(const ThreadHandle&) = delete;
+		ThreadHandle& operator=(const ThreadHandle&) = delete;
+	};
+
+
+
+	static void MergeEntries(std::unordered_map<std::string_view, Entry>& merged,
+		const std::unordered_map<std::string_view, Entry>& entries)
+	{
+		for(const auto& [ name, entry ] : entries)
+		{
+			Entry& merged_entry = merged[name];
+			merged_entry.calls += entry.calls;
+			merged_entry.total += entry.total;
+			merged_entry.min = std::min(merged_entry.min, entry.min);
+			merged_entry.max = std::max(merged_entry.max, entry.max);
+			merged_entry.count += entry.count;
+		}
+	}
+
+
+
+	/**
+	 * merge the values of a finished thread into the common table,
+	 * its table is only kept if it has trace events
+	 */
+	static void FinishThread(const std::shared_ptr<ThreadData>& data)
+	{
+		std::lock_guard<std::mutex> _lck{s_threads_mtx};
+		std::lock_guard<std::mutex> _lck_data{data->mtx};
+
+		MergeEntries(s_finished_entries, data->entries);
+		data->entries.clear();
+		data->finished = true;
+
+		if(data->events.size() == 0)
+			std::erase(s_threads, data);
+	}
+
+
+
+	static std::string EscapeJson(std::string_view str)
+	{
+		std::string escaped;
+		escaped.reserve(str.size());
+
+		for(char c : str)
+		{
+			if(c == '"' || c == '\\')
+			{
+				escaped += '\\';
+				escaped += c;
+			}
+			else if(static_cast<unsigned char>(c) < 0x20)
+			{
+				std::ostringstream ostr;
+				ostr << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c);
+				escaped += ostr.str();
+			}
+			else
+			{
+				escaped += c;
+			}
+		}
+
+		return escaped;
+	}
+
+
+
+	/**
+	 * get the table of the current thread
+	 */
+	static ThreadData& GetThreadData()
+	{
+		thread_local ThreadHandle handle{};
+		return *handle.data;
+	}
+
+
+
+private:
+	static inline std::atomic<bool> s_enabled{false};
+	static inline std::atomic<bool> s_tracing{false};
+	static inline std::atomic<t_clk::rep> s_trace_start{};
+
+	static inline std::atomic<std::size_t> s_num_events{};
+	static inline std::atomic<std::size_t> s_dropped_events{};
+
+	static inline std::mutex s_threads_mtx{};
+	static inline std::vector<std::shared_ptr<ThreadData>> s_threads{};
+	static inline std::unordered_map<std::string_view, Entry> s_finished_entries{};
+	static inline std::size_t s_next_thread_id{};
+};
+
+
+
+/**
+ * measures the time until it goes out of scope
+ */
+class ProfileTimer
+{
+public:
+	/**
+	 * @param name stage name, has to be a string literal
+	 */
+	explicit ProfileTimer(const char *name)
+		: m_name{Profiler::IsEnabled() ? name : nullptr}
+	{
+		if(m_name)
+			m_start = Profiler::t_clk::now();
+	}
+
+
+
+	~ProfileTimer()
+	{
+		if(!m_name)
+			return;
+
+		const Profiler::t_clk::time_point stop = Profiler::t_clk::now();
+		Profiler::AddTime(m_name, std::chrono::duration<Profiler::t_real>(stop - m_start).count());
+
+		if(Profiler::IsTracing())
+			Profiler::AddTraceEvent(m_name, m_start, stop, m_arg_key, std::move(m_arg_val));
+	}
+
+
+
+	/**
+	 * attach an argument to the trace event, ignored if not tracing
+	 * @param key argument name, has to be a string literal
+	 */
+	void SetArgument(const char *key, const std::string& val)
+	{
+		if(!m_name || !Profiler::IsTracing())
+			return;
+
+		m_arg_key = key;
+		m_arg_val = val;
+	}
+
+
+
+	ProfileTimer(const ProfileTimer&) = delete;
+	ProfileTimer& operator=(const ProfileTimer&) = delete;
+
+
+
+private:
+	const char *m_name{};
+	Profiler::t_clk::time_point m_start{};
+
+	const char *m_arg_key{};
+	std::string m_arg_val{};
+};
+
+
+
+#define __TRACKS_PROFILE_CAT2(a, b) a ## b
+#define __TRACKS_PROFILE_CAT(a, b) __TRACKS_PROFILE_CAT2(a, b)
+
+/**
+ * time the rest of the current scope
+ */
+#define TRACKS_PROFILE_SCOPE(name) \
+	ProfileTimer __TRACKS_PROFILE_CAT(__profile_timer_, __LINE__){name}
+
+/**
+ * increment a counter
+ */
+#define TRACKS_PROFILE_COUNT(name, count) \
+	do { if(Profiler::IsEnabled()) Profiler::AddCount(name, count); } while(0)
+
+
+#endif
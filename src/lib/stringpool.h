@@ -0,0 +1,139 @@
+/**
+ * pool of interned strings
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_STRING_POOL_H__
+#define __TRACKS_STRING_POOL_H__
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <optional>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include "memory.h"
+
+
+
+/**
+ * stores every distinct string only once and refers to it by a sequential id
+ */
+template<class t_id = std::uint32_t>
+requires std::integral<t_id>
+class StringPool
+{
+public:
+	StringPool() = default;
+	~StringPool() = default;
+
+
+
+	StringPool(const StringPool& other)
+	{
+		operator=(other);
+	}
+
+
+
+	StringPool& operator=(const StringPool& other)
+	{
+		if(this == &other)
+			return *this;
+
+		// the index refers to the strings of this pool, so rebuild it
+		m_strings = other.m_strings;
+		m_ids.clear();
+		m_ids.reserve(m_strings.size());
+		for(std::size_t idx = 0; idx < m_strings.size(); ++idx)
+			m_ids.emplace(std::make_pair(std::string_view{m_strings[idx]}, static_cast<t_id>(idx)));
+
+		return *this;
+	}
+
+
+
+	// the deque keeps its elements in place, so the index stays valid
+	StringPool(StringPool&&) = default;
+	StringPool& operator=(StringPool&&) = default;
+
+
+
+	/**
+	 * get the id of a string, adding it to the pool if it is not yet known
+	 */
+	t_id Intern(std::string_view str)
+	{
+		if(auto iter = m_ids.find(str); iter != m_ids.end())
+			return iter->second;
+
+		const t_id id = static_cast<t_id>(m_strings.size());
+		m_strings.emplace_back(str);
+		m_ids.emplace(std::make_pair(std::string_view{m_strings.back()}, id));
+
+		return id;
+	}
+
+
+
+	/**
+	 * get the id of a string if it is in the pool
+	 */
+	std::optional<t_id> Find(std::string_view str) const
+	{
+		if(auto iter = m_ids.find(str); iter != m_ids.end())
+			return iter->second;
+		return std::nullopt;
+	}
+
+
+
+	const std::string& Get(t_id id) const
+	{
+		return m_strings[id];
+	}
+
+
+
+	std::size_t size() const
+	{
+		return m_strings.size();
+	}
+
+
+
+	void Clear()
+	{
+		m_ids.clear();
+		m_strings.clear();
+	}
+
+
+
+	/**
+	 * heap memory of the strings and the index
+	 */
+	std::size_t GetMemory() const
+	{
+		std::size_t bytes = m_strings.size() * sizeof(std::string)
+			+ mem_unordered_map(m_ids);
+		for(const std::string& str : m_strings)
+			bytes += mem_string(str);
+
+		return bytes;
+	}
+
+
+
+private:
+	std::deque<std::string> m_strings{};
+	std::unordered_map<std::string_view, t_id> m_ids{};
+};
+
+
+#endif
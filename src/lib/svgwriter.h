@@ -0,0 +1,323 @@
+/**
+ * streaming svg writer
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACKS_SVG_WRITER_H__
+#define __TRACKS_SVG_WRITER_H__
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <concepts>
+
+
+
+/**
+ * writes svg elements directly into a text buffer
+ *
+ * Coordinates are projected linearly onto the image with the y axis pointing
+ * down and written with a precision of a tenth of a pixel, repeated points
+ * are skipped. Styles are written once as css classes, which are put
+ * in front of the elements when the image is finished.
+ */
+template<class t_real = double>
+requires std::floating_point<t_real>
+class SvgWriter
+{
+public:
+	using t_style = std::uint32_t;
+
+
+
+public:
+	/**
+	 * the buffer is reused, so that its memory is kept between images
+	 */
+	SvgWriter(std::string& buffer)
+		: m_buffer{buffer}
+	{}
+
+	~SvgWriter() = default;
+
+	SvgWriter(const SvgWriter&) = delete;
+	SvgWriter& operator=(const SvgWriter&) = delete;
+
+
+
+	/**
+	 * start a new image mapping the given coordinate bounds onto its pixels
+	 */
+	void Begin(t_real width, t_real height,
+		t_real min_x, t_real max_x, t_real min_y, t_real max_y)
+	{
+		m_buffer.clear();
+		m_styles.clear();
+		m_style_defs.clear();
+
+		m_width = width;
+		m_height = height;
+
+		m_scale_x = max_x > min_x ? double(width) / double(max_x - min_x) : 1.;
+		m_scale_y = max_y > min_y ? double(height) / double(max_y - min_y) : 1.;
+		m_offs_x = -double(min_x) * m_scale_x;
+		m_offs_y = double(max_y) * m_scale_y;
+	}
+
+
+
+	/**
+	 * get the css class of a style, adding it if it is new
+	 */
+	t_style AddStyle(std::string_view style)
+	{
+		if(auto iter = m_styles.find(std::string{style}); iter != m_styles.end())
+			return iter->second;
+
+		const t_style id = static_cast<t_style>(m_styles.size());
+		m_styles.emplace(std::string{style}, id);
+
+		m_style_defs += ".s";
+		AppendInt(m_style_defs, id);
+		m_style_defs += "{";
+		m_style_defs += style;
+		m_style_defs += "}\n";
+
+		return id;
+	}
+
+
+
+	/**
+	 * start a closed path, followed by calls to AddPoint and EndPath
+	 */
+	void BeginPath(t_style style)
+	{
+		BeginElement("<path", style, " d=\"M");
+	}
+
+
+
+	/**
+	 * finish the path, it is left out if no points have been added
+	 */
+	void EndPath()
+	{
+		if(!m_num_points)
+			m_buffer.resize(m_element_begin);
+		else
+			m_buffer += "Z\"/>\n";
+	}
+
+
+
+	/**
+	 * start an open line, followed by calls to AddPoint and EndPolyline
+	 */
+	void BeginPolyline(t_style style)
+	{
+		BeginElement("<polyline", style, " points=\"");
+	}
+
+
+
+	/**
+	 * finish the line, it is left out if no points have been added
+	 */
+	void EndPolyline()
+	{
+		if(!m_num_points)
+			m_buffer.resize(m_element_begin);
+		else
+			m_buffer += "\"/>\n";
+	}
+
+
+
+	/**
+	 * add a point to the current path or line, skipping repeated points
+	 */
+	void AddPoint(t_real x, t_real y)
+	{
+		auto [ px, py ] = Project(x, y);
+
+		if(m_num_points && px == m_last_x && py == m_last_y)
+			return;
+
+		if(m_num_points)
+			m_buffer += ' ';
+		AppendCoord(m_buffer, px);
+		m_buffer += ',';
+		AppendCoord(m_buffer, py);
+
+		m_last_x = px;
+		m_last_y = py;
+		++m_num_points;
+	}
+
+
+
+	/**
+	 * add a circle with a radius in pixels
+	 */
+	void Circle(t_real x, t_real y, t_real rad, t_style style)
+	{
+		auto [ px, py ] = Project(x, y);
+
+		BeginElement("<circle", style, " cx=\"");
+		AppendCoord(m_buffer, px);
+		m_buffer += "\" cy=\"";
+		AppendCoord(m_buffer, py);
+		m_buffer += "\" r=\"";
+		AppendCoord(m_buffer, ToDeciPixels(rad));
+		m_buffer += "\"/>\n";
+	}
+
+
+
+	void Text(t_real x, t_real y, std::string_view text, t_style style)
+	{
+		auto [ px, py ] = Project(x, y);
+
+		BeginElement("<text", style, " x=\"");
+		AppendCoord(m_buffer, px);
+		m_buffer += "\" y=\"";
+		AppendCoord(m_buffer, py);
+		m_buffer += "\">";
+		AppendEscaped(m_buffer, text);
+		m_buffer += "</text>\n";
+	}
+
+
+
+	/**
+	 * complete the image by putting the header and the styles in front of the elements
+	 */
+	void End()
+	{
+		std::string header = "<?xml version=\"1.0\" standalone=\"no\"?>\n<svg width=\"";
+		AppendCoord(header, ToDeciPixels(m_width));
+		header += "px\" height=\"";
+		AppendCoord(header, ToDeciPixels(m_height));
+		header += "px\" version=\"1.1\"\nxmlns=\"http://www.w3.org/2000/svg\">\n";
+
+		if(m_style_defs.size())
+		{
+			header += "<style type=\"text/css\">\n";
+			header += m_style_defs;
+			header += "</style>\n";
+		}
+
+		m_buffer.insert(0, header);
+		m_buffer += "</svg>\n";
+	}
+
+
+
+protected:
+	void BeginElement(std::string_view tag, t_style style, std::string_view attr)
+	{
+		m_element_begin = m_buffer.size();
+
+		m_buffer += tag;
+		m_buffer += " class=\"s";
+		AppendInt(m_buffer, style);
+		m_buffer += '\"';
+		m_buffer += attr;
+
+		m_num_points = 0;
+	}
+
+
+
+	/**
+	 * project a point onto integer tenths of pixels
+	 */
+	std::pair<std::int64_t, std::int64_t> Project(t_real x, t_real y) const
+	{
+		return std::make_pair(
+			static_cast<std::int64_t>(std::llround((double(x) * m_scale_x + m_offs_x) * 10.)),
+			static_cast<std::int64_t>(std::llround((m_offs_y - double(y) * m_scale_y) * 10.)));
+	}
+
+
+
+	static std::int64_t ToDeciPixels(t_real val)
+	{
+		return static_cast<std::int64_t>(std::llround(double(val) * 10.));
+	}
+
+
+
+	static void AppendInt(std::string& str, std::int64_t val)
+	{
+		char buf[24];
+		auto [ end, err ] = std::to_chars(buf, buf + sizeof(buf), val);
+		str.append(buf, end);
+	}
+
+
+
+	/**
+	 * write tenths of pixels as a decimal number
+	 */
+	static void AppendCoord(std::string& str, std::int64_t val)
+	{
+		if(val < 0)
+		{
+			str += '-';
+			val = -val;
+		}
+
+		AppendInt(str, val / 10);
+		if(const std::int64_t frac = val % 10; frac)
+		{
+			str += '.';
+			str += static_cast<char>('0' + frac);
+		}
+	}
+
+
+
+	static void AppendEscaped(std::string& str, std::string_view text)
+	{
+		for(const char c : text)
+		{
+			switch(c)
+			{
+				case '&': str += "&amp;"; break;
+				case '<': str += "&lt;"; break;
+				case '>': str += "&gt;"; break;
+				case '\"': str += "&quot;"; break;
+				default: str += c; break;
+			}
+		}
+	}
+
+
+
+private:
+	std::string& m_buffer;
+
+	// css classes
+	std::unordered_map<std::string, t_style> m_styles{};
+	std::string m_style_defs{};
+
+	// projection onto the image
+	t_real m_width{}, m_height{};
+	double m_scale_x{1.}, m_scale_y{1.};
+	double m_offs_x{}, m_offs_y{};
+
+	// start in the buffer and last point of the current path or line
+	std::size_t m_element_begin{};
+	std::int64_t m_last_x{}, m_last_y{};
+	std::size_t m_num_points{};
+};
+
+
+#endif
@@ -98,6 +98,30 @@ std::string from_timepoint(const t_timept& time_pt,
 
 
 
+/**
+ * converts a time point to an UTC time string
+ */
+template<class t_clk, class t_timept = typename t_clk::time_point>
+std::string from_timepoint_utc(const t_timept& time_pt)
+{
+	std::tm t{};
+	std::time_t tt = t_clk::to_time_t(time_pt);
+	boost::date_time::c_time::gmtime(&tt, &t);
+
+	std::ostringstream ostr;
+	ostr
+		<< std::setw(4) << std::setfill('0') << (t.tm_year + 1900) << "-"
+		<< std::setw(2) << std::setfill('0') << (t.tm_mon + 1) << "-"
+		<< std::setw(2) << std::setfill('0') << t.tm_mday << "T"
+		<< std::setw(2) << std::setfill('0') << t.tm_hour << ":"
+		<< std::setw(2) << std::setfill('0') << t.tm_min << ":"
+		<< std::setw(2) << std::setfill('0') << t.tm_sec << "Z";
+
+	return ostr.str();
+}
+
+
+
 /**
  * rounds a time point to months
  */
@@ -32,6 +32,8 @@
 
 #include "calc.h"
 #include "timepoint.h"
+#include "profile.h"
+#include "memory.h"
 
 
 
@@ -57,6 +59,48 @@ struct TrackPoint
 
 
 
+/**
+ * fixed-size summary of a track's values
+ */
+template<class t_real = double, class t_size = std::size_t>
+requires std::floating_point<t_real> && std::integral<t_size>
+struct TrackSummary
+{
+	t_size num_points{};
+	t_size hash{};
+
+	t_real start_time{};             // seconds since epoch of the first point [s]
+	t_real end_time{};               // seconds since epoch of the last point [s]
+	t_real total_time{};             // [s]
+
+	t_real distance{};               // [m]
+	t_real distance_planar{};        // [m]
+
+	t_real ascent{}, descent{};      // [m]
+
+	t_real min_lat{}, max_lat{};     // [rad]
+	t_real min_lon{}, max_lon{};     // [rad]
+	t_real min_elev{}, max_elev{};   // [m]
+};
+
+
+
+/**
+ * settings which the calculated track values depend on
+ */
+template<class t_real = double, class t_size = std::size_t>
+requires std::floating_point<t_real> && std::integral<t_size>
+struct TrackCalcSettings
+{
+	int distance_function{};
+	t_real asc_eps{};                // [m]
+	t_size smooth_rad{};
+
+	bool operator==(const TrackCalcSettings&) const = default;
+};
+
+
+
 /**
  * represents a single running track
  */
@@ -71,8 +115,16 @@ public:
 	using t_dur = typename t_clk::duration;
 	using t_sec = std::chrono::duration<t_real, std::ratio<1, 1>>;
 	using t_trackpt = TrackPoint<t_timept, t_real>;
+	using t_summary = TrackSummary<t_real, t_size>;
+	using t_calc_settings = TrackCalcSettings<t_real, t_size>;
 	using t_char = typename std::string::value_type;
 
+	// calculation stages and the settings they depend on
+	static constexpr unsigned int CALC_NONE = 0;
+	static constexpr unsigned int CALC_DISTANCES = 1 << 0;  // distance function
+	static constexpr unsigned int CALC_CLIMBS = 1 << 1;     // smoothing radius and ascent epsilon
+	static constexpr unsigned int CALC_ALL = CALC_DISTANCES | CALC_CLIMBS;
+
 
 
 public:
@@ -112,102 +164,83 @@ public:
 
 	/**
 	 * calculate track properties
+	 * @param only_dirty only recalculate the values depending on changed settings
 	 */
-	void Calculate()
+	void Calculate(bool only_dirty = false)
 	{
-		// clear old values
-		m_total_dist = 0.;
-		m_total_dist_planar = 0.;
-		m_total_time = 0.;
-		m_ascent = 0.;
-		m_descent = 0.;
+		TRACKS_PROFILE_SCOPE("SingleTrack::Calculate");
 
-		// reset ranges
-		m_min_elev = std::numeric_limits<t_real>::max();
-		m_max_elev = -m_min_elev;
-		m_min_lat = std::numeric_limits<t_real>::max();
-		m_max_lat = -m_min_lat;
-		m_min_long = std::numeric_limits<t_real>::max();
-		m_max_long = -m_min_long;
+		if(!only_dirty)
+			m_dirty = CALC_ALL;
 
-		std::optional<t_real> latitude_last, longitude_last, elevation_last;
-		std::optional<t_timept> time_pt_last;
+		if(m_dirty & CALC_DISTANCES)
+			CalculateDistances();
+		if(m_dirty & CALC_CLIMBS)
+			CalculateClimbs();
 
-		// distance function
-		std::tuple<t_real, t_real> (*dist_func)(t_real lat1, t_real lat2,
-			t_real lon1, t_real lon2,
-			t_real elev1, t_real elev2) = GetDistanceFunction();
+		m_dirty = CALC_NONE;
+	}
 
-		std::vector<t_real> elevations;
-		elevations.reserve(m_points.size());
 
-		for(t_trackpt& trackpt : m_points)
-		{
-			elevations.push_back(trackpt.elevation);
 
-			// elapsed seconds since last track point
-			if(time_pt_last)
-				trackpt.elapsed = t_sec{trackpt.timept - *time_pt_last}.count();
+	/**
+	 * are there values which need to be recalculated due to changed settings?
+	 */
+	bool IsDirty() const
+	{
+		return m_dirty != CALC_NONE;
+	}
 
-			if(latitude_last && longitude_last && elevation_last)
-			{
-				std::tie(trackpt.distance_planar, trackpt.distance)
-					= (*dist_func)(
-					*latitude_last, trackpt.latitude,
-					*longitude_last, trackpt.longitude,
-					*elevation_last, trackpt.elevation);
-			}
 
-			// cumulative values
-			m_total_time += trackpt.elapsed;
-			m_total_dist += trackpt.distance;
-			m_total_dist_planar += trackpt.distance_planar;
 
-			// ranges
-			m_max_lat = std::max(m_max_lat, trackpt.latitude);
-			m_min_lat = std::min(m_min_lat, trackpt.latitude);
-			m_max_long = std::max(m_max_long, trackpt.longitude);
-			m_min_long = std::min(m_min_long, trackpt.longitude);
-			m_max_elev = std::max(m_max_elev, trackpt.elevation);
-			m_min_elev = std::min(m_min_elev, trackpt.elevation);
+	/**
+	 * get the calculation stages which need to be rerun (CALC_* flags)
+	 */
+	unsigned int GetDirtyStages() const
+	{
+		return m_dirty;
+	}
 
-			trackpt.elapsed_total = m_total_time;
-			trackpt.distance_total = m_total_dist;
-			trackpt.distance_planar_total = m_total_dist_planar;
 
-			// save last values
-			latitude_last = trackpt.latitude;
-			longitude_last = trackpt.longitude;
-			elevation_last = trackpt.elevation;
-			time_pt_last = trackpt.timept;
-		}  // loop over track points
 
-		if(m_smooth_rad > 0)
-			elevations = smooth_data(elevations, static_cast<int>(m_smooth_rad));
+	/**
+	 * export the track to a gpx file
+	 * @see https://www.topografix.com/gpx/1/1/
+	 */
+	bool ExportGpx(const std::string& trackfilename) const
+	{
+		std::ofstream ofstr{trackfilename};
+		if(!ofstr)
+			return false;
 
-		// calulate ascent & descent
-		std::optional<t_real> elevation_last_asc;
-		for(t_real elevation : elevations)
+		return ExportGpx(ofstr);
+	}
+
+
+
+	bool ExportGpx(std::ostream& ostr) const
+	{
+		namespace num = std::numbers;
+
+		ostr << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+		ostr << "<gpx version=\"1.1\" creator=\"" << EscapeXml(m_creator) << "\""
+			<< " xmlns=\"http://www.topografix.com/GPX/1/1\">\n";
+		ostr << "<trk>\n<name>" << EscapeXml(m_filename) << "</name>\n<trkseg>\n";
+
+		const auto prec = ostr.precision(9);
+		for(const t_trackpt& pt : m_points)
 		{
-			// ascent and descent
-			if(elevation_last_asc)
-			{
-				t_real elev_diff = elevation - *elevation_last_asc;
-				if(elev_diff > m_asc_eps)
-				{
-					m_ascent += elev_diff;
-					elevation_last_asc = elevation;
-				}
-				else if(elev_diff < -m_asc_eps)
-				{
-					m_descent += -elev_diff;
-					elevation_last_asc = elevation;
-				}
-			}
+			ostr << "<trkpt"
+				<< " lat=\"" << pt.latitude / num::pi_v<t_real> * t_real(180) << "\""
+				<< " lon=\"" << pt.longitude / num::pi_v<t_real> * t_real(180) << "\">"
+				<< "<ele>" << pt.elevation << "</ele>"
+				<< "<time>" << from_timepoint_utc<t_clk, t_timept>(pt.timept) << "</time>"
+				<< "</trkpt>\n";
+		}
 
-			if(!elevation_last_asc)  // only assign at first point
-				elevation_last_asc = elevation;
-		}  // loop over elevations
+		ostr << "</trkseg>\n</trk>\n</gpx>\n";
+		ostr.precision(prec);
+		return !!ostr;
 	}
 
 
@@ -268,6 +301,8 @@ public:
 		namespace num = std::numbers;
 		namespace fs = __gpx_fs;
 
+		TRACKS_PROFILE_SCOPE("SingleTrack::Import");
+
 		fs::path trackfile{trackfilename};
 		if(!fs::exists(trackfile))
 			return false;
@@ -339,6 +374,8 @@ public:
 			}  // segment iteration
 		}  // track iteration
 
+		TRACKS_PROFILE_COUNT("SingleTrack::Import points", m_points.size());
+
 		Calculate();
 		CalculateHash();
 
@@ -354,6 +391,19 @@ public:
 
 
 
+	/**
+	 * set new track points and calculate the track properties
+	 */
+	void SetPoints(std::vector<t_trackpt>&& points)
+	{
+		m_points = std::move(points);
+
+		Calculate();
+		CalculateHash();
+	}
+
+
+
 	/**
 	 * find the track point that is closest to the given coordinates
 	 */
@@ -418,6 +468,13 @@ public:
 
 
 
+	void SetCreator(const std::string& creator)
+	{
+		m_creator = creator;
+	}
+
+
+
 	const std::string& GetVersion() const
 	{
 		return m_version;
@@ -496,8 +553,58 @@ public:
 
 
 
+	/**
+	 * estimate the heap memory used by the track
+	 */
+	MemoryBreakdown MemoryUsage() const
+	{
+		MemoryBreakdown mem;
+		mem.Add("track points", mem_vector(m_points));
+		mem.Add("track strings", mem_string(m_filename)
+			+ mem_string(m_version) + mem_string(m_creator)
+			+ mem_string(m_comment));
+
+		return mem;
+	}
+
+
+
+	/**
+	 * get the track's values in a fixed-size record
+	 */
+	t_summary GetSummary() const
+	{
+		t_summary summary
+		{
+			.num_points = m_points.size(),
+			.hash = m_hash,
+			.total_time = m_total_time,
+			.distance = m_total_dist,
+			.distance_planar = m_total_dist_planar,
+			.ascent = m_ascent, .descent = m_descent,
+			.min_lat = m_min_lat, .max_lat = m_max_lat,
+			.min_lon = m_min_long, .max_lon = m_max_long,
+			.min_elev = m_min_elev, .max_elev = m_max_elev,
+		};
+
+		if(m_points.size())
+		{
+			summary.start_time = std::chrono::duration_cast<t_sec>(
+				m_points.begin()->timept.time_since_epoch()).count();
+			summary.end_time = std::chrono::duration_cast<t_sec>(
+				m_points.rbegin()->timept.time_since_epoch()).count();
+		}
+
+		return summary;
+	}
+
+
+
 	void SetDistanceFunction(int dist_func)
 	{
+		if(m_distance_function != dist_func)
+			m_dirty |= CALC_DISTANCES;
+
 		m_distance_function = dist_func;
 	}
 
@@ -508,6 +615,9 @@ public:
 	 */
 	void SetAscentEpsilon(t_real eps)
 	{
+		if(m_asc_eps != eps)
+			m_dirty |= CALC_CLIMBS;
+
 		m_asc_eps = eps;
 	}
 
@@ -518,11 +628,41 @@ public:
 	 */
 	void SetSmoothRadius(t_size rad)
 	{
+		if(m_smooth_rad != rad)
+			m_dirty |= CALC_CLIMBS;
+
 		m_smooth_rad = rad;
 	}
 
 
 
+	/**
+	 * get the settings which the calculated values depend on
+	 */
+	t_calc_settings GetCalcSettings() const
+	{
+		return t_calc_settings
+		{
+			.distance_function = m_distance_function,
+			.asc_eps = m_asc_eps,
+			.smooth_rad = m_smooth_rad,
+		};
+	}
+
+
+
+	/**
+	 * set the settings which the calculated values depend on
+	 */
+	void SetCalcSettings(const t_calc_settings& settings)
+	{
+		SetDistanceFunction(settings.distance_function);
+		SetAscentEpsilon(settings.asc_eps);
+		SetSmoothRadius(settings.smooth_rad);
+	}
+
+
+
 	bool Save(std::ofstream& ofstr) const
 	{
 		if(!ofstr)
@@ -656,6 +796,12 @@ public:
 			Calculate();
 			CalculateHash();
 		}
+		else
+		{
+			// the stored values are taken to be calculated with the track's
+			// current settings, so these have to be set to the saved ones before
+			m_dirty = CALC_NONE;
+		}
 
 		return true;
 	}
@@ -799,6 +945,117 @@ public:
 
 
 protected:
+	/**
+	 * calculate times, distances and coordinate ranges
+	 */
+	void CalculateDistances()
+	{
+		// clear old values
+		m_total_dist = 0.;
+		m_total_dist_planar = 0.;
+		m_total_time = 0.;
+
+		// reset ranges
+		m_min_elev = std::numeric_limits<t_real>::max();
+		m_max_elev = -m_min_elev;
+		m_min_lat = std::numeric_limits<t_real>::max();
+		m_max_lat = -m_min_lat;
+		m_min_long = std::numeric_limits<t_real>::max();
+		m_max_long = -m_min_long;
+
+		std::optional<t_real> latitude_last, longitude_last, elevation_last;
+		std::optional<t_timept> time_pt_last;
+
+		// distance function
+		std::tuple<t_real, t_real> (*dist_func)(t_real lat1, t_real lat2,
+			t_real lon1, t_real lon2,
+			t_real elev1, t_real elev2) = GetDistanceFunction();
+
+		for(t_trackpt& trackpt : m_points)
+		{
+			// elapsed seconds since last track point
+			if(time_pt_last)
+				trackpt.elapsed = t_sec{trackpt.timept - *time_pt_last}.count();
+
+			if(latitude_last && longitude_last && elevation_last)
+			{
+				std::tie(trackpt.distance_planar, trackpt.distance)
+					= (*dist_func)(
+					*latitude_last, trackpt.latitude,
+					*longitude_last, trackpt.longitude,
+					*elevation_last, trackpt.elevation);
+			}
+
+			// cumulative values
+			m_total_time += trackpt.elapsed;
+			m_total_dist += trackpt.distance;
+			m_total_dist_planar += trackpt.distance_planar;
+
+			// ranges
+			m_max_lat = std::max(m_max_lat, trackpt.latitude);
+			m_min_lat = std::min(m_min_lat, trackpt.latitude);
+			m_max_long = std::max(m_max_long, trackpt.longitude);
+			m_min_long = std::min(m_min_long, trackpt.longitude);
+			m_max_elev = std::max(m_max_elev, trackpt.elevation);
+			m_min_elev = std::min(m_min_elev, trackpt.elevation);
+
+			trackpt.elapsed_total = m_total_time;
+			trackpt.distance_total = m_total_dist;
+			trackpt.distance_planar_total = m_total_dist_planar;
+
+			// save last values
+			latitude_last = trackpt.latitude;
+			longitude_last = trackpt.longitude;
+			elevation_last = trackpt.elevation;
+			time_pt_last = trackpt.timept;
+		}  // loop over track points
+	}
+
+
+
+	/**
+	 * calculate ascent and descent from the smoothed elevations
+	 */
+	void CalculateClimbs()
+	{
+		m_ascent = 0.;
+		m_descent = 0.;
+
+		std::vector<t_real> elevations;
+		elevations.reserve(m_points.size());
+		for(const t_trackpt& trackpt : m_points)
+			elevations.push_back(trackpt.elevation);
+
+		if(m_smooth_rad > 0)
+			elevations = smooth_data(elevations, static_cast<int>(m_smooth_rad));
+
+		// calulate ascent & descent
+		std::optional<t_real> elevation_last_asc;
+		for(t_real elevation : elevations)
+		{
+			// ascent and descent
+			if(elevation_last_asc)
+			{
+				t_real elev_diff = elevation - *elevation_last_asc;
+				if(elev_diff > m_asc_eps)
+				{
+					m_ascent += elev_diff;
+					elevation_last_asc = elevation;
+				}
+				else if(elev_diff < -m_asc_eps)
+				{
+					m_descent += -elev_diff;
+					elevation_last_asc = elevation;
+				}
+			}
+
+			if(!elevation_last_asc)  // only assign at first point
+				elevation_last_asc = elevation;
+		}  // loop over elevations
+	}
+
+
+
 	void CalculateHash()
 	{
 		m_hash = 0;
@@ -819,6 +1076,31 @@ protected:
 
 
 
+	/**
+	 * escape the xml special characters of a text or attribute value
+	 */
+	static std::string EscapeXml(const std::string& str)
+	{
+		std::string escaped;
+		escaped.reserve(str.size());
+
+		for(const char c : str)
+		{
+			switch(c)
+			{
+				case '&': escaped += "&amp;"; break;
+				case '<': escaped += "&lt;"; break;
+				case '>': escaped += "&gt;"; break;
+				case '\"': escaped += "&quot;"; break;
+				default: escaped += c; break;
+			}
+		}
+
+		return escaped;
+	}
+
+
+
 private:
 	std::vector<t_trackpt> m_points{};
 
@@ -841,6 +1123,9 @@ private:
 
 	int m_distance_function{0};
 
+	// calculation stages depending on changed settings
+	unsigned int m_dirty{CALC_ALL};
+
 	t_size m_hash{};
 };
 
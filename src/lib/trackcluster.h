@@ -0,0 +1,442 @@
+/**
+ * grouping of tracks by their routes
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACK_CLUSTER_H__
+#define __TRACK_CLUSTER_H__
+
+#include <vector>
+#include <unordered_map>
+#include <tuple>
+#include <optional>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <algorithm>
+#include <concepts>
+
+#include <boost/asio.hpp>
+
+#include "calc.h"
+
+
+
+/**
+ * groups tracks that follow the same course
+ *
+ * Each track gets a cheap signature (bounding box, length, set of geohash cells
+ * and a resampled shape). Tracks are compared only to the representatives of
+ * existing groups that share geohash cells with them and have similar lengths,
+ * and only these candidates are checked with the discrete Fréchet distance.
+ */
+template<class t_track, class t_real = double, class t_size = std::size_t>
+requires std::floating_point<t_real> && std::integral<t_size>
+class RouteClusters
+{
+public:
+	using t_cell = std::uint64_t;
+	using t_cluster = std::vector<t_size>;
+
+	struct Signature
+	{
+		t_real min_lon{}, max_lon{};
+		t_real min_lat{}, max_lat{};
+		t_real length{};                              // planar track length [m]
+
+		std::vector<t_cell> cells{};                  // sorted geohash cells
+		std::vector<std::pair<t_real, t_real>> shape{};  // resampled [lon, lat] points [rad]
+
+		bool valid{false};
+	};
+
+
+
+public:
+	RouteClusters() = default;
+	~RouteClusters() = default;
+
+
+
+	/**
+	 * maximum discrete Fréchet distance [m] between tracks of the same route
+	 */
+	void SetMaxDistance(t_real dist)
+	{
+		m_max_dist = dist;
+	}
+
+
+
+	/**
+	 * minimum fraction of shared geohash cells for tracks of the same route
+	 */
+	void SetMinOverlap(t_real overlap)
+	{
+		m_min_overlap = overlap;
+	}
+
+
+
+	/**
+	 * maximum ratio between the lengths of tracks of the same route
+	 */
+	void SetMaxLengthRatio(t_real ratio)
+	{
+		m_max_len_ratio = ratio;
+	}
+
+
+
+	/**
+	 * number of bits per coordinate for the geohash cells
+	 */
+	void SetGeohashBits(unsigned int bits)
+	{
+		m_geohash_bits = std::clamp(bits, 1u, 31u);
+	}
+
+
+
+	void SetShapePoints(t_size num)
+	{
+		m_shape_pts = std::max<t_size>(num, 2);
+	}
+
+
+
+	void SetNumThreads(unsigned int num)
+	{
+		m_num_threads = num;
+	}
+
+
+
+	/**
+	 * group the given tracks by their routes
+	 * @return groups of track indices, largest group first
+	 */
+	std::vector<t_cluster> Calculate(const std::vector<const t_track*>& tracks) const
+	{
+		const t_size num_tracks = tracks.size();
+
+		// calculate the signatures in parallel
+		std::vector<Signature> sigs(num_tracks);
+		{
+			boost::asio::thread_pool tp{m_num_threads};
+
+			for(t_size trackidx = 0; trackidx < num_tracks; ++trackidx)
+			{
+				boost::asio::post(tp, [this, &sigs, &tracks, trackidx]() -> void
+				{
+					if(tracks[trackidx])
+						sigs[trackidx] = GetSignature(*tracks[trackidx]);
+				});
+			}
+
+			tp.join();
+		}
+
+		// group representatives and the geohash cells they cover
+		std::vector<t_size> reps;
+		std::vector<t_cluster> clusters;
+		std::unordered_map<t_cell, std::vector<t_size>> cell_reps;
+
+		auto add_rep = [&reps, &clusters, &cell_reps, &sigs](t_size trackidx) -> void
+		{
+			const t_size clusteridx = clusters.size();
+			reps.push_back(trackidx);
+			clusters.emplace_back(t_cluster{ trackidx });
+
+			for(t_cell cell : sigs[trackidx].cells)
+				cell_reps[cell].push_back(clusteridx);
+		};
+
+		// process the tracks in batches, matching each track of a batch against
+		// the existing groups in parallel, then assigning them in order
+		const t_size batch_size = std::max<t_size>(m_num_threads * 64, 1);
+		std::vector<std::optional<t_size>> matched;
+
+		for(t_size batch_start = 0; batch_start < num_tracks; batch_start += batch_size)
+		{
+			const t_size batch_end = std::min(batch_start + batch_size, num_tracks);
+			const t_size num_reps = reps.size();
+
+			matched.clear();
+			matched.resize(batch_end - batch_start);
+
+			boost::asio::thread_pool tp{m_num_threads};
+			for(t_size trackidx = batch_start; trackidx < batch_end; ++trackidx)
+			{
+				boost::asio::post(tp, [this, &sigs, &reps, &cell_reps, &matched,
+					trackidx, batch_start, num_reps]() -> void
+				{
+					if(!sigs[trackidx].valid)
+						return;
+
+					matched[trackidx - batch_start] = FindCluster(
+						sigs, reps, cell_reps, trackidx, num_reps);
+				});
+			}
+			tp.join();
+
+			for(t_size trackidx = batch_start; trackidx < batch_end; ++trackidx)
+			{
+				if(!sigs[trackidx].valid)
+					continue;
+
+				std::optional<t_size> clusteridx = matched[trackidx - batch_start];
+
+				// also try the groups that were created within this batch
+				if(!clusteridx && reps.size() > num_reps)
+				{
+					clusteridx = FindCluster(sigs, reps, cell_reps,
+						trackidx, reps.size(), num_reps);
+				}
+
+				if(clusteridx)
+					clusters[*clusteridx].push_back(trackidx);
+				else
+					add_rep(trackidx);
+			}
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(),
+			[](const t_cluster& cluster1, const t_cluster& cluster2) -> bool
+		{
+			return cluster1.size() > cluster2.size();
+		});
+
+		return clusters;
+	}
+
+
+
+	/**
+	 * calculate the signature of a track
+	 */
+	Signature GetSignature(const t_track& track) const
+	{
+		Signature sig{};
+
+		const auto& pts = track.GetPoints();
+		if(pts.size() < 2)
+			return sig;
+
+		std::tie(sig.min_lon, sig.max_lon) = track.GetLongitudeRange();
+		std::tie(sig.min_lat, sig.max_lat) = track.GetLatitudeRange();
+		sig.length = track.GetTotalDistance(true);
+		if(sig.length <= t_real(0))
+			return sig;
+
+		// geohash cells
+		sig.cells.reserve(pts.size());
+		for(const auto& pt : pts)
+			sig.cells.push_back(GetGeohash(pt.longitude, pt.latitude));
+
+		std::sort(sig.cells.begin(), sig.cells.end());
+		sig.cells.erase(std::unique(sig.cells.begin(), sig.cells.end()), sig.cells.end());
+
+		// resample the track at equidistant points
+		sig.shape.reserve(m_shape_pts);
+		t_size ptidx = 0;
+		for(t_size shapeidx = 0; shapeidx < m_shape_pts; ++shapeidx)
+		{
+			const t_real dist = sig.length * t_real(shapeidx) / t_real(m_shape_pts - 1);
+
+			while(ptidx + 1 < pts.size() - 1 && pts[ptidx + 1].distance_planar_total < dist)
+				++ptidx;
+
+			const auto& pt1 = pts[ptidx];
+			const auto& pt2 = pts[ptidx + 1];
+
+			t_real seg_len = pt2.distance_planar_total - pt1.distance_planar_total;
+			t_real t = seg_len > t_real(0) ? (dist - pt1.distance_planar_total) / seg_len : t_real(0);
+			t = std::clamp(t, t_real(0), t_real(1));
+
+			sig.shape.emplace_back(std::make_pair(
+				std::lerp(pt1.longitude, pt2.longitude, t),
+				std::lerp(pt1.latitude, pt2.latitude, t)));
+		}
+
+		sig.valid = true;
+		return sig;
+	}
+
+
+
+	/**
+	 * discrete Fréchet distance [m] between two resampled shapes
+	 * @see https://en.wikipedia.org/wiki/Fr%C3%A9chet_distance#Discrete_Fr%C3%A9chet_distance
+	 */
+	t_real GetFrechetDistance(
+		const std::vector<std::pair<t_real, t_real>>& shape1,
+		const std::vector<std::pair<t_real, t_real>>& shape2,
+		bool reversed = false) const
+	{
+		const t_size N1 = shape1.size();
+		const t_size N2 = shape2.size();
+		if(!N1 || !N2)
+			return std::numeric_limits<t_real>::max();
+
+		// local planar approximation
+		const t_real lat = (shape1[0].second + shape2[0].second) / t_real(2);
+		const t_real lat_scale = earth_radius<t_real>(lat);
+		const t_real lon_scale = lat_scale * std::cos(lat);
+
+		auto dist = [&](t_size i, t_size j) -> t_real
+		{
+			const auto& pt1 = shape1[i];
+			const auto& pt2 = shape2[reversed ? N2 - j - 1 : j];
+
+			t_real dx = (pt2.first - pt1.first) * lon_scale;
+			t_real dy = (pt2.second - pt1.second) * lat_scale;
+			return std::sqrt(dx*dx + dy*dy);
+		};
+
+		// dynamic programming over two rows
+		std::vector<t_real> prev(N2), cur(N2);
+		for(t_size i = 0; i < N1; ++i)
+		{
+			for(t_size j = 0; j < N2; ++j)
+			{
+				t_real d = dist(i, j);
+
+				if(i == 0 && j == 0)
+					cur[j] = d;
+				else if(i == 0)
+					cur[j] = std::max(cur[j - 1], d);
+				else if(j == 0)
+					cur[j] = std::max(prev[j], d);
+				else
+					cur[j] = std::max(std::min({ prev[j], prev[j - 1], cur[j - 1] }), d);
+			}
+
+			std::swap(prev, cur);
+		}
+
+		return prev[N2 - 1];
+	}
+
+
+
+protected:
+	/**
+	 * interleave the bits of the quantised longitude and latitude
+	 * @see https://en.wikipedia.org/wiki/Geohash
+	 */
+	t_cell GetGeohash(t_real lon, t_real lat) const
+	{
+		namespace num = std::numbers;
+
+		const t_cell max_val = (t_cell(1) << m_geohash_bits) - 1;
+		t_real lon_norm = (lon + num::pi_v<t_real>) / (t_real(2) * num::pi_v<t_real>);
+		t_real lat_norm = (lat + num::pi_v<t_real> / t_real(2)) / num::pi_v<t_real>;
+
+		t_cell lon_bits = static_cast<t_cell>(std::clamp(lon_norm, t_real(0), t_real(1)) * t_real(max_val));
+		t_cell lat_bits = static_cast<t_cell>(std::clamp(lat_norm, t_real(0), t_real(1)) * t_real(max_val));
+
+		t_cell hash = 0;
+		for(unsigned int bit = 0; bit < m_geohash_bits; ++bit)
+		{
+			hash |= ((lon_bits >> bit) & 1) << (2*bit + 1);
+			hash |= ((lat_bits >> bit) & 1) << (2*bit);
+		}
+
+		return hash;
+	}
+
+
+
+	/**
+	 * check if two signatures describe the same route
+	 */
+	bool IsSameRoute(const Signature& sig1, const Signature& sig2) const
+	{
+		// bounding boxes have to overlap
+		if(sig1.max_lon < sig2.min_lon || sig2.max_lon < sig1.min_lon ||
+			sig1.max_lat < sig2.min_lat || sig2.max_lat < sig1.min_lat)
+			return false;
+
+		t_real len_ratio = std::max(sig1.length, sig2.length) / std::min(sig1.length, sig2.length);
+		if(len_ratio > m_max_len_ratio)
+			return false;
+
+		return GetFrechetDistance(sig1.shape, sig2.shape, false) <= m_max_dist
+			|| GetFrechetDistance(sig1.shape, sig2.shape, true) <= m_max_dist;
+	}
+
+
+
+	/**
+	 * find a matching group among the representatives [first_rep, num_reps)
+	 */
+	std::optional<t_size> FindCluster(const std::vector<Signature>& sigs,
+		const std::vector<t_size>& reps,
+		const std::unordered_map<t_cell, std::vector<t_size>>& cell_reps,
+		t_size trackidx, t_size num_reps, t_size first_rep = 0) const
+	{
+		const Signature& sig = sigs[trackidx];
+
+		// count the shared cells per group
+		std::unordered_map<t_size, t_size> shared;
+		for(t_cell cell : sig.cells)
+		{
+			auto iter = cell_reps.find(cell);
+			if(iter == cell_reps.end())
+				continue;
+
+			for(t_size clusteridx : iter->second)
+			{
+				if(clusteridx >= first_rep && clusteridx < num_reps)
+					++shared[clusteridx];
+			}
+		}
+
+		// candidate groups ordered by overlap
+		std::vector<std::pair<t_real, t_size>> candidates;
+		for(const auto& [ clusteridx, num_shared ] : shared)
+		{
+			const Signature& rep_sig = sigs[reps[clusteridx]];
+			t_real overlap = t_real(num_shared) /
+				t_real(sig.cells.size() + rep_sig.cells.size() - num_shared);
+
+			if(overlap >= m_min_overlap)
+				candidates.emplace_back(std::make_pair(overlap, clusteridx));
+		}
+
+		std::sort(candidates.begin(), candidates.end(),
+			[](const auto& cand1, const auto& cand2) -> bool
+		{
+			if(cand1.first != cand2.first)
+				return cand1.first > cand2.first;
+			return cand1.second < cand2.second;
+		});
+
+		for(const auto& [ overlap, clusteridx ] : candidates)
+		{
+			if(IsSameRoute(sig, sigs[reps[clusteridx]]))
+				return clusteridx;
+		}
+
+		return std::nullopt;
+	}
+
+
+
+private:
+	t_real m_max_dist{100.};
+	t_real m_min_overlap{0.5};
+	t_real m_max_len_ratio{1.25};
+
+	unsigned int m_geohash_bits{17};
+	t_size m_shape_pts{64};
+
+	unsigned int m_num_threads{4};
+};
+
+
+#endif
@@ -9,20 +9,173 @@
 #define __TRACK_DBFILE_H__
 
 #include "track.h"
+#include "trackindex.h"
+#include "trackcluster.h"
+#include "profile.h"
+#include "memory.h"
 
 #include <algorithm>
+#include <numeric>
 #include <map>
 #include <tuple>
+#include <optional>
 #include <vector>
 #include <string_view>
 #include <concepts>
 #include <thread>
 #include <mutex>
 #include <future>
+#include <atomic>
+#include <functional>
+#include <type_traits>
 #include <boost/asio.hpp>
 
 
-#define TRACKDB_MAGIC "TRACKDB"
+#define TRACKDB_MAGIC "TRACKDB2"
+#define TRACKDB_MAGIC_V1 "TRACKDB"   // without the calculation settings
+#define TRACKDB_SUMMARY_MAGIC "TRACKSUM"
+
+
+
+/**
+ * writes a track database file track by track
+ */
+template<class t_track, class t_size = std::size_t>
+requires std::integral<t_size>
+class TrackDBWriter
+{
+public:
+	using t_pos = typename std::ofstream::pos_type;
+	using t_summary = typename t_track::t_summary;
+	using t_calc_settings = typename t_track::t_calc_settings;
+
+
+
+public:
+	/**
+	 * write the header and reserve the calculation settings and the track address table
+	 */
+	TrackDBWriter(std::ofstream& ofstr, t_size num_tracks)
+		: m_ofstr{ofstr}, m_num_tracks{num_tracks}
+	{
+		m_ofstr.write(TRACKDB_MAGIC, sizeof(TRACKDB_MAGIC));
+		m_ofstr.write(reinterpret_cast<const char*>(&m_num_tracks), sizeof(m_num_tracks));
+
+		// the settings are filled in with the ones of the first track
+		m_pos_settings = m_ofstr.tellp();
+		WriteCalcSettings(m_ofstr, t_calc_settings{});
+
+		m_pos_addresses = m_ofstr.tellp();
+		m_ofstr.seekp(m_num_tracks * sizeof(t_size), std::ios::cur);
+
+		m_summaries.reserve(m_num_tracks);
+	}
+
+
+
+	~TrackDBWriter() = default;
+
+	TrackDBWriter(const TrackDBWriter&) = delete;
+	TrackDBWriter& operator=(const TrackDBWriter&) = delete;
+
+
+
+	/**
+	 * write the next track
+	 * @param summary the track's summary if it is already available
+	 */
+	bool Write(const t_track& track, const t_summary *summary = nullptr)
+	{
+		const t_size trackidx = m_summaries.size();
+		if(trackidx >= m_num_tracks)
+			return false;
+
+		// the stored values of all tracks have to be calculated with the same settings
+		if(trackidx == 0)
+		{
+			m_settings = track.GetCalcSettings();
+
+			t_pos pos = m_ofstr.tellp();
+			m_ofstr.seekp(m_pos_settings, std::ios::beg);
+			WriteCalcSettings(m_ofstr, m_settings);
+			m_ofstr.seekp(pos, std::ios::beg);
+		}
+		else if(track.GetCalcSettings() != m_settings)
+		{
+			return false;
+		}
+
+		t_pos pos_before = m_ofstr.tellp();
+		if(!track.Save(m_ofstr))
+			return false;
+		t_pos pos_after = m_ofstr.tellp();
+
+		// write track start address
+		t_size pos_track = static_cast<t_size>(pos_before);
+		m_ofstr.seekp(m_pos_addresses + static_cast<t_pos>(trackidx*sizeof(t_size)), std::ios::beg);
+		m_ofstr.write(reinterpret_cast<const char*>(&pos_track), sizeof(pos_track));
+
+		m_ofstr.seekp(pos_after, std::ios::beg);
+
+		m_summaries.push_back(summary ? *summary : track.GetSummary());
+		return !!m_ofstr;
+	}
+
+
+
+	/**
+	 * append the track summaries, followed by their start address,
+	 * this section is ignored by readers not knowing about it
+	 */
+	bool Finish()
+	{
+		if(m_summaries.size() != m_num_tracks)
+			return false;
+
+		const t_size pos_summaries = static_cast<t_size>(m_ofstr.tellp());
+		const t_size summary_size = sizeof(t_summary);
+
+		m_ofstr.write(TRACKDB_SUMMARY_MAGIC, sizeof(TRACKDB_SUMMARY_MAGIC));
+		m_ofstr.write(reinterpret_cast<const char*>(&m_num_tracks), sizeof(m_num_tracks));
+		m_ofstr.write(reinterpret_cast<const char*>(&summary_size), sizeof(summary_size));
+		m_ofstr.write(reinterpret_cast<const char*>(m_summaries.data()), m_summaries.size() * summary_size);
+
+		m_ofstr.write(reinterpret_cast<const char*>(&pos_summaries), sizeof(pos_summaries));
+		m_ofstr.write(TRACKDB_SUMMARY_MAGIC, sizeof(TRACKDB_SUMMARY_MAGIC));
+
+		return !!m_ofstr;
+	}
+
+
+
+	static void WriteCalcSettings(std::ostream& ostr, const t_calc_settings& settings)
+	{
+		ostr.write(reinterpret_cast<const char*>(&settings.distance_function), sizeof(settings.distance_function));
+		ostr.write(reinterpret_cast<const char*>(&settings.asc_eps), sizeof(settings.asc_eps));
+		ostr.write(reinterpret_cast<const char*>(&settings.smooth_rad), sizeof(settings.smooth_rad));
+	}
+
+
+
+	static bool ReadCalcSettings(std::istream& istr, t_calc_settings& settings)
+	{
+		istr.read(reinterpret_cast<char*>(&settings.distance_function), sizeof(settings.distance_function));
+		istr.read(reinterpret_cast<char*>(&settings.asc_eps), sizeof(settings.asc_eps));
+		istr.read(reinterpret_cast<char*>(&settings.smooth_rad), sizeof(settings.smooth_rad));
+		return !!istr;
+	}
+
+
+
+private:
+	std::ofstream& m_ofstr;
+	t_size m_num_tracks{};
+	t_pos m_pos_settings{};
+	t_pos m_pos_addresses{};
+	t_calc_settings m_settings{};
+
+	std::vector<t_summary> m_summaries{};
+};
 
 
 
@@ -37,8 +190,17 @@ public:
 	using t_track = SingleTrack<t_real, t_size>;
 	using t_clk = typename t_track::t_clk;
 	using t_timept = typename t_track::t_timept;
+	using t_summary = typename t_track::t_summary;
+	using t_calc_settings = typename t_track::t_calc_settings;
+
+	// summaries are stored as raw records
+	static_assert(std::is_trivially_copyable_v<t_summary>);
 	using t_timept_map = std::map<t_timept,
 		std::tuple<t_real /*dist*/, t_real /*time*/, t_size /*# tracks*/>>;
+	using t_index = TrackIndex<t_track, t_real, t_size>;
+	using t_match = typename t_index::t_match;
+	using t_clusters = RouteClusters<t_track, t_real, t_size>;
+	using t_cluster = typename t_clusters::t_cluster;
 
 
 
@@ -54,12 +216,19 @@ public:
 
 
 
+	/**
+	 * get a track by its index in the time-ordered track list,
+	 * the track may be modified, so its cached summary is discarded
+	 */
+	/**
+	 * get a modifiable track, call TrackModified() after changing it
+	 */
 	t_track* GetTrack(t_size idx)
 	{
 		if(idx >= GetTrackCount())
 			return nullptr;
 
-		return &m_tracks[idx];
+		return &m_tracks[m_order[idx]];
 	}
 
 
@@ -69,34 +238,120 @@ public:
 		if(idx >= GetTrackCount())
 			return nullptr;
 
-		return &m_tracks[idx];
+		return &m_tracks[m_order[idx]];
+	}
+
+
+
+	/**
+	 * the track has been changed via the non-const GetTrack()
+	 */
+	void TrackModified([[maybe_unused]] t_size idx)
+	{
+		InvalidateSummaries();
 	}
 
 
 
-	void EmplaceTrack(t_track&& track)
+	/**
+	 * insert a track at its position in the time-ordered track list
+	 * @return index of the inserted track
+	 */
+	t_size EmplaceTrack(t_track&& track)
 	{
-		m_tracks.emplace_back(std::forward<t_track>(track));
-		m_tracks.rbegin()->SetDistanceFunction(m_distance_function);
-		m_tracks.rbegin()->SetAscentEpsilon(m_asc_eps);
-		m_tracks.rbegin()->SetSmoothRadius(m_smooth_rad);
+		return InsertTrack(std::forward<t_track>(track));
 	}
 
 
 
-	void AddTrack(const t_track& track)
+	t_size AddTrack(const t_track& track)
 	{
-		m_tracks.push_back(track);
-		m_tracks.rbegin()->SetDistanceFunction(m_distance_function);
-		m_tracks.rbegin()->SetAscentEpsilon(m_asc_eps);
-		m_tracks.rbegin()->SetSmoothRadius(m_smooth_rad);
+		return InsertTrack(t_track{track});
+	}
+
+
+
+	/**
+	 * insert a track at its position in the time-ordered track list
+	 * @return index of the inserted track
+	 */
+	t_size InsertTrack(t_track&& track)
+	{
+		const t_size store_idx = m_tracks.size();
+		t_track& new_track = m_tracks.emplace_back(std::forward<t_track>(track));
+		new_track.SetDistanceFunction(m_distance_function);
+		new_track.SetAscentEpsilon(m_asc_eps);
+		new_track.SetSmoothRadius(m_smooth_rad);
+
+		// only the index is moved, not the track
+		auto iter = std::upper_bound(m_order.begin(), m_order.end(), new_track,
+			[this](const t_track& track1, t_size idx2) -> bool
+		{
+			return IsTrackBefore(track1, m_tracks[idx2]);
+		});
+
+		iter = m_order.insert(iter, store_idx);
+		InvalidateSpatialIndex();
+		InvalidateSummaries();
+		return static_cast<t_size>(iter - m_order.begin());
 	}
 
 
 
 	t_size GetTrackCount() const
 	{
-		return m_tracks.size();
+		return m_order.size();
+	}
+
+
+
+	/**
+	 * get all tracks in the time-ordered track list
+	 */
+	std::vector<const t_track*> GetTracks() const
+	{
+		std::vector<const t_track*> tracks;
+		tracks.reserve(GetTrackCount());
+		for(t_size idx = 0; idx < GetTrackCount(); ++idx)
+			tracks.push_back(GetTrack(idx));
+
+		return tracks;
+	}
+
+
+
+	/**
+	 * get the summaries of all tracks in the time-ordered track list,
+	 * they are copied under the lock, as the cache may be rebuilt by other threads
+	 */
+	std::vector<t_summary> GetSummaries() const
+	{
+		std::lock_guard lck{m_summaries_mtx};
+
+		if(!m_summaries_valid)
+		{
+			m_summaries.clear();
+			m_summaries.reserve(GetTrackCount());
+			for(t_size idx = 0; idx < GetTrackCount(); ++idx)
+				m_summaries.push_back(GetTrack(idx)->GetSummary());
+
+			m_summaries_valid = true;
+		}
+
+		return m_summaries;
+	}
+
+
+
+	std::optional<t_summary> GetSummary(t_size idx) const
+	{
+		if(idx >= GetTrackCount())
+			return std::nullopt;
+
+		std::lock_guard lck{m_summaries_mtx};
+		if(m_summaries_valid)
+			return m_summaries[idx];
+		return GetTrack(idx)->GetSummary();
 	}
 
 
@@ -104,6 +359,9 @@ public:
 	void ClearTracks()
 	{
 		m_tracks.clear();
+		m_order.clear();
+		InvalidateSpatialIndex();
+		InvalidateSummaries();
 	}
 
 
@@ -114,91 +372,341 @@ public:
 			return;
 
 		//std::cout << "Deleting track index " << idx << ": " << GetTrack(idx)->GetFileName() << std::endl;
-		m_tracks.erase(m_tracks.begin() + idx);
+		const t_size store_idx = m_order[idx];
+		const t_size last_idx = m_tracks.size() - 1;
+		m_order.erase(m_order.begin() + idx);
+
+		// move the last stored track into the free slot
+		if(store_idx != last_idx)
+		{
+			m_tracks[store_idx] = std::move(m_tracks[last_idx]);
+			*std::find(m_order.begin(), m_order.end(), last_idx) = store_idx;
+		}
+
+		m_tracks.pop_back();
+		InvalidateSpatialIndex();
+		InvalidateSummaries();
 	}
 
 
 
 	/**
-	 * sort tracks by time stamp
+	 * ordering of the track list: newest tracks first, tracks without time stamps at the end
+	 * (this is a strict weak ordering)
+	 */
+	static bool IsTrackBefore(const t_track& track1, const t_track& track2)
+	{
+		auto t1 = track1.GetStartTime();
+		auto t2 = track2.GetStartTime();
+
+		if(!t1 || !t2)
+			return t1 && !t2;
+
+		return *t1 > *t2;
+	}
+
+
+
+	/**
+	 * (re-)build the time index of the tracks
 	 */
 	void SortTracks()
 	{
-		std::stable_sort(m_tracks.begin(), m_tracks.end(),
-			[](const t_track& track1, const t_track& track2) -> bool
+		auto is_before = [this](t_size idx1, t_size idx2) -> bool
 		{
-			auto t1 = track1.GetStartTime();
-			auto t2 = track2.GetStartTime();
+			return IsTrackBefore(m_tracks[idx1], m_tracks[idx2]);
+		};
 
-			if(!t1 || !t2)
-				return false;
+		if(m_order.size() != m_tracks.size())
+		{
+			m_order.resize(m_tracks.size());
+			std::iota(m_order.begin(), m_order.end(), 0);
+		}
 
-			return *t1 >= *t2;
+		// only the indices are sorted, not the tracks
+		if(!std::is_sorted(m_order.begin(), m_order.end(), is_before))
+		{
+			std::stable_sort(m_order.begin(), m_order.end(), is_before);
+			InvalidateSpatialIndex();
+			InvalidateSummaries();
+		}
+	}
+
+
+
+	/**
+	 * get the index range [begin, end) of the tracks that started within the given time range
+	 */
+	std::pair<t_size, t_size> GetTrackRange(const t_timept& start, const t_timept& end) const
+	{
+		// tracks are ordered by descending start time
+		auto iter_begin = std::partition_point(m_order.begin(), m_order.end(),
+			[this, &end](t_size idx) -> bool
+		{
+			auto t = m_tracks[idx].GetStartTime();
+			return t && *t > end;
 		});
+
+		auto iter_end = std::partition_point(iter_begin, m_order.end(),
+			[this, &start](t_size idx) -> bool
+		{
+			auto t = m_tracks[idx].GetStartTime();
+			return t && *t >= start;
+		});
+
+		return std::make_pair(
+			static_cast<t_size>(iter_begin - m_order.begin()),
+			static_cast<t_size>(iter_end - m_order.begin()));
+	}
+
+
+
+	/**
+	 * find the tracks passing through the given longitude and latitude ranges [rad]
+	 */
+	std::vector<t_match> GetTracksInRegion(
+		t_real min_lon, t_real max_lon,
+		t_real min_lat, t_real max_lat) const
+	{
+		std::lock_guard lck{m_spatial_index_mtx};
+		return GetSpatialIndex().QueryRegion(min_lon, max_lon, min_lat, max_lat);
+	}
+
+
+
+	/**
+	 * find the tracks passing within the given radius [m] around a point [rad]
+	 */
+	std::vector<t_match> GetTracksNear(t_real lon, t_real lat, t_real radius) const
+	{
+		std::lock_guard lck{m_spatial_index_mtx};
+		return GetSpatialIndex().QueryRadius(lon, lat, radius);
+	}
+
+
+
+	/**
+	 * group the tracks that follow the same course
+	 * @param max_dist maximum deviation [m] between tracks of the same route
+	 * @return groups of track indices, largest group first
+	 */
+	std::vector<t_cluster> GetRouteClusters(t_real max_dist = 100.) const
+	{
+		t_clusters clusters;
+		clusters.SetMaxDistance(max_dist);
+		clusters.SetNumThreads(m_num_threads);
+
+		return clusters.Calculate(GetTracks());
 	}
 
 
 
 	/**
 	 * calculate track properties
+	 * @param only_dirty only recalculate the values depending on changed settings
+	 * @return number of recalculated tracks
 	 */
-	void Calculate()
+	t_size Calculate(bool only_dirty = false)
 	{
+		TRACKS_PROFILE_SCOPE("MultipleTracks::Calculate");
+
 		boost::asio::thread_pool tp{m_num_threads};
+		t_size num_calculated = 0;
 
 		for(t_track& track : m_tracks)
 		{
-			boost::asio::post(tp, [&track]() -> void
+			if(only_dirty && !track.IsDirty())
+				continue;
+
+			boost::asio::post(tp, [&track, only_dirty]() -> void
 			{
-				track.Calculate();
+				ProfileTimer timer{"MultipleTracks::Calculate track"};
+				timer.SetArgument("track", track.GetFileName());
+
+				track.Calculate(only_dirty);
 			});
+
+			++num_calculated;
+		}
+
+		tp.join();
+
+		TRACKS_PROFILE_COUNT("MultipleTracks::Calculate tracks", num_calculated);
+
+		if(num_calculated)
+			InvalidateSummaries();
+		return num_calculated;
+	}
+
+
+
+	/**
+	 * estimate the memory used by the tracks, their summaries and the spatial index
+	 */
+	MemoryBreakdown MemoryUsage() const
+	{
+		MemoryBreakdown mem;
+		mem.Add("track objects", mem_vector(m_tracks));
+
+		for(const t_track& track : m_tracks)
+			mem.Add(track.MemoryUsage());
+
+		mem.Add("track order", mem_vector(m_order));
+
+		{
+			std::lock_guard lck{m_summaries_mtx};
+			mem.Add("track summaries", mem_vector(m_summaries));
+		}
+
+		{
+			std::lock_guard lck{m_spatial_index_mtx};
+			if(m_spatial_index)
+				mem.Add(m_spatial_index->MemoryUsage());
+		}
+
+		return mem;
+	}
+
+
+
+	/**
+	 * get the number of tracks with values depending on changed settings
+	 */
+	t_size GetDirtyTrackCount() const
+	{
+		return static_cast<t_size>(std::count_if(m_tracks.begin(), m_tracks.end(),
+			[](const t_track& track) -> bool
+		{
+			return track.IsDirty();
+		}));
+	}
+
+
+
+	/**
+	 * import several track files in parallel and insert them in time order
+	 * @param progress gets the number of processed and total files, returns false to cancel
+	 * @param failed_files optionally receives the names of the files that could not be imported
+	 * @return number of imported tracks, nothing is imported if cancelled
+	 */
+	t_size ImportFiles(const std::vector<std::string>& filenames, t_real assume_dt = 1.,
+		std::function<bool(t_size, t_size)> *progress = nullptr,
+		std::vector<std::string> *failed_files = nullptr)
+	{
+		const t_size num_files = filenames.size();
+		std::atomic<bool> stop_requested{false};
+
+		boost::asio::thread_pool tp{m_num_threads};
+		std::vector<std::shared_ptr<std::packaged_task<std::optional<t_track>()>>> tasks;
+		tasks.reserve(num_files);
+
+		for(const std::string& filename : filenames)
+		{
+			auto task_func = [this, &filename, &stop_requested, assume_dt]() -> std::optional<t_track>
+			{
+				if(stop_requested)
+					return std::nullopt;
+
+				ProfileTimer timer{"MultipleTracks::ImportFiles file"};
+				timer.SetArgument("file", filename);
+
+				t_track track{};
+				track.SetDistanceFunction(m_distance_function);
+				track.SetAscentEpsilon(m_asc_eps);
+				track.SetSmoothRadius(m_smooth_rad);
+
+				// parses the file and calculates the track properties
+				if(!track.Import(filename, assume_dt))
+					return std::nullopt;
+
+				return track;
+			};
+
+			auto task = std::make_shared<std::packaged_task<std::optional<t_track>()>>(task_func);
+			boost::asio::post(tp, [task]() -> void { (*task)(); });
+			tasks.push_back(task);
+		}
+
+		// collect the imported tracks in the order of the given files
+		std::vector<t_track> imported;
+		imported.reserve(num_files);
+
+		for(t_size fileidx = 0; fileidx < num_files; ++fileidx)
+		{
+			std::optional<t_track> track;
+			try
+			{
+				track = tasks[fileidx]->get_future().get();
+			}
+			catch(const std::exception& ex)
+			{
+				std::cerr << filenames[fileidx] << ": " << ex.what() << std::endl;
+			}
+
+			if(track)
+				imported.emplace_back(std::move(*track));
+			else if(failed_files && !stop_requested)
+				failed_files->push_back(filenames[fileidx]);
+
+			if(progress && !stop_requested && !(*progress)(fileidx + 1, num_files))
+				stop_requested = true;
 		}
 
 		tp.join();
+
+		if(stop_requested)
+			return 0;
+
+		m_tracks.reserve(m_tracks.size() + imported.size());
+		m_order.reserve(m_order.size() + imported.size());
+		for(t_track& track : imported)
+			InsertTrack(std::move(track));
+
+		return imported.size();
 	}
 
 
 
 	bool Save(const std::string& filename) const
 	{
-		using t_pos = typename std::ofstream::pos_type;
+		TRACKS_PROFILE_SCOPE("MultipleTracks::Save");
+
 		std::ofstream ofstr{filename, std::ios::binary};
 		if(!ofstr)
 			return false;
 
-		const t_size num_tracks = GetTrackCount();
+		const std::vector<t_summary> summaries = GetSummaries();
+		TrackDBWriter<t_track, t_size> writer{ofstr, GetTrackCount()};
 
-		ofstr.write(TRACKDB_MAGIC, sizeof(TRACKDB_MAGIC));
-		ofstr.write(reinterpret_cast<const char*>(&num_tracks), sizeof(num_tracks));
-		t_pos pos_addresses = ofstr.tellp();
-		ofstr.seekp(num_tracks * sizeof(t_size), std::ios::cur);
-
-		for(t_size trackidx = 0; trackidx < num_tracks; ++trackidx)
+		for(t_size trackidx = 0; trackidx < GetTrackCount(); ++trackidx)
 		{
 			const t_track* track = GetTrack(trackidx);
 			if(!track)
 				return false;
 
-			t_pos pos_before = ofstr.tellp();
-			if(!track->Save(ofstr))
+			if(track->IsDirty())
+			{
+				// the stored values have to match the saved settings
+				t_track calc_track = *track;
+				calc_track.Calculate(true);
+				if(!writer.Write(calc_track))
+					return false;
+			}
+			else if(!writer.Write(*track, &summaries[trackidx]))
+			{
 				return false;
-			t_pos pos_after = ofstr.tellp();
-
-			// write track start address
-			t_size pos_track = static_cast<t_size>(pos_before);
-			ofstr.seekp(pos_addresses + static_cast<t_pos>(trackidx*sizeof(t_size)), std::ios::beg);
-			ofstr.write(reinterpret_cast<const char*>(&pos_track), sizeof(pos_track));
-
-			ofstr.seekp(pos_after, std::ios::beg);
+			}
 		}
 
-		return true;
+		TRACKS_PROFILE_COUNT("MultipleTracks::Save tracks", GetTrackCount());
+		return writer.Finish();
 	}
 
 
 
 	bool Load(const std::string& filename)
 	{
+		TRACKS_PROFILE_SCOPE("MultipleTracks::Load");
 		ClearTracks();
 
 		using t_pos = typename std::ifstream::pos_type;
@@ -206,14 +714,31 @@ public:
 		if(!ifstr)
 			return false;
 
-		char magic[sizeof(TRACKDB_MAGIC)];
-		ifstr.read(magic, sizeof(magic));
-		if(std::string_view(magic) != TRACKDB_MAGIC)
-			return false;
+		// the magic of the current version extends the one of the first version
+		static_assert(sizeof(TRACKDB_MAGIC) == sizeof(TRACKDB_MAGIC_V1) + 1);
+		char magic[sizeof(TRACKDB_MAGIC)]{};
+		ifstr.read(magic, sizeof(TRACKDB_MAGIC_V1));
+		const bool is_v1 = (std::string_view(magic) == TRACKDB_MAGIC_V1);
+		if(!is_v1)
+		{
+			ifstr.read(magic + sizeof(TRACKDB_MAGIC_V1), 1);
+			if(!ifstr || std::string_view(magic) != TRACKDB_MAGIC)
+				return false;
+		}
 
 		t_size num_tracks = 0;
 		ifstr.read(reinterpret_cast<char*>(&num_tracks), sizeof(num_tracks));
+
+		// settings with which the stored values were calculated,
+		// these are unknown for files of the first version
+		t_calc_settings stored_settings{};
+		if(!is_v1 && !TrackDBWriter<t_track, t_size>::ReadCalcSettings(ifstr, stored_settings))
+			return false;
+		const t_calc_settings cur_settings = GetCalcSettings();
+		const bool recalculate = is_v1 || stored_settings != cur_settings;
+
 		m_tracks.reserve(num_tracks);
+		m_order.reserve(num_tracks);
 
 		t_pos pos_addresses = ifstr.tellg();
 
@@ -223,8 +748,11 @@ public:
 
 		for(t_size trackidx = 0; trackidx < num_tracks; ++trackidx)
 		{
-			auto task_func = [this, &filename, pos_addresses, trackidx]() -> std::optional<t_track>
+			auto task_func = [&filename, pos_addresses, trackidx, is_v1,
+				&stored_settings, &cur_settings]() -> std::optional<t_track>
 			{
+				ProfileTimer timer{"MultipleTracks::Load track"};
+
 				std::ifstream ifstr_track{filename, std::ios::binary};
 				if(!ifstr_track)
 					return std::nullopt;
@@ -238,13 +766,25 @@ public:
 				ifstr_track.seekg(static_cast<t_pos>(pos_track), std::ios::beg);
 
 				t_track track{};
-				track.SetDistanceFunction(m_distance_function);
-				track.SetAscentEpsilon(m_asc_eps);
-				track.SetSmoothRadius(m_smooth_rad);
-
-				if(!track.Load(ifstr_track))
-					return std::nullopt;
+				if(is_v1)
+				{
+					track.SetCalcSettings(cur_settings);
+					if(!track.Load(ifstr_track, true))
+						return std::nullopt;
+				}
+				else
+				{
+					track.SetCalcSettings(stored_settings);
+					if(!track.Load(ifstr_track))
+						return std::nullopt;
+
+					// only recalculate the values depending on changed settings
+					track.SetCalcSettings(cur_settings);
+					if(track.IsDirty())
+						track.Calculate(true);
+				}
 
+				timer.SetArgument("track", track.GetFileName());
 				return track;
 			};
 
@@ -261,12 +801,37 @@ public:
 		}
 
 		tp.join();
+		TRACKS_PROFILE_COUNT("MultipleTracks::Load tracks", m_tracks.size());
+
+		// use the stored track summaries if they are available, complete and up-to-date
+		if(!recalculate && LoadSummaries(ifstr))
+		{
+			std::lock_guard lck{m_summaries_mtx};
+			m_summaries_valid = (m_summaries.size() == m_tracks.size());
+		}
+
+		// tracks are saved in order, so this usually only builds the identity index
 		SortTracks();
 		return true;
 	}
 
 
 
+	/**
+	 * get the settings which the calculated track values depend on
+	 */
+	t_calc_settings GetCalcSettings() const
+	{
+		return t_calc_settings
+		{
+			.distance_function = m_distance_function,
+			.asc_eps = m_asc_eps,
+			.smooth_rad = m_smooth_rad,
+		};
+	}
+
+
+
 	void SetDistanceFunction(int dist_func)
 	{
 		m_distance_function = dist_func;
@@ -400,14 +965,16 @@ public:
 			<< std::left << std::setw(field_width) << "Time" << " "
 			<< std::left << std::setw(name_width) << "Name" << "\n";
 
-		for(t_size idx = 0; idx < tracks.GetTrackCount(); ++idx)
+		const std::vector<t_summary> summaries = tracks.GetSummaries();
+		for(t_size idx = 0; idx < summaries.size(); ++idx)
 		{
+			const t_summary& summary = summaries[idx];
 			const t_track* track = tracks.GetTrack(idx);
 
 			ostr
 				<< std::left << std::setw(idx_width) << idx + 1 << " "
-				<< std::left << std::setw(field_width) << get_dist_str(track->GetTotalDistance()) << " "
-				<< std::left << std::setw(field_width) << get_time_str(track->GetTotalTime()) << " "
+				<< std::left << std::setw(field_width) << get_dist_str(summary.distance) << " "
+				<< std::left << std::setw(field_width) << get_time_str(summary.total_time) << " "
 				<< std::left << std::setw(name_width) << track->GetFileName() << "\n";
 		}
 
@@ -417,15 +984,103 @@ public:
 
 
 
+protected:
+	/**
+	 * get the spatial index, (re-)building it if needed
+	 */
+	const t_index& GetSpatialIndex() const
+	{
+		if(!m_spatial_index)
+		{
+			m_spatial_index = std::make_shared<t_index>();
+			m_spatial_index->Build(GetTracks(), m_num_threads);
+		}
+
+		return *m_spatial_index;
+	}
+
+
+
+	void InvalidateSpatialIndex()
+	{
+		std::lock_guard lck{m_spatial_index_mtx};
+		m_spatial_index.reset();
+	}
+
+
+
+	void InvalidateSummaries()
+	{
+		std::lock_guard lck{m_summaries_mtx};
+		m_summaries_valid = false;
+	}
+
+
+
+	/**
+	 * read the track summaries, their start address is stored at the end of the file
+	 */
+	bool LoadSummaries(std::ifstream& ifstr)
+	{
+		using t_pos = typename std::ifstream::pos_type;
+		using t_off = typename std::ifstream::off_type;
+
+		char magic[sizeof(TRACKDB_SUMMARY_MAGIC)];
+		t_size pos_summaries = 0;
+
+		ifstr.seekg(-static_cast<t_off>(sizeof(pos_summaries) + sizeof(magic)), std::ios::end);
+		ifstr.read(reinterpret_cast<char*>(&pos_summaries), sizeof(pos_summaries));
+		ifstr.read(magic, sizeof(magic));
+		if(!ifstr || std::string_view(magic, sizeof(magic) - 1) != TRACKDB_SUMMARY_MAGIC)
+			return false;
+
+		ifstr.seekg(static_cast<t_pos>(pos_summaries), std::ios::beg);
+		ifstr.read(magic, sizeof(magic));
+		if(!ifstr || std::string_view(magic, sizeof(magic) - 1) != TRACKDB_SUMMARY_MAGIC)
+			return false;
+
+		t_size num_summaries = 0, summary_size = 0;
+		ifstr.read(reinterpret_cast<char*>(&num_summaries), sizeof(num_summaries));
+		ifstr.read(reinterpret_cast<char*>(&summary_size), sizeof(summary_size));
+		if(!ifstr || summary_size != sizeof(t_summary))
+			return false;
+
+		std::lock_guard lck{m_summaries_mtx};
+		m_summaries.resize(num_summaries);
+		ifstr.read(reinterpret_cast<char*>(m_summaries.data()), num_summaries * summary_size);
+		if(!ifstr)
+		{
+			m_summaries.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+
+
 private:
+	// tracks in the order of insertion
 	std::vector<t_track> m_tracks{};
 
+	// indices into m_tracks ordered by start time
+	std::vector<t_size> m_order{};
+
 	int m_distance_function{0};
 
 	t_real m_asc_eps{5.};
 	t_size m_smooth_rad{10};
 
 	unsigned int m_num_threads = 4;
+
+	// spatial index, built on demand
+	mutable std::shared_ptr<t_index> m_spatial_index{};
+	mutable std::mutex m_spatial_index_mtx{};
+
+	// track summaries in the time-ordered track list, loaded or built on demand
+	mutable std::vector<t_summary> m_summaries{};
+	mutable bool m_summaries_valid{false};
+	mutable std::mutex m_summaries_mtx{};
 };
 
 
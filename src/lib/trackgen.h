@@ -0,0 +1,328 @@
+/**
+ * synthetic track generator
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACK_GEN_H__
+#define __TRACK_GEN_H__
+
+#include <vector>
+#include <tuple>
+#include <random>
+#include <cstdint>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+#include <concepts>
+
+#include "track.h"
+
+
+
+/**
+ * generates deterministic synthetic tracks for scale testing
+ *
+ * Tracks follow randomly generated routes, several tracks can share a route.
+ * Every track and route only depends on the seed and its index, so tracks can
+ * be generated independently and in parallel.
+ */
+template<class t_real = double, class t_size = std::size_t>
+requires std::floating_point<t_real> && std::integral<t_size>
+class TrackGenerator
+{
+public:
+	using t_track = SingleTrack<t_real, t_size>;
+	using t_trackpt = typename t_track::t_trackpt;
+	using t_clk = typename t_track::t_clk;
+	using t_timept = typename t_track::t_timept;
+	using t_rng = std::mt19937_64;
+
+	// [lon, lat] [rad] and elevation [m] at equidistant route positions
+	using t_route = std::vector<std::tuple<t_real, t_real, t_real>>;
+
+
+
+public:
+	TrackGenerator() = default;
+	~TrackGenerator() = default;
+
+
+
+	void SetSeed(std::uint64_t seed)
+	{
+		m_seed = seed;
+	}
+
+
+
+	/**
+	 * centre [rad] and radius [m] of the area containing the route starts
+	 */
+	void SetArea(t_real lon, t_real lat, t_real radius)
+	{
+		m_lon = lon;
+		m_lat = lat;
+		m_area_radius = radius;
+	}
+
+
+
+	/**
+	 * mean number of points per track
+	 */
+	void SetPointsPerTrack(t_size num)
+	{
+		m_num_points = std::max<t_size>(num, 2);
+	}
+
+
+
+	/**
+	 * time between track points [s]
+	 */
+	void SetSamplingInterval(t_real dt)
+	{
+		m_dt = dt;
+	}
+
+
+
+	/**
+	 * mean speed [m/s]
+	 */
+	void SetSpeed(t_real speed)
+	{
+		m_speed = speed;
+	}
+
+
+
+	/**
+	 * standard deviations of the position [m] and elevation [m] noise
+	 */
+	void SetNoise(t_real pos_sigma, t_real elev_sigma)
+	{
+		m_pos_sigma = pos_sigma;
+		m_elev_sigma = elev_sigma;
+	}
+
+
+
+	/**
+	 * number of distinct routes, 0 gives every track its own route
+	 */
+	void SetNumRoutes(t_size num)
+	{
+		m_num_routes = num;
+	}
+
+
+
+	/**
+	 * start time of the first track and time between the starts of consecutive tracks [s]
+	 */
+	void SetStartTime(const t_timept& start, t_real interval)
+	{
+		m_start_time = start;
+		m_track_interval = interval;
+	}
+
+
+
+	/**
+	 * generate a route along which tracks can run
+	 */
+	t_route GenerateRoute(t_size routeidx) const
+	{
+		namespace num = std::numbers;
+
+		std::seed_seq seq = GetSeedSequence(std::uint64_t(routeidx), 0x524f555445);
+		t_rng rng{seq};
+		std::uniform_real_distribution<t_real> uni{0., 1.};
+		std::normal_distribution<t_real> normal{0., 1.};
+		std::normal_distribution<t_real> turn{0., 0.15};
+
+		// the route length corresponds to the mean number of track points
+		const t_real length = t_real(m_num_points - 1) * m_dt * m_speed
+			* std::max(t_real(1) + t_real(0.1) * normal(rng), t_real(0.5));
+		const t_size num_steps = static_cast<t_size>(length / ROUTE_STEP) + 2;
+
+		const t_real lat_scale = earth_radius<t_real>(m_lat);
+		const t_real lon_scale = lat_scale * std::cos(m_lat);
+
+		// start within the area
+		const t_real start_dist = m_area_radius * std::sqrt(uni(rng));
+		const t_real start_angle = t_real(2) * num::pi_v<t_real> * uni(rng);
+		t_real x = start_dist * std::cos(start_angle);
+		t_real y = start_dist * std::sin(start_angle);
+		t_real heading = t_real(2) * num::pi_v<t_real> * uni(rng);
+
+		// elevation profile as a sum of waves
+		const t_real elev_base = t_real(200) + t_real(600) * uni(rng);
+		t_real elev_amp[3], elev_len[3], elev_phase[3];
+		for(int wave = 0; wave < 3; ++wave)
+		{
+			elev_amp[wave] = t_real(40) * uni(rng) / t_real(wave + 1);
+			elev_len[wave] = t_real(500) + t_real(4000) * uni(rng);
+			elev_phase[wave] = t_real(2) * num::pi_v<t_real> * uni(rng);
+		}
+
+		t_route route;
+		route.reserve(num_steps);
+
+		for(t_size step = 0; step < num_steps; ++step)
+		{
+			const t_real dist = t_real(step) * ROUTE_STEP;
+
+			t_real elev = elev_base;
+			for(int wave = 0; wave < 3; ++wave)
+			{
+				elev += elev_amp[wave] * std::sin(t_real(2) * num::pi_v<t_real>
+					* dist / elev_len[wave] + elev_phase[wave]);
+			}
+
+			route.emplace_back(std::make_tuple(
+				m_lon + x / lon_scale, m_lat + y / lat_scale, elev));
+
+			// smoothly changing direction
+			heading += turn(rng);
+			x += ROUTE_STEP * std::cos(heading);
+			y += ROUTE_STEP * std::sin(heading);
+		}
+
+		return route;
+	}
+
+
+
+	/**
+	 * generate the track with the given index, later indices start earlier,
+	 * the track runs the whole length of its route
+	 */
+	t_track Generate(t_size trackidx) const
+	{
+		std::seed_seq seq = GetSeedSequence(std::uint64_t(trackidx), 0x545241434b);
+		t_rng rng{seq};
+		std::uniform_real_distribution<t_real> uni{0., 1.};
+		std::normal_distribution<t_real> normal{0., 1.};
+
+		// route
+		t_size routeidx = trackidx;
+		if(m_num_routes)
+			routeidx = trackidx < m_num_routes ? trackidx : rng() % m_num_routes;
+		const t_route route = GenerateRoute(routeidx);
+		const bool reversed = m_num_routes && trackidx >= m_num_routes && uni(rng) < t_real(0.5);
+
+		// number of points depending on the speed
+		const t_real route_len = t_real(route.size() - 1) * ROUTE_STEP;
+		const t_real speed = m_speed * std::max(t_real(1) + t_real(0.1) * normal(rng), t_real(0.5));
+		const t_size num_points = std::max<t_size>(
+			static_cast<t_size>(route_len / (speed * m_dt)) + 1, 2);
+
+		// start time, with some variation of the hour
+		t_timept time = m_start_time;
+		time -= std::chrono::milliseconds(static_cast<std::int64_t>(
+			(t_real(trackidx) * m_track_interval - t_real(3600) * uni(rng)) * t_real(1000)));
+
+		const t_real lat_scale = earth_radius<t_real>(m_lat);
+		const t_real lon_scale = lat_scale * std::cos(m_lat);
+
+		std::vector<t_trackpt> points;
+		points.reserve(num_points);
+		t_real dist = 0.;
+
+		// the position errors are correlated between neighbouring points
+		const t_real noise_corr = 0.95;
+		const t_real noise_scale = std::sqrt(t_real(1) - noise_corr*noise_corr);
+		t_real noise_x = m_pos_sigma * normal(rng);
+		t_real noise_y = m_pos_sigma * normal(rng);
+		t_real noise_elev = m_elev_sigma * normal(rng);
+
+		for(t_size ptidx = 0; ptidx < num_points; ++ptidx)
+		{
+			// position along the route
+			t_real route_pos = std::clamp(dist / ROUTE_STEP, t_real(0), t_real(route.size() - 1));
+			if(reversed)
+				route_pos = t_real(route.size() - 1) - route_pos;
+
+			const t_size idx1 = std::min(static_cast<t_size>(route_pos), route.size() - 2);
+			const t_real frac = route_pos - t_real(idx1);
+			const auto& [ lon1, lat1, elev1 ] = route[idx1];
+			const auto& [ lon2, lat2, elev2 ] = route[idx1 + 1];
+
+			t_trackpt pt
+			{
+				.latitude = std::lerp(lat1, lat2, frac) + noise_y / lat_scale,
+				.longitude = std::lerp(lon1, lon2, frac) + noise_x / lon_scale,
+				.elevation = std::lerp(elev1, elev2, frac) + noise_elev,
+				.timept = time,
+			};
+			points.emplace_back(std::move(pt));
+
+			noise_x = noise_corr*noise_x + noise_scale*m_pos_sigma*normal(rng);
+			noise_y = noise_corr*noise_y + noise_scale*m_pos_sigma*normal(rng);
+			noise_elev = noise_corr*noise_elev + noise_scale*m_elev_sigma*normal(rng);
+
+			// slightly varying speed
+			dist += speed * m_dt * (t_real(1) + t_real(0.05) * normal(rng));
+			time += std::chrono::milliseconds(static_cast<std::int64_t>(m_dt * t_real(1000)));
+		}
+
+		std::ostringstream ostr_name;
+		ostr_name << "gen_" << std::setw(6) << std::setfill('0') << trackidx << ".gpx";
+
+		t_track track;
+		track.SetFileName(ostr_name.str());
+		track.SetCreator("tracks_gen");
+		track.SetPoints(std::move(points));
+
+		return track;
+	}
+
+
+
+protected:
+	/**
+	 * seed_seq only uses the lower 32 bits of its values, so pass both halves
+	 */
+	std::seed_seq GetSeedSequence(std::uint64_t idx, std::uint64_t tag) const
+	{
+		auto lo = [](std::uint64_t val) -> std::uint32_t { return static_cast<std::uint32_t>(val); };
+		auto hi = [](std::uint64_t val) -> std::uint32_t { return static_cast<std::uint32_t>(val >> 32); };
+
+		return std::seed_seq{ lo(m_seed), hi(m_seed), lo(idx), hi(idx), lo(tag), hi(tag) };
+	}
+
+
+
+private:
+	// distance between route points [m]
+	static constexpr t_real ROUTE_STEP = 10.;
+
+	std::uint64_t m_seed{1};
+
+	t_real m_lon{11.5 / 180. * std::numbers::pi};
+	t_real m_lat{48.1 / 180. * std::numbers::pi};
+	t_real m_area_radius{5000.};
+
+	t_size m_num_points{3600};
+	t_real m_dt{1.};
+	t_real m_speed{3.};
+
+	t_real m_pos_sigma{3.};
+	t_real m_elev_sigma{1.};
+
+	t_size m_num_routes{0};
+
+	t_timept m_start_time{std::chrono::sys_days{std::chrono::year{2025} / 1 / 1}};
+	t_real m_track_interval{86400.};
+};
+
+
+#endif
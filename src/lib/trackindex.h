@@ -0,0 +1,323 @@
+/**
+ * spatial index over tracks
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 17 October 2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __TRACK_INDEX_H__
+#define __TRACK_INDEX_H__
+
+#include <vector>
+#include <tuple>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <concepts>
+#include <memory>
+
+#include <boost/asio.hpp>
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "calc.h"
+#include "memory.h"
+
+
+
+/**
+ * a track passing through a queried region
+ */
+template<class t_size = std::size_t>
+requires std::integral<t_size>
+struct TrackRegionMatch
+{
+	// index of the track
+	t_size track_idx{};
+
+	// indices of the first and last track points of each pass through the region
+	std::vector<std::pair<t_size, t_size>> passes{};
+};
+
+
+
+/**
+ * two-level r-tree: the bounding boxes of the tracks and,
+ * for each track, the bounding boxes of its segments
+ * @see https://www.boost.org/doc/libs/1_87_0/libs/geometry/doc/html/geometry/spatial_indexes.html
+ */
+template<class t_track, class t_real = double, class t_size = std::size_t>
+requires std::floating_point<t_real> && std::integral<t_size>
+class TrackIndex
+{
+public:
+	// [lon, lat] coordinates in radians
+	using t_vert = boost::geometry::model::point<t_real, 2, boost::geometry::cs::cartesian>;
+	using t_seg = boost::geometry::model::segment<t_vert>;
+	using t_box = boost::geometry::model::box<t_vert>;
+	using t_boxval = std::pair<t_box, t_size>;
+	using t_rtree = boost::geometry::index::rtree<t_boxval, boost::geometry::index::rstar<16>>;
+
+	using t_match = TrackRegionMatch<t_size>;
+
+
+
+public:
+	TrackIndex() = default;
+	~TrackIndex() = default;
+
+
+
+	/**
+	 * build the index for the given tracks, the track indices refer to this list
+	 */
+	void Build(const std::vector<const t_track*>& tracks, unsigned int num_threads = 4)
+	{
+		m_tracks = tracks;
+		m_seg_trees.clear();
+		m_seg_trees.resize(tracks.size());
+
+		std::vector<t_boxval> track_boxes;
+		track_boxes.reserve(tracks.size());
+
+		// segment trees
+		boost::asio::thread_pool tp{num_threads};
+
+		for(t_size trackidx = 0; trackidx < tracks.size(); ++trackidx)
+		{
+			const t_track *track = tracks[trackidx];
+			if(!track || track->GetPoints().size() == 0)
+				continue;
+
+			auto [ min_lat, max_lat ] = track->GetLatitudeRange();
+			auto [ min_lon, max_lon ] = track->GetLongitudeRange();
+			track_boxes.emplace_back(std::make_pair(
+				t_box{t_vert{min_lon, min_lat}, t_vert{max_lon, max_lat}},
+				trackidx));
+
+			boost::asio::post(tp, [this, track, trackidx]() -> void
+			{
+				const auto& pts = track->GetPoints();
+
+				std::vector<t_boxval> seg_boxes;
+				seg_boxes.reserve(pts.size());
+
+				// segment i connects the points i and i+1, single points are a degenerate segment
+				const t_size num_segs = pts.size() > 1 ? pts.size() - 1 : 1;
+				for(t_size segidx = 0; segidx < num_segs; ++segidx)
+				{
+					const auto& pt1 = pts[segidx];
+					const auto& pt2 = pts[std::min(segidx + 1, pts.size() - 1)];
+
+					seg_boxes.emplace_back(std::make_pair(t_box{
+						t_vert{std::min(pt1.longitude, pt2.longitude), std::min(pt1.latitude, pt2.latitude)},
+						t_vert{std::max(pt1.longitude, pt2.longitude), std::max(pt1.latitude, pt2.latitude)}},
+						segidx));
+				}
+
+				// bulk loading
+				m_seg_trees[trackidx] = std::make_unique<t_rtree>(seg_boxes.begin(), seg_boxes.end());
+			});
+		}
+
+		m_track_tree = t_rtree(track_boxes.begin(), track_boxes.end());
+		tp.join();
+	}
+
+
+
+	/**
+	 * find the tracks passing through the given longitude and latitude ranges [rad]
+	 */
+	std::vector<t_match> QueryRegion(
+		t_real min_lon, t_real max_lon,
+		t_real min_lat, t_real max_lat) const
+	{
+		namespace geo = boost::geometry;
+
+		t_box region{t_vert{min_lon, min_lat}, t_vert{max_lon, max_lat}};
+
+		return Query(region, [&region](const t_seg& seg) -> bool
+		{
+			return geo::intersects(seg, region);
+		});
+	}
+
+
+
+	/**
+	 * find the tracks passing within the given radius [m] around a point [rad]
+	 */
+	std::vector<t_match> QueryRadius(t_real lon, t_real lat, t_real radius) const
+	{
+		// local planar approximation around the given point
+		const t_real rad = earth_radius<t_real>(lat);
+		const t_real lon_scale = rad * std::cos(lat);
+		const t_real lat_scale = rad;
+
+		const t_real dlon = radius / std::max(lon_scale, std::numeric_limits<t_real>::epsilon());
+		const t_real dlat = radius / lat_scale;
+
+		t_box region{t_vert{lon - dlon, lat - dlat}, t_vert{lon + dlon, lat + dlat}};
+
+		return Query(region, [lon, lat, lon_scale, lat_scale, radius](const t_seg& seg) -> bool
+		{
+			namespace geo = boost::geometry;
+
+			// segment end points relative to the centre [m]
+			t_real x1 = (geo::get<0, 0>(seg) - lon) * lon_scale;
+			t_real y1 = (geo::get<0, 1>(seg) - lat) * lat_scale;
+			t_real x2 = (geo::get<1, 0>(seg) - lon) * lon_scale;
+			t_real y2 = (geo::get<1, 1>(seg) - lat) * lat_scale;
+
+			// closest point on the segment
+			t_real dx = x2 - x1, dy = y2 - y1;
+			t_real len2 = dx*dx + dy*dy;
+			t_real t = len2 > t_real(0) ? -(x1*dx + y1*dy) / len2 : t_real(0);
+			t = std::clamp(t, t_real(0), t_real(1));
+
+			t_real x = x1 + t*dx, y = y1 + t*dy;
+			return x*x + y*y <= radius*radius;
+		});
+	}
+
+
+
+	t_size GetTrackCount() const
+	{
+		return m_tracks.size();
+	}
+
+
+
+	/**
+	 * estimate the memory used by the index
+	 */
+	MemoryBreakdown MemoryUsage() const
+	{
+		std::size_t bytes = mem_vector(m_tracks) + mem_vector(m_seg_trees)
+			+ GetTreeMemory(m_track_tree);
+
+		for(const auto& seg_tree : m_seg_trees)
+		{
+			if(seg_tree)
+				bytes += sizeof(t_rtree) + GetTreeMemory(*seg_tree);
+		}
+
+		MemoryBreakdown mem;
+		mem.Add("spatial index", bytes);
+		return mem;
+	}
+
+
+
+protected:
+	/**
+	 * find all segments within the bounding box of the region
+	 * which fulfill the given exact test
+	 */
+	template<class t_func>
+	std::vector<t_match> Query(const t_box& region, t_func&& in_region) const
+	{
+		namespace geo = boost::geometry;
+		namespace idx = boost::geometry::index;
+
+		std::vector<t_boxval> tracks;
+		m_track_tree.query(idx::intersects(region), std::back_inserter(tracks));
+
+		std::vector<t_match> matches;
+		std::vector<t_boxval> segs;
+
+		for(const t_boxval& trackval : tracks)
+		{
+			const t_size trackidx = trackval.second;
+			const auto& seg_tree = m_seg_trees[trackidx];
+			if(!seg_tree)
+				continue;
+
+			segs.clear();
+			seg_tree->query(idx::intersects(region), std::back_inserter(segs));
+
+			const auto& pts = m_tracks[trackidx]->GetPoints();
+			std::vector<t_size> seg_indices;
+			seg_indices.reserve(segs.size());
+
+			for(const t_boxval& segval : segs)
+			{
+				const t_size segidx = segval.second;
+				const auto& pt1 = pts[segidx];
+				const auto& pt2 = pts[std::min(segidx + 1, pts.size() - 1)];
+
+				t_seg seg{t_vert{pt1.longitude, pt1.latitude}, t_vert{pt2.longitude, pt2.latitude}};
+				if(in_region(seg))
+					seg_indices.push_back(segidx);
+			}
+
+			if(!seg_indices.size())
+				continue;
+
+			// consecutive segments form a pass through the region
+			std::sort(seg_indices.begin(), seg_indices.end());
+
+			t_match match{ .track_idx = trackidx };
+			t_size first = seg_indices[0], last = seg_indices[0];
+			for(t_size i = 1; i < seg_indices.size(); ++i)
+			{
+				if(seg_indices[i] != last + 1)
+				{
+					match.passes.emplace_back(std::make_pair(first, std::min(last + 1, pts.size() - 1)));
+					first = seg_indices[i];
+				}
+				last = seg_indices[i];
+			}
+			match.passes.emplace_back(std::make_pair(first, std::min(last + 1, pts.size() - 1)));
+
+			matches.emplace_back(std::move(match));
+		}
+
+		std::sort(matches.begin(), matches.end(), [](const t_match& match1, const t_match& match2) -> bool
+		{
+			return match1.track_idx < match2.track_idx;
+		});
+
+		return matches;
+	}
+
+
+
+	/**
+	 * estimate the memory of an r-tree, assuming fully packed nodes
+	 * as they are created by the range constructor
+	 */
+	static std::size_t GetTreeMemory(const t_rtree& tree)
+	{
+		const std::size_t max_elems = t_rtree::parameters_type::max_elements;
+		const std::size_t leaf_size = (max_elems + 1) * sizeof(t_boxval) + 2*sizeof(std::size_t);
+		const std::size_t node_size = (max_elems + 1) * (sizeof(t_box) + sizeof(void*)) + 2*sizeof(std::size_t);
+
+		std::size_t nodes = (tree.size() + max_elems - 1) / max_elems;
+		std::size_t bytes = nodes * leaf_size;
+
+		while(nodes > 1)
+		{
+			nodes = (nodes + max_elems - 1) / max_elems;
+			bytes += nodes * node_size;
+		}
+
+		return bytes;
+	}
+
+
+
+private:
+	std::vector<const t_track*> m_tracks{};
+
+	// bounding boxes of the tracks
+	t_rtree m_track_tree{};
+
+	// bounding boxes of the segments of each track
+	std::vector<std::unique_ptr<t_rtree>> m_seg_trees{};
+};
+
+
+#endif